@@ -20,6 +20,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "SolverTypes.h"
 #include "Solver.h"
 #include "penelope/utils/Semaphore.h"
+#include "penelope/utils/Atomic.h"
+#include "penelope/utils/Barrier.h"
+#include "penelope/utils/EpochClock.h"
+#include "penelope/core/ReplayLog.h"
+#include "penelope/core/GuidingPaths.h"
+#include "penelope/utils/System.h"
 
 #ifndef COOPERATION_H
 #define COOPERATION_H
@@ -37,9 +43,32 @@ namespace penelope {
 
 #define INITIAL_DET_FREQUENCE 700
 
+/** Default number of propagations of an epoch of the logical deterministic mode */
+#define LOGICAL_EPOCH_PROPAGATIONS 100000
+/**
+ * The number of epochs whose ring positions are remembered. A thread is at
+ * most LOGICAL_EPOCH_SLOTS - 1 epochs ahead of the clauses its consumers read
+ */
+#define LOGICAL_EPOCH_SLOTS 4
+
 #define AIMDX  0.25
 #define AIMDY  8
 
+/** Fraction of the memory budget above which the exchange is tightened */
+#define MEMORY_PRESSURE_TIGHTEN 0.75
+/** Fraction of the memory budget above which solvers are stopped */
+#define MEMORY_PRESSURE_STOP    0.90
+
+    /**
+     * The trace attached to a sampled exported clause
+     */
+    struct ExchangeTrace {
+        /** The time of the export (see nanoTime), 0 if not traced */
+        uint64_t time;
+        /** The number of conflicts of the producer at the time of the export */
+        uint64_t conflicts;
+    };
+
     /**
      * This class manage clause sharing component between threads,i.e.,
      * It controls read and write operations in extraUnits and extraClauses
@@ -74,6 +103,15 @@ namespace penelope {
         int** headExtraClauses;
         int** tailExtraClauses;
         int*** extraClausesLBD;
+        /**
+         * The traces of the shared clauses, NULL unless the tracing is
+         * enabled (see setTraceRate)
+         */
+        ExchangeTrace*** extraClausesTrace;
+        /** One out of traceRate exported clauses is traced, 0 disables it */
+        int traceRate;
+        /** The number of clauses exported by each thread, used for sampling */
+        uint64_t* nbTraceCandidates;
 
         //---------------------------------------
 
@@ -92,8 +130,12 @@ namespace penelope {
         double aimdx, aimdy;
         /** imported clause of for and from each thread */
         int** pairwiseImportedExtraClauses;
-        /** running Minisat in deterministic mode */
-        bool deterministic_mode;
+        /**
+         * running Minisat in deterministic mode: 0 for the non deterministic
+         * mode, 1 and 2 for the barriers with a static or dynamic frequency,
+         * 3 for the logical clocks
+         */
+        int deterministic_mode;
         
         /**
          * The list of array of literals we created during the process that will
@@ -103,6 +145,132 @@ namespace penelope {
         
         /** The semaphore guarding the access of the garbage */
         Semaphore garbageGuardian;
+
+        /** The number of bytes used by the clauses stored in garbage */
+        uint64_t garbageBytes;
+
+        /**
+         * The memory budget (in bytes) of the whole portfolio. 0 means that
+         * there is no budget
+         */
+        uint64_t memoryBudget;
+
+        /** The last memory footprint (in bytes) reported by each solver */
+        uint64_t* memoryUsed;
+
+        /** The last memory breakdown reported by each solver */
+        MemoryBreakdown* memoryDetail;
+
+        /** true for the solvers that were stopped to save memory */
+        bool* stopped;
+
+        /**
+         * The semaphore guarding the choice of the solver to stop, so that
+         * two threads never stop the last running solvers at the same time
+         */
+        Semaphore stopGuardian;
+
+        /**
+         * true for the solvers the supervisor asked to stop their search, in
+         * order to restart with a new configuration
+         */
+        bool* replaced;
+
+        /** The synchronization point of the solvers in deterministic mode */
+        Barrier syncBarrier;
+
+        /** The logical clock of each solver (deterministic mode 3) */
+        EpochClock epochClock;
+
+        /** The number of propagations of an epoch (deterministic mode 3) */
+        uint64_t epochLength;
+
+        /**
+         * The epoch during which each solver finished its search, 0 while it
+         * is searching
+         */
+        int* finalEpoch;
+
+        /**
+         * The tail of the unit rings at the end of each epoch:
+         * epochTailUnits[producer][consumer][epoch % LOGICAL_EPOCH_SLOTS]
+         */
+        int*** epochTailUnits;
+
+        /** The tail of the clause rings at the end of each epoch */
+        int*** epochTailClauses;
+
+        /**
+         * The number of units exported during the current epoch, for each
+         * producer and consumer
+         */
+        int** epochExportedUnits;
+
+        /** The number of clauses exported during the current epoch */
+        int** epochExportedClauses;
+
+        /**
+         * The replay log of each thread, NULL for the threads that are
+         * neither recorded nor replayed (see setReplayLog)
+         */
+        ReplayLog** replayLogs;
+
+        /**
+         * The number of threads running a local search instead of a CDCL
+         * search (see updateLocalSearch)
+         */
+        int nbLocalSearch;
+
+        /**
+         * The best assignment published by the local search threads, as
+         * polarities (true for a false variable, see Solver::getPolarities)
+         */
+        vec<char> localSearchPhases;
+
+        /** The number of clauses falsified by localSearchPhases */
+        int localSearchUnsat;
+
+        /** Incremented each time localSearchPhases changes */
+        uint64_t localSearchVersion;
+
+        /** The version of localSearchPhases last imported by each solver */
+        uint64_t* importedPhasesVersion;
+
+        /**
+         * The polarities of a CDCL solver, where the local search threads
+         * restart from
+         */
+        vec<char> solverPhases;
+
+        /** Incremented each time solverPhases changes */
+        uint64_t solverPhasesVersion;
+
+        /**
+         * Set by a local search thread that wants new polarities: the next
+         * CDCL solver that restarts publishes its own
+         */
+        bool phasesRequested;
+
+        /**
+         * The polarities of the longest trail published by a solver (see
+         * Solver::rephase)
+         */
+        vec<char> bestTrailPhases;
+
+        /** The size of that trail, 0 until a solver publishes one */
+        int bestTrailSize;
+
+        /** The semaphore guarding the phases exchanged between the threads */
+        Semaphore phaseGuardian;
+
+        /**
+         * The number of threads dividing the search space instead of
+         * searching the whole of it (see updateDivide)
+         */
+        int nbDivide;
+
+        /** The guiding paths shared by the threads dividing the search space */
+        GuidingPaths guidingPaths;
         
         //=================================================================================================
 
@@ -163,6 +331,42 @@ namespace penelope {
          */
         void importExtraClauses(Solver* s);
 
+        /**
+         * import the extra clauses sent by one thread, up to a position of
+         * its ring
+         * @param s the importing solver
+         * @param t the thread that exported the clauses
+         * @param tail the position where the import stops
+         */
+        void importExtraClauses(Solver* s, int t, int tail);
+
+        /**
+         * store the unit extra clauses sent by one thread, up to a position
+         * of its ring
+         * @param s the importing solver
+         * @param t the thread that exported the units
+         * @param tail the position where the import stops
+         * @param lits where the units are stored
+         */
+        void importExtraUnits(Solver* s, int t, int tail, vec<Lit>& lits);
+
+        /**
+         * End the current epoch of a solver (deterministic mode 3): publish
+         * its clock, wait for the other solvers to complete the previous
+         * epoch and import what they exported until then.
+         * @param s the solver
+         * @return the answer of a solver that finished before the previous
+         *         epoch ended, l_Undef otherwise
+         */
+        lbool endEpoch(Solver* s);
+
+        /**
+         * Notify that a solver finished its search: the other solvers do not
+         * wait for it anymore, neither on the barrier nor on its clock
+         * @param t the thread of the solver
+         */
+        void finishSearch(int t);
+
         /**
          * build a clause from the learnt Extra Lit* 
          * watch it correctly, test basic cases distinguich other cases during 
@@ -170,8 +374,23 @@ namespace penelope {
          * @param s
          * @param t
          * @param lt
+         * @param trace the trace of the clause, NULL if it isn't traced
+         */
+        void addExtraClause(Solver* s, int t, Lit* lt, int lbd, const ExchangeTrace* trace);
+
+        /**
+         * Enable the tracing of the exchanged clauses. The latency of the
+         * traced clauses and what happens to them in the consumer are
+         * recorded per (producer, consumer) pair.
+         * @param rate one out of rate exported clauses will be traced. 0
+         *        disables the tracing
+         */
+        void setTraceRate(int rate);
+
+        /**
+         * Print the latency and fate histograms of the traced clauses
          */
-        void addExtraClause(Solver* s, int t, Lit* lt, int lbd);
+        void printTrace();
 
         /**
          * Enqueue the unit literals at level 0
@@ -199,12 +418,167 @@ namespace penelope {
          */
         void updateLimitExportClauses(Solver* s);
 
+        /**
+         * Update the memory footprint of a solver and apply the memory
+         * governor: when the portfolio gets close to its budget, the solver
+         * exchanges less, reduces its database sooner and, as a last resort,
+         * the weakest solver is stopped.
+         * @param s the solver reporting its memory usage
+         */
+        void updateMemoryUsage(Solver* s);
+
+        /**
+         * Store the memory breakdown of a solver, so that it can be reported
+         * by the other threads
+         * @param s the solver reporting its memory usage, from its own thread
+         */
+        void publishMemory(Solver* s);
+
+        /**
+         * Stop a solver to save memory. The last running CDCL solver is
+         * never stopped, nor any solver in deterministic mode.
+         * @param t the thread to stop
+         * @return true if the solver was stopped
+         */
+        bool stopSolver(int t);
+
+        /**
+         * Same as stopSolver, the caller holding stopGuardian
+         */
+        bool stopSolver_(int t);
+
+        /**
+         * Ask a solver to stop its search in order to restart it with a new
+         * configuration (see Supervisor). Never done in deterministic mode,
+         * nor for a stopped solver.
+         * @param t the thread of the solver
+         * @return true if the solver was asked to stop
+         */
+        bool replaceSolver(int t);
+
+        /**
+         * Notify that a solver restarted with its new configuration
+         * @param t the thread of the solver
+         */
+        void clearReplacement(int t);
+
+        /**
+         * Count the threads configured to run a local search. The local
+         * search does not take part to the synchronizations, so those
+         * threads run a CDCL search when it is not allowed. Thread 0 runs
+         * a CDCL search when every thread is configured to run a local
+         * search: it alone cannot prove the unsatisfiability.
+         * @param allowed false in the deterministic modes and in replay
+         * @return the number of threads running a local search
+         */
+        int updateLocalSearch(bool allowed);
+
+        /**
+         * Count the threads configured to divide the search space. The
+         * splits depend on the speed of the threads, so those threads search
+         * the whole space when it is not allowed.
+         * @param allowed false in the deterministic modes, in record and in
+         *        replay
+         * @return the number of threads dividing the search space
+         */
+        int updateDivide(bool allowed);
+
+        /**
+         * Exchange the phases of a CDCL solver with the local search threads,
+         * at a restart: the solver publishes its polarities if a local
+         * search thread asked for them, and takes the best assignment of the
+         * local search as its polarities if it changed since its last import
+         * @param s the solver, at level 0
+         */
+        void exchangePhases(Solver* s);
+
+        /**
+         * Publish the best assignment of a local search thread. It replaces
+         * the published one if it falsifies less clauses.
+         * @param phases the assignment, as polarities
+         * @param nbUnsat the number of clauses it falsifies
+         */
+        void publishLocalSearchPhases(const vec<char>& phases, int nbUnsat);
+
+        /**
+         * Retrieve the polarities last published by a CDCL solver, and ask
+         * for new ones
+         * @param phases where the polarities are copied
+         * @param version the version of the polarities the caller already
+         *        has, updated
+         * @return true if phases were copied, false if they are not newer
+         *         than version
+         */
+        bool fetchSolverPhases(vec<char>& phases, uint64_t& version);
+
+        /**
+         * Publish the polarities of the longest trail reached by a solver
+         * since its last rephasing, if it is longer than the published one
+         * @param s the solver
+         */
+        void publishBestTrail(Solver* s);
+
+        /**
+         * Retrieve the polarities of the longest trail published so far
+         * @param phases where the polarities are copied
+         * @return false if no trail was published
+         */
+        bool fetchBestTrail(vec<char>& phases);
+
+        /**
+         * Retrieve the memory (in bytes) used by the exchange rings and the
+         * exported clauses
+         */
+        uint64_t exchangeMemory() const;
+
+        /**
+         * Retrieve the memory (in bytes) used by the exchange rings
+         */
+        uint64_t ringsMemory() const;
+
+        /**
+         * Retrieve the memory (in bytes) used by the exported clauses kept in
+         * garbage. Can be called from any thread.
+         */
+        uint64_t garbageMemory() const;
+
+        /**
+         * Retrieve the number of solvers that are still running
+         */
+        int nbRunningSolvers() const;
+
+        /**
+         * Copy the counters of a solver and of its exchange rings. Can be
+         * called from any thread while the solvers are searching.
+         * @param t the thread of the solver
+         * @param snap where the counters will be copied
+         */
+        void snapshot(int t, SolverSnapshot& snap) const;
+
         /**
          * print statistics of each thread
          * @param id
          */
         void printStats(int& id);
 
+        /**
+         * print the time spent by each thread in the different phases of the
+         * search. Nothing is printed unless compiled with PENELOPE_PROFILE
+         */
+        void printProfile();
+
+        /**
+         * print the hardware counters of each thread that could open them,
+         * per million propagations and per phase of the search
+         */
+        void printCounters();
+
+        /**
+         * print the memory used by each solver, the exchange rings and the
+         * exported clauses, compared to the peak memory of the process
+         */
+        void printMemory();
+
         /**
          * print the final values of size clauses shared between pairwise threads
          */
@@ -254,6 +628,124 @@ namespace penelope {
             return true;
         }
 
+        /**
+         * Decide whether a clause about to be exported is traced
+         * @param s the producer of the clause
+         * @param trace the trace of the clause, its time is 0 if the clause
+         *        isn't traced
+         */
+        inline void traceExport(Solver* s, ExchangeTrace& trace) {
+            trace.time = 0;
+            trace.conflicts = 0;
+            if (traceRate > 0 && ++nbTraceCandidates[s->threadId] % traceRate == 0) {
+                trace.time = nanoTime();
+                trace.conflicts = s->conflicts;
+            }
+        }
+
+        /**
+         * Retrieve the trace of a shared clause
+         * @param t the producer
+         * @param id the consumer
+         * @param i the index of the clause in the ring
+         * @return the trace of the clause, NULL if it isn't traced
+         */
+        inline const ExchangeTrace* importTrace(int t, int id, int i) const {
+            if (extraClausesTrace == NULL || extraClausesTrace[t][id][i].time == 0)
+                return NULL;
+            return &extraClausesTrace[t][id][i];
+        }
+
+        /**
+         * Record the arrival of a traced clause
+         * @param s the consumer
+         * @param t the producer
+         * @param trace the trace of the clause
+         */
+        void traceImport(Solver* s, int t, const ExchangeTrace& trace);
+
+        /**
+         * Check whether a solver was stopped by the memory governor
+         * @param t the thread of the solver
+         * @return true if the solver t was stopped
+         */
+        inline bool isStopped(int t) const {
+            return atomicLoad(&stopped[t]);
+        }
+
+        /**
+         * @param t a thread
+         * @return true if the thread runs a local search
+         */
+        inline bool isLocalSearch(int t) const {
+            return solvers[t].localSearchWorker;
+        }
+
+        /**
+         * @param t a thread
+         * @return true if the thread divides the search space with the other
+         *         threads of the divide and conquer mode
+         */
+        inline bool isDivide(int t) const {
+            return solvers[t].divideWorker;
+        }
+
+        /**
+         * @param t a thread
+         * @return true if the solver was asked to stop its search in order
+         *         to restart with a new configuration
+         */
+        inline bool isReplaced(int t) const {
+            return atomicLoad(&replaced[t]);
+        }
+
+        /**
+         * Wait until every solver of the portfolio reached this point (the
+         * solvers that finished their search are not waited for)
+         */
+        inline void barrier() {
+            syncBarrier.wait();
+        }
+
+        /**
+         * Record the cooperation of a thread in a log, or replay it from one.
+         * The cooperation becomes the owner of the log.
+         * @param t the thread
+         * @param log the log
+         */
+        void setReplayLog(int t, ReplayLog* log);
+
+        /**
+         * @param t a thread
+         * @return the log in which the thread is recorded, NULL if it isn't
+         */
+        inline ReplayLog* recorder(int t) const {
+            return replayLogs[t] != NULL && !replayLogs[t]->isReplaying() ? replayLogs[t] : NULL;
+        }
+
+        /**
+         * @param t a thread
+         * @return the log from which the thread is replayed, NULL if it isn't
+         */
+        inline ReplayLog* replayer(int t) const {
+            return replayLogs[t] != NULL && replayLogs[t]->isReplaying() ? replayLogs[t] : NULL;
+        }
+
+        /**
+         * Check whether a producer may export one more clause or unit to a
+         * consumer. In deterministic mode 3, the exports of an epoch are
+         * bounded so that the rings never overflow: a full ring would make
+         * the exchange depend on the speed of the consumer.
+         * @param exported the number of exports of the current epoch
+         * @param ringSize the size of the ring
+         */
+        inline bool underEpochBudget(int* exported, int ringSize) {
+            if (deterministic_mode != 3) return true;
+            if (*exported >= ringSize / LOGICAL_EPOCH_SLOTS - 1) return false;
+            (*exported)++;
+            return true;
+        }
+
     };
 }
 
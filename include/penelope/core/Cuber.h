@@ -0,0 +1,189 @@
+/*
+ * File:   Cuber.h
+ * Author: bhoessen
+ *
+ * A lookahead cuber splitting the formula into cubes before the search.
+ */
+
+#ifndef CUBER_H
+#define	CUBER_H
+
+#include "penelope/core/Solver.h"
+#include "penelope/core/GuidingPaths.h"
+
+/** The number of variables looked ahead at each node of the cuber */
+#define CUBER_CANDIDATES 64
+
+namespace penelope {
+
+    /**
+     * A lookahead cuber on the original clauses of a solver, simplified at
+     * level 0. At each node of its tree, the cuber propagates both
+     * polarities of the most promising free variables: a literal whose
+     * propagation fails is refuted, and the variable splitting the node is
+     * the one whose polarities reduce the most clauses (the product of the
+     * reductions, as march does). A clause reduced to k free literals is
+     * weighted by 2^(2-k).
+     *
+     * The cubes are the leaves of the tree at a fixed depth, made of the
+     * decisions and of the literals implied by a failed literal on their
+     * path. The branches refuted by the propagation give no cube: if there
+     * is no cube at all, the formula is unsatisfiable.
+     */
+    class Cuber {
+    public:
+
+        /**
+         * Create a new cuber
+         * @param s the solver holding the clauses, at level 0
+         */
+        Cuber(Solver& s);
+
+        /**
+         * Split the formula into cubes, queued in a set of guiding paths in
+         * place of its current paths
+         * @param nbCubes the number of cubes wanted: the tree is cut at
+         *        depth ceil(log2(nbCubes))
+         * @param paths where the cubes are queued
+         * @return l_False if the formula is unsatisfiable, l_Undef otherwise
+         *         (including when the solver is interrupted)
+         */
+        lbool generate(int nbCubes, GuidingPaths& paths);
+
+        /**
+         * @return the negations of the failed literals found at the root of
+         *         the tree, which hold for the whole formula
+         */
+        const vec<Lit>& getUnits() const {
+            return units;
+        }
+
+        /** @return the number of cubes generated */
+        int nbCubes() const {
+            return cubes;
+        }
+
+        /** @return the number of branches refuted by the propagation */
+        int nbRefuted() const {
+            return refuted;
+        }
+
+        /** @return the number of failed literals found */
+        int nbFailed() const {
+            return failed;
+        }
+
+    private:
+
+        Cuber(const Cuber& other);
+        Cuber& operator=(const Cuber& other);
+
+        /**
+         * Copy the clauses of the solver that are not satisfied at level 0,
+         * without their false literals, and rank the variables by their
+         * occurrences
+         * @return false if a clause is falsified at level 0
+         */
+        bool load();
+
+        /** Assign a literal, propagated by the next call to propagate */
+        void assign(Lit l);
+
+        /**
+         * Propagate the assigned literals
+         * @return false on a conflict
+         */
+        bool propagate();
+
+        /** Undo the assignments done after a given size of the trail */
+        void undo(int size);
+
+        /**
+         * Propagate a literal and undo it
+         * @param l the literal
+         * @param score the weight of the clauses reduced by the propagation
+         * @return false if the propagation fails
+         */
+        bool lookahead(Lit l, double& score);
+
+        /**
+         * Look ahead at the current node: the failed literals are refuted,
+         * their negation being assigned and added to the cube
+         * @param cube the current cube, extended by the failed literals
+         * @param best the variable splitting the node, var_Undef if no free
+         *        variable is left
+         * @return false if the node is refuted
+         */
+        bool select(vec<Lit>& cube, Var& best);
+
+        /**
+         * Look ahead at a node of the tree, then split it or make it a cube
+         * @param cube the literals leading to the node, all propagated
+         * @param depth the number of splits left
+         */
+        void split(vec<Lit>& cube, int depth);
+
+        /**
+         * Split a node on a variable: each of its polarities leads to a
+         * child, the one reducing fewer clauses first
+         * @param cube the literals leading to the node, all propagated
+         * @param v the variable
+         * @param depth the number of splits left
+         */
+        void branch(vec<Lit>& cube, Var v, int depth);
+
+        /** Store a cube, until the tree is complete */
+        void emit(const vec<Lit>& cube);
+
+        /** @return the current value of a literal */
+        inline lbool value(Lit l) const {
+            return assigns[var(l)] ^ sign(l);
+        }
+
+        /** The solver holding the clauses */
+        Solver& solver;
+
+        /** The literals of the clauses, one clause after the other */
+        vec<Lit> lits;
+        /** The position of the first literal of each clause, plus the end */
+        vec<int> clauseStart;
+        /** The clauses where each literal occurs, one literal after the other */
+        vec<int> occurrences;
+        /** The position of the first clause of each literal, plus the end */
+        vec<int> occurrenceStart;
+        /** The variables, the ones with the most occurrences first */
+        vec<Var> order;
+
+        /** The value of each variable */
+        vec<lbool> assigns;
+        /** The propagated literals of each clause that are true */
+        vec<int> nbTrue;
+        /** The propagated literals of each clause that are false */
+        vec<int> nbFalse;
+        /** The assigned literals, in the order of their assignment */
+        vec<Lit> trail;
+        /** The position of the next literal of the trail to propagate */
+        int qhead;
+        /** The weight of the clauses reduced since it was reset */
+        double reduced;
+
+        /** The cubes generated, one after the other */
+        vec<Lit> cubeLits;
+        /** The position of the first literal of each cube */
+        vec<int> cubeStart;
+        /** true if the solver was interrupted while the tree was built */
+        bool interrupted;
+
+        /** The negations of the failed literals found at the root */
+        vec<Lit> units;
+        /** The number of cubes generated */
+        int cubes;
+        /** The number of branches refuted by the propagation */
+        int refuted;
+        /** The number of failed literals found */
+        int failed;
+    };
+
+}
+
+#endif	/* CUBER_H */
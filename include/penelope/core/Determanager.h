@@ -27,16 +27,24 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 using namespace penelope;
 
 lbool Solver::importClauses(Cooperation* coop) {
+  PROFILE_PHASE(profile, PROFILE_IMPORT);
   
   //Control the limit size clause export
   coop->updateLimitExportClauses(this);
 
+  // replay: the imports come from the log instead of the other threads
+  if(ReplayLog* log = coop->replayer(threadId)){
+    asyncStop = asynch_interrupt;
+    if(coop->answer(threadId) != l_Undef) return coop->answer(threadId);
+    if(log->replayImports(this, coop)) asyncStop = true;
+    return l_Undef;
+  }
 
   switch(deterministic_mode){
 
   case 0:   // non deterministic case
     {
-      asyncStop = asynch_interrupt;
+      asyncStop = asynch_interrupt || coop->isStopped(threadId) || coop->isReplaced(threadId);
       for(int t = 0; t < coop->nThreads(); t++)
 	if(coop->answer(t) != l_Undef)
 	  return coop->answer(t);
@@ -50,7 +58,7 @@ lbool Solver::importClauses(Cooperation* coop) {
     {
       if((int) conflicts % coop->initFreq == 0 || coop->answer(threadId) != l_Undef){						
 
-#pragma omp barrier
+        coop->barrier();
         asyncStop = asynch_interrupt;
 	for(int t = 0; t < coop->nThreads(); t++)
 	  if(coop->answer(t) != l_Undef) return coop->answer(t);
@@ -58,7 +66,7 @@ lbool Solver::importClauses(Cooperation* coop) {
 	coop->importExtraClauses(this);
 	coop->importExtraUnits(this, extraUnits);
 	
-#pragma omp barrier
+        coop->barrier();
       }
       
       break;
@@ -68,7 +76,7 @@ lbool Solver::importClauses(Cooperation* coop) {
     {
       if(((int) conflicts % coop->deterministic_freq[threadId] == 0) || (coop->answer(threadId) != l_Undef)){
         coop->learntsz[threadId] = nLearnts();
-#pragma omp barrier
+        coop->barrier();
         asyncStop = asynch_interrupt;
 	// each thread has its own frequency barrier synchronization
 	updateFrequency(coop);
@@ -81,11 +89,22 @@ lbool Solver::importClauses(Cooperation* coop) {
 	coop->importExtraClauses(this);
 	coop->importExtraUnits(this, extraUnits);
 
-#pragma omp barrier
+        coop->barrier();
       }
       
       break;
     }
+  case 3: // deterministic case with logical clocks
+    {
+      asyncStop = asynch_interrupt;
+      if(coop->answer(threadId) != l_Undef) return coop->answer(threadId);
+      // the epochs are counted in propagations, which does not depend on
+      // the speed of the thread
+      if(nextEpoch == 0) nextEpoch = coop->epochLength;
+      if(propagations < nextEpoch) break;
+      nextEpoch = propagations + coop->epochLength;
+      return coop->endEpoch(this);
+    }
       default:
           ASSERT_TRUE(false);
   }
@@ -107,6 +126,7 @@ int Solver::updateFrequency(Cooperation* coop){
 }
 
 void Solver::exportClause(Cooperation* coop, vec<Lit>& learnt_clause, int lbd) {
+  PROFILE_PHASE(profile, PROFILE_EXPORT);
   
   if(coop->limitszClauses() < 1) 
     return;
@@ -121,6 +141,7 @@ void Solver::exportClause(Cooperation* coop, vec<Lit>& learnt_clause, int lbd) {
 
 
 void Solver::exportClause(Cooperation* coop, Clause& generatedClause) {
+  PROFILE_PHASE(profile, PROFILE_EXPORT);
   
   if(coop->limitszClauses() < 1) 
     return;
@@ -194,6 +215,58 @@ CRef Solver::addExtraClause(vec<Lit>& lits, int lbd){
   return cr;
 }
 
+bool Solver::strengthenImport(vec<Lit>& lits){
+  for(int i = 0; i < lits.size(); i++)
+    if(value(lits[i]) == l_True && level(var(lits[i])) == 0)
+      return false;
+
+  // seen holds 1 (2) for the positive (negative) literals of the clause, and
+  // 4 (8) for the positive (negative) literals reached from the current one
+  for(int i = 0; i < lits.size(); i++)
+    seen[var(lits[i])] |= sign(lits[i]) ? 2 : 1;
+
+  int budget = IMPORT_STRENGTHEN_BUDGET;
+  int i, j;
+  for(i = j = 0; i < lits.size(); i++){
+    Lit l = lits[i];
+    bool redundant = false;
+    analyze_stack.clear();
+    analyze_stack.push(l);
+    seen[var(l)] |= sign(l) ? 8 : 4;
+    for(int k = 0; k < analyze_stack.size() && !redundant && budget > 0; k++){
+      vec<Watcher>& ws = watches.lookup(analyze_stack[k]);
+      for(int w = 0; w < ws.size() && budget > 0; w++){
+        budget--;
+        if(ca[ws[w].cref].size() != 2) continue;
+        // l implies m
+        Lit m = ws[w].blocker;
+        if(m == ~l || (m != l && (seen[var(m)] & (sign(m) ? 2 : 1)))){
+          redundant = true;
+          break;
+        }
+        if(seen[var(m)] & (sign(m) ? 8 : 4)) continue;
+        seen[var(m)] |= sign(m) ? 8 : 4;
+        analyze_stack.push(m);
+      }
+    }
+    for(int k = 0; k < analyze_stack.size(); k++)
+      seen[var(analyze_stack[k])] &= ~(sign(analyze_stack[k]) ? 8 : 4);
+
+    if(redundant) seen[var(l)] &= ~(sign(l) ? 2 : 1);
+    else lits[j++] = l;
+  }
+  analyze_stack.clear();
+  for(int k = 0; k < j; k++)
+    seen[var(lits[k])] = 0;
+
+  if(i > j){
+    nbImportsStrengthened++;
+    nbImportLitsRemoved += i - j;
+  }
+  lits.shrink(i - j);
+  return true;
+}
+
 void Solver::propagateExtraUnits(){
   for(int i = 0; i < extraUnits.size(); i++)
     if(value(extraUnits[i]) == l_Undef)
@@ -99,6 +99,62 @@ namespace penelope {
             }
         }
 
+        /**
+         * Parse a formula into a single target providing the interface of a
+         * solver: initialiseMem, nVars, newVar and addClause
+         */
+        template<class Target>
+        static void parse_DIMACS(FILE* input_stream, Target& target) {
+            StreamBuffer in(input_stream);
+            parse_DIMACS_main(in, target);
+        }
+
+        template<class Target>
+        static void readClause(StreamBuffer& in, Target& target, vec<Lit>& lits) {
+            int parsed_lit, var;
+            lits.clear();
+            for (;;) {
+                parsed_lit = parseInt(in);
+                if (parsed_lit == 0) break;
+                var = abs(parsed_lit) - 1;
+                while (var >= target.nVars()) target.newVar();
+                lits.push((parsed_lit > 0) ? mkLit(var) : ~mkLit(var));
+            }
+        }
+
+        template<class Target>
+        static void parse_DIMACS_main(StreamBuffer& in, Target& target) {
+            vec<Lit> lits;
+            int vars = 0;
+            int clauses = 0;
+            int cnt = 0;
+            for (;;) {
+                skipWhitespace(in);
+                if (*in == EOF) break;
+                else if (*in == 'p') {
+                    if (eagerMatch(in, "p cnf")) {
+                        vars = parseInt(in);
+                        clauses = parseInt(in);
+                        target.initialiseMem(vars, clauses);
+                    } else {
+                        printf("PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
+                    }
+                } else if (*in == 'c' || *in == 'p') {
+                    skipLine(in);
+                } else {
+                    cnt++;
+                    readClause(in, target, lits);
+                    target.addClause(lits);
+                }
+            }
+            if (vars != target.nVars()) {
+                fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of variables.\n");
+            }
+            if (cnt != clauses) {
+                fprintf(stderr, "WARNING! DIMACS header mismatch: wrong number of clauses.\n");
+            }
+        }
+
     };
 
     //=================================================================================================
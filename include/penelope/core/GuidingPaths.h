@@ -0,0 +1,168 @@
+/*
+ * File:   GuidingPaths.h
+ * Author: bhoessen
+ *
+ * The guiding paths shared by the threads dividing the search space.
+ */
+
+#ifndef GUIDINGPATHS_H
+#define	GUIDINGPATHS_H
+
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+#include "penelope/core/SolverTypes.h"
+
+/**
+ * The time (in milliseconds) an idle thread waits for a guiding path before
+ * checking whether it must stop
+ */
+#define GUIDING_PATH_WAIT 10
+
+namespace penelope {
+
+    /**
+     * The guiding paths waiting for a thread of the divide and conquer mode.
+     * A guiding path is a set of literals, solved as assumptions; the
+     * queued paths and the ones being solved cover the part of the search
+     * space that was not refuted yet. At first, the only path is the empty
+     * one, i.e., the whole search space.
+     *
+     * A busy thread splits its path when some threads are idle: it gives
+     * away its path extended with the negation of its first decision, and
+     * goes on with this decision as an extra assumption. Once every path is
+     * refuted, the formula is unsatisfiable.
+     */
+    class GuidingPaths {
+    public:
+
+        /** The outcome of take */
+        enum Status {
+            /** a path was taken */
+            PATH_TAKEN,
+            /** no path was available for now */
+            PATH_NONE,
+            /** every path was refuted */
+            PATH_EXHAUSTED
+        };
+
+        /**
+         * Create the guiding paths, the empty path being the only one
+         */
+        GuidingPaths();
+
+        /**
+         * Destructor
+         */
+        ~GuidingPaths();
+
+        /**
+         * Set the number of threads taking the paths
+         * @param nbWorkers the number of threads
+         */
+        void setWorkers(int nbWorkers);
+
+        /**
+         * Remove every queued path, even the empty one. Can only be called
+         * before the threads take any path.
+         */
+        void clear();
+
+        /**
+         * Queue a new path
+         * @param path the literals of the path
+         */
+        void push(const vec<Lit>& path);
+
+        /**
+         * Take the oldest queued path, waiting for one at most
+         * GUIDING_PATH_WAIT milliseconds. The caller becomes busy until it
+         * refutes or releases the path.
+         * @param path where the literals of the path are copied
+         */
+        Status take(vec<Lit>& path);
+
+        /**
+         * Give away a part of the path of a busy thread
+         * @param path the literals of the part given away
+         */
+        void split(const vec<Lit>& path);
+
+        /**
+         * Notify that a busy thread refuted its path. The queued paths that
+         * are refuted by the same conflict are removed.
+         * @param conflict the final conflict of the refutation: a clause
+         *        made of negated literals of the path
+         * @return the number of queued paths removed
+         */
+        int refute(const vec<Lit>& conflict);
+
+        /**
+         * Give back the path of a busy thread that stops its search before
+         * refuting it
+         * @param path the literals of the path, with the extensions done by
+         *        the splits
+         */
+        void release(const vec<Lit>& path);
+
+        /**
+         * @return true if some threads are idle while no path is queued for
+         *         them: the busy threads must split their path
+         */
+        bool wanted() const;
+
+        /** @return true if every path was refuted */
+        bool exhausted() const;
+
+        /** @return the number of queued paths */
+        int nbQueued() const;
+
+        /** @return the number of splits done so far */
+        int nbSplits() const;
+
+        /** @return the number of paths refuted so far */
+        int nbRefuted() const;
+
+        /** @return the number of queued paths removed by a refutation */
+        int nbPruned() const;
+
+    private:
+        GuidingPaths(const GuidingPaths& other);
+        GuidingPaths& operator=(const GuidingPaths& other);
+
+        /**
+         * Update missing after a change of the queue or of the number of
+         * busy threads. The mutex must be held.
+         */
+        void update();
+
+        /**
+         * Queue a path and wake up the idle threads. The mutex must be held.
+         */
+        void append(const vec<Lit>& path);
+
+        mutable pthread_mutex_t mutex;
+        /** Signaled when a path is queued or every path is refuted */
+        pthread_cond_t available;
+        /** The queued paths, the oldest first */
+        std::deque<std::vector<Lit> > paths;
+        /** The number of threads taking the paths */
+        int workers;
+        /** The number of threads solving a path */
+        int busy;
+        /** The number of idle threads for which no path is queued */
+        int missing;
+        /** true once every path was refuted */
+        bool done;
+        /** The number of splits done so far */
+        int splits;
+        /** The number of paths refuted so far */
+        int refuted;
+        /** The number of queued paths removed by a refutation */
+        int pruned;
+    };
+
+}
+
+#endif	/* GUIDINGPATHS_H */
@@ -0,0 +1,92 @@
+/*
+ * File:   LiveReport.h
+ * Author: bhoessen
+ *
+ * Statistics of the running portfolio printed on demand.
+ */
+
+#ifndef LIVEREPORT_H
+#define	LIVEREPORT_H
+
+#include <pthread.h>
+#include <signal.h>
+
+#include "penelope/core/Solver.h"
+
+namespace penelope {
+
+    class Cooperation;
+
+    /**
+     * The live report owns a reporter thread that prints the statistics of
+     * every solver each time it is asked to, either by a signal (see request)
+     * or by the creation of a control file. The counters are read through
+     * snapshots: the solvers are never paused and never do any I/O.
+     */
+    class LiveReport {
+    public:
+
+        /**
+         * Create a new live report
+         * @param coop the cooperation holding the solvers to report
+         * @param controlFile the file whose creation triggers a report (it
+         *        is then removed), NULL to only rely on request
+         */
+        LiveReport(Cooperation* coop, const char* controlFile);
+
+        /**
+         * Destructor. Stops the reporter thread if needed.
+         */
+        ~LiveReport();
+
+        /**
+         * Ask for a report. Only sets a flag, so it can be called from a
+         * signal handler.
+         */
+        static void request();
+
+        /**
+         * Start the reporter thread
+         * @return true if the thread started
+         */
+        bool start();
+
+        /**
+         * Stop the reporter thread
+         */
+        void stop();
+
+        /**
+         * Print the statistics of every solver. Called by the reporter
+         * thread.
+         */
+        void report();
+
+    private:
+
+        LiveReport(const LiveReport& other);
+        LiveReport& operator=(const LiveReport& other);
+
+        /** The body of the reporter thread */
+        static void* run(void* data);
+
+        /** Set by request, cleared by the reporter thread */
+        static volatile sig_atomic_t requested;
+
+        /** The cooperation holding the solvers */
+        Cooperation* coop;
+        /** The file whose creation triggers a report, may be NULL */
+        const char* controlFile;
+        /** The reporter thread */
+        pthread_t thread;
+        /** true while the reporter thread is running */
+        bool running;
+        /** Set to ask the reporter thread to stop */
+        volatile bool stopRequested;
+        /** The time of the start, in nanoseconds */
+        uint64_t startTime;
+    };
+
+}
+
+#endif	/* LIVEREPORT_H */
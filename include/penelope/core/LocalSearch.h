@@ -0,0 +1,173 @@
+/*
+ * File:   LocalSearch.h
+ * Author: bhoessen
+ *
+ * A stochastic local search running in a thread of the portfolio.
+ */
+
+#ifndef LOCALSEARCH_H
+#define	LOCALSEARCH_H
+
+#include <stdint.h>
+
+#include "penelope/core/Solver.h"
+
+/** The number of break values whose flip probability is tabulated */
+#define LOCAL_SEARCH_MAX_BREAK 64
+/** The number of flips between two checks of the end of the search */
+#define LOCAL_SEARCH_CHECK_FLIPS 1024
+
+namespace penelope {
+
+    class Cooperation;
+
+    /**
+     * A ProbSAT local search on the original clauses of a solver. Each flip
+     * picks a falsified clause at random, then one of its variables with a
+     * probability decreasing with its break value (the number of clauses
+     * that would become falsified), see Solver::localSearchCb.
+     *
+     * The local search exchanges phases with the CDCL solvers through the
+     * cooperation: it periodically publishes the best assignment of its
+     * current run, which the CDCL solvers take as their polarities, and
+     * restarts from the polarities of the last CDCL solver that restarted (or
+     * from a random assignment if there are no new ones). Each run is twice
+     * as long as the previous one. It neither imports nor exports clauses.
+     */
+    class LocalSearch {
+    public:
+
+        /**
+         * Create a new local search
+         * @param s the solver holding the clauses; its model is set when
+         *        the local search finds one
+         * @param coop the cooperation holding the solvers
+         */
+        LocalSearch(Solver& s, Cooperation* coop);
+
+        /**
+         * Search for a model until one is found, another thread answers or
+         * the search is interrupted
+         * @return l_True if a model was found, l_False if the clauses are
+         *         unsatisfiable at level 0, l_Undef otherwise
+         */
+        lbool solve();
+
+        /** @return the number of flips done so far */
+        uint64_t nbFlips() const {
+            return flips;
+        }
+
+        /** @return the number of restarts done so far */
+        int nbRestarts() const {
+            return restarts;
+        }
+
+        /** @return the lowest number of falsified clauses seen so far */
+        int bestUnsat() const {
+            return bestEver;
+        }
+
+    private:
+
+        LocalSearch(const LocalSearch& other);
+        LocalSearch& operator=(const LocalSearch& other);
+
+        /**
+         * Copy the clauses of the solver that are not satisfied at level 0,
+         * without their false literals
+         */
+        void load();
+
+        /**
+         * Start a new run from a given assignment
+         * @param phases the assignment, as polarities, NULL for a random one
+         */
+        void restart(const vec<char>* phases);
+
+        /** Flip the value of a variable */
+        void flip(Var v);
+
+        /**
+         * @return the number of clauses that become falsified if a variable
+         *         is flipped
+         */
+        int breakValue(Var v) const;
+
+        /** Pick the variable to flip in a falsified clause */
+        Var pickVar(int c);
+
+        /** @return true if the local search must stop */
+        bool mustStop() const;
+
+        /** @return a random number in [0,1) */
+        double random01();
+
+        /** @return true if a literal is true in the current assignment */
+        inline bool isTrue(Lit l) const {
+            return values[var(l)] != sign(l);
+        }
+
+        /** Store the best assignment of the current run in best */
+        void saveBest();
+
+        /** The solver holding the clauses */
+        Solver& solver;
+        /** The cooperation holding the solvers */
+        Cooperation* coop;
+
+        /** The literals of the clauses, one clause after the other */
+        vec<Lit> lits;
+        /** The position of the first literal of each clause, plus the end */
+        vec<int> clauseStart;
+        /** The clauses where each literal occurs, one literal after the other */
+        vec<int> occurrences;
+        /** The position of the first clause of each literal, plus the end */
+        vec<int> occurrenceStart;
+
+        /** The current value of each variable */
+        vec<char> values;
+        /** The number of true literals of each clause */
+        vec<int> nbTrue;
+        /** The falsified clauses */
+        vec<int> unsat;
+        /** The position of each falsified clause in unsat, -1 if satisfied */
+        vec<int> unsatPosition;
+
+        /** The flip probability of each break value */
+        double probabilities[LOCAL_SEARCH_MAX_BREAK];
+        /** The probabilities of the variables of a clause (temporary) */
+        vec<double> scores;
+
+        /**
+         * The variables flipped since the best assignment of the current
+         * run: undoing them gives back that assignment. Once it gets as long
+         * as the assignment itself, the best assignment is saved instead.
+         */
+        vec<Var> sinceBest;
+        /** true if best holds the best assignment of the current run */
+        bool bestSaved;
+        /** The best assignment of the current run, as polarities (see saveBest) */
+        vec<char> best;
+        /** The number of clauses falsified by best */
+        int bestRun;
+        /** The lowest number of falsified clauses seen so far */
+        int bestEver;
+        /** The version of the last polarities fetched from the CDCL solvers */
+        uint64_t phasesVersion;
+
+        /** The seed of the random generator */
+        uint64_t seed;
+        /** The number of flips done so far */
+        uint64_t flips;
+        /** The number of flips of the current run */
+        uint64_t runFlips;
+        /** The number of flips of the current run before the next restart */
+        uint64_t runLength;
+        /** The number of restarts done so far */
+        int restarts;
+    };
+
+}
+
+#endif	/* LOCALSEARCH_H */
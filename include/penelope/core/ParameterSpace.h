@@ -0,0 +1,102 @@
+/*
+ * File:   ParameterSpace.h
+ * Author: bhoessen
+ *
+ * The parameters of the solvers that may be changed to diversify the
+ * portfolio.
+ */
+
+#ifndef PARAMETERSPACE_H
+#define	PARAMETERSPACE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "penelope/utils/INIParser.h"
+
+namespace penelope {
+
+    /**
+     * The parameter space gathers, for each parameter that can be changed
+     * during the search, the values given to it in the configuration file.
+     * New configurations are derived from an existing one by drawing some of
+     * its parameters in that space. When the configuration file gives a
+     * single value to a parameter, a new one is drawn in its whole domain.
+     */
+    class ParameterSpace {
+    public:
+
+        /**
+         * Create a new parameter space
+         * @param parser the parser of the configuration file, whose
+         *        [default] and [solverN] configurations are used
+         */
+        ParameterSpace(const INIParser& parser);
+
+        /**
+         * Derive a new configuration from an existing one
+         * @param parser the parser where the new configuration is stored
+         * @param from the existing configuration
+         * @param to the name of the new configuration
+         * @param nbChanges the number of parameters that are changed
+         * @param seed the seed of the random generator, updated
+         * @return a description of the changed parameters
+         */
+        std::string mutate(INIParser& parser, const std::string& from, const std::string& to,
+                int nbChanges, uint64_t& seed) const;
+
+        /**
+         * Generate a new configuration. The configurations generated with
+         * the same seed are spread over the whole space: the i-th one is
+         * the i-th point of a Halton sequence (one prime base per
+         * parameter) whose digits are scrambled by permutations drawn
+         * from the seed. The parameters set in the [default] configuration
+         * are not generated, they keep their value.
+         * @param parser the parser where the new configuration is stored
+         * @param to the name of the new configuration
+         * @param index the index of the configuration in the sequence
+         * @param seed the seed of the sequence
+         * @return a description of the parameters of the configuration
+         */
+        std::string generate(INIParser& parser, const std::string& to, int index, uint64_t seed) const;
+
+        /**
+         * Draw a random number
+         * @param seed the seed of the generator, updated
+         * @return a number in [0, 2^64)
+         */
+        static uint64_t random(uint64_t& seed);
+
+    private:
+
+        /**
+         * Retrieve the value of a parameter in a configuration, the one of
+         * the default configuration if it isn't set
+         */
+        static const std::string& valueOf(const INIParser& parser, const std::string& conf,
+                const std::string& attribute);
+
+        /**
+         * Draw a new value for a parameter
+         * @param p the index of the parameter
+         * @param current its current value
+         * @param seed the seed of the random generator
+         * @return the new value, different from current if possible
+         */
+        std::string draw(int p, const std::string& current, uint64_t& seed) const;
+
+        /**
+         * Retrieve the value of a parameter at a given position of its domain
+         * @param p the index of the parameter
+         * @param u the position, in [0,1)
+         */
+        static std::string valueAt(int p, double u);
+
+        /** The values found in the configuration file, for each parameter */
+        std::vector<std::vector<std::string> > values;
+    };
+
+}
+
+#endif	/* PARAMETERSPACE_H */
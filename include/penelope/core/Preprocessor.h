@@ -0,0 +1,316 @@
+/*
+ * File:   Preprocessor.h
+ * Author: bhoessen
+ *
+ * A SatELite-like preprocessing of the formula, before it is given to the
+ * solvers of the portfolio.
+ */
+
+#ifndef PREPROCESSOR_H
+#define	PREPROCESSOR_H
+
+#include "penelope/core/Solver.h"
+#include "penelope/utils/Executor.h"
+#include "penelope/utils/Heap.h"
+#include "penelope/utils/Queue.h"
+
+/** The clauses longer than this are not checked for subsumption */
+#define PREPROCESSOR_SUBSUMPTION_LIMIT 1000
+/** A variable is not eliminated if one of its resolvents is longer */
+#define PREPROCESSOR_RESOLVENT_LIMIT 20
+/**
+ * The number of clauses from which the first subsumption pass is shared by
+ * the threads of an executor
+ */
+#define PREPROCESSOR_PARALLEL_CLAUSES 100000
+
+namespace penelope {
+
+    /**
+     * The preprocessing of SatELite, run once on the parsed formula: the
+     * units are propagated, the clauses subsumed by another one are removed,
+     * the ones that can be shortened by self-subsuming resolution are
+     * strengthened, and the variables whose elimination by resolution does
+     * not increase the number of clauses are eliminated.
+     *
+     * The clauses removed by an elimination are kept to extend the models of
+     * the simplified formula to the eliminated variables. The preprocessor
+     * can be filled by the DIMACS parser like a solver.
+     */
+    class Preprocessor {
+    public:
+
+        /**
+         * Create an empty preprocessor
+         */
+        Preprocessor();
+
+        /**
+         * Reserve the memory needed by a formula
+         * @param nbVar the number of variables
+         * @param nbClauses the number of clauses
+         */
+        void initialiseMem(int nbVar, int nbClauses);
+
+        /** Create a new variable */
+        Var newVar();
+
+        /**
+         * Add a clause of the original formula
+         * @param ps the literals of the clause
+         * @return false if the formula is unsatisfiable
+         */
+        bool addClause(const vec<Lit>& ps);
+
+        /**
+         * Simplify the formula
+         * @param executor if not NULL, its workers share the first
+         *        subsumption pass of the large formulas
+         * @return false if the formula is unsatisfiable
+         */
+        bool preprocess(Executor* executor = NULL);
+
+        /**
+         * Keep the variables of the XOR constraints encoded by the clauses
+         * from being eliminated, so that the solvers can recover the
+         * constraints. Called before preprocess.
+         * @return the number of variables kept
+         */
+        int freezeXors();
+
+        /**
+         * Give the simplified formula to a solver: the eliminated variables
+         * are not decision variables of the solver
+         * @param s a solver without any variable
+         */
+        void load(Solver& s) const;
+
+        /**
+         * Give a value to the eliminated variables of a model of the
+         * simplified formula, so that it satisfies the original one
+         * @param model the model, extended in place
+         */
+        void extendModel(vec<lbool>& model) const;
+
+        /** Free the clauses of the simplified formula, once it was loaded */
+        void release();
+
+        /** @return false if the formula is unsatisfiable */
+        bool okay() const {
+            return ok;
+        }
+
+        /** @return the number of variables */
+        int nVars() const {
+            return assigns.size();
+        }
+
+        /** @return the number of clauses of the simplified formula */
+        int nClauses() const {
+            return remaining;
+        }
+
+        /** @return true if a variable was eliminated */
+        bool isEliminated(Var v) const {
+            return eliminated[v];
+        }
+
+        /** @return the number of eliminated variables */
+        int nbEliminated() const {
+            return eliminatedVars;
+        }
+
+        /** @return the number of clauses removed because they were subsumed */
+        int nbSubsumed() const {
+            return subsumed;
+        }
+
+        /** @return the number of literals removed by self-subsuming resolution */
+        int nbStrengthened() const {
+            return strengthened;
+        }
+
+        /** @return the number of variables fixed by the propagation */
+        int nbFixed() const {
+            return trail.size();
+        }
+
+        /**
+         * The number of clauses from which the first subsumption pass is
+         * shared by the workers of the executor
+         */
+        int parallelClauses;
+
+    private:
+        Preprocessor(const Preprocessor& other);
+        Preprocessor& operator=(const Preprocessor& other);
+
+        /** Order the variables by the cost of their elimination */
+        struct ElimLt {
+            const vec<int>& nbOccurrences;
+
+            ElimLt(const vec<int>& n) : nbOccurrences(n) {
+            }
+
+            uint64_t cost(Var x) const {
+                return (uint64_t) nbOccurrences[toInt(mkLit(x))] * (uint64_t) nbOccurrences[toInt(~mkLit(x))];
+            }
+
+            bool operator()(Var x, Var y) const {
+                return cost(x) < cost(y);
+            }
+        };
+
+        /** Identify the clauses removed from the occurrence lists */
+        struct ClauseDeleted {
+            const ClauseAllocator& ca;
+
+            ClauseDeleted(const ClauseAllocator& c) : ca(c) {
+            }
+
+            bool operator()(const CRef& cr) const {
+                return ca[cr].mark() == 1;
+            }
+        };
+
+        /** The workers of the first subsumption pass */
+        friend class SubsumptionTask;
+
+        /** @return the current value of a literal */
+        inline lbool value(Lit l) const {
+            return assigns[var(l)] ^ sign(l);
+        }
+
+        /**
+         * Add a clause to the formula, without any false or duplicated
+         * literal
+         * @return false if the formula is unsatisfiable
+         */
+        bool addClause_(vec<Lit>& ps);
+
+        /**
+         * Assign a literal, the clauses where it occurs being simplified by
+         * the next call to propagate
+         * @return false if the literal is already false
+         */
+        bool enqueue(Lit l);
+
+        /**
+         * Remove the satisfied clauses and the false literals of the
+         * assigned literals
+         * @return false on a conflict
+         */
+        bool propagate();
+
+        /** Remove a clause from the formula */
+        void removeClause(CRef cr);
+
+        /**
+         * Remove a literal from a clause
+         * @return false on a conflict
+         */
+        bool strengthenClause(CRef cr, Lit l);
+
+        /** Update the position of a variable in the elimination order */
+        void updateElimHeap(Var v);
+
+        /** Queue the clauses of the variables touched since the last call */
+        void gatherTouchedClauses();
+
+        /**
+         * Remove the clauses subsumed by the queued ones, and strengthen the
+         * clauses that can be by self-subsuming resolution
+         * @return false on a conflict
+         */
+        bool backwardSubsumptionCheck();
+
+        /**
+         * Check the queued clauses against the formula on the workers of an
+         * executor, then apply what they found in the order of the queue
+         * @return false on a conflict
+         */
+        bool parallelSubsumptionCheck(Executor& executor);
+
+        /**
+         * Apply the relation between two clauses found by subsumes, if they
+         * are still related
+         * @return false on a conflict
+         */
+        bool subsume(CRef cr, CRef other);
+
+        /**
+         * Compute the resolvent of two clauses on a variable
+         * @param size the size of the resolvent
+         * @return false if the resolvent is a tautology
+         */
+        bool merge(const Clause& ps, const Clause& qs, Var v, int& size) const;
+
+        /**
+         * Compute the resolvent of two clauses on a variable
+         * @param out where the resolvent is stored
+         * @return false if the resolvent is a tautology
+         */
+        bool merge(const Clause& ps, const Clause& qs, Var v, vec<Lit>& out) const;
+
+        /**
+         * Eliminate a variable if its resolvents are not more numerous than
+         * its clauses
+         * @return false on a conflict
+         */
+        bool eliminateVar(Var v);
+
+        /** Store a clause removed by the elimination of a variable */
+        void mkElimClause(Var v, const Clause& c);
+
+        /** Store the unit clause that gives its value to a variable */
+        void mkElimClause(Lit x);
+
+        /** false once the formula is known unsatisfiable */
+        bool ok;
+        ClauseAllocator ca;
+        /** The clauses of the formula, including the removed ones */
+        vec<CRef> clauses;
+        /** The number of clauses that were not removed */
+        int remaining;
+        /** The clauses where each variable occurs */
+        OccLists<Var, CRef, ClauseDeleted> occurs;
+        /** The number of clauses where each literal occurs */
+        vec<int> nbOccurrences;
+        /** The variables, the cheapest to eliminate first */
+        Heap<ElimLt> elimHeap;
+        /** The clauses to check for subsumption */
+        Queue<CRef> subsumptionQueue;
+        /** The variables whose clauses changed */
+        vec<char> touched;
+        /** The number of touched variables */
+        int nbTouched;
+        /** The value of each variable */
+        vec<lbool> assigns;
+        /** The assigned literals, in the order of their assignment */
+        vec<Lit> trail;
+        /** The position of the next literal of the trail to propagate */
+        int qhead;
+        /** true for the eliminated variables */
+        vec<char> eliminated;
+        /** true for the variables that cannot be eliminated */
+        vec<char> frozen;
+        /**
+         * The clauses removed by the eliminations, one after the other: the
+         * literal of the eliminated variable comes first and the size of
+         * the clause last
+         */
+        vec<uint32_t> elimclauses;
+        /** A copy of the clause being added */
+        vec<Lit> addTmp;
+
+        /** The number of eliminated variables */
+        int eliminatedVars;
+        /** The number of clauses removed because they were subsumed */
+        int subsumed;
+        /** The number of literals removed by self-subsuming resolution */
+        int strengthened;
+    };
+
+}
+
+#endif	/* PREPROCESSOR_H */
@@ -0,0 +1,117 @@
+/*
+ * File:   Prober.h
+ * Author: bhoessen
+ *
+ * The failed literal probing and the equivalent literal substitution done
+ * by the threads of the portfolio before the search.
+ */
+
+#ifndef PROBER_H
+#define	PROBER_H
+
+#include "penelope/core/Cooperation.h"
+#include "penelope/utils/Executor.h"
+
+/** The number of propagations each thread can spend on the probing */
+#define PROBE_BUDGET 2000000
+
+namespace penelope {
+
+    /**
+     * A probing pass over the formula loaded in the solvers of a
+     * cooperation. Each worker of an executor probes both polarities of its
+     * own share of the variables on its solver, at level 0: a literal whose
+     * propagation fails is a failed literal, and a literal implied by both
+     * polarities of a variable holds as well. The literals implied through
+     * clauses of more than two literals complete the binary implication
+     * graph of the formula, whose strongly connected components are made of
+     * equivalent literals.
+     *
+     * The units found are then added to every solver, and every variable is
+     * replaced by the representative of its component (the literal of the
+     * smallest variable), each worker simplifying its own solver.
+     */
+    class Prober {
+    public:
+
+        /**
+         * Create a prober
+         * @param c the cooperation holding the solvers, at level 0
+         */
+        Prober(Cooperation& c);
+
+        /**
+         * Probe the variables, then simplify the formula of every solver
+         * @param executor the workers probing the variables, one for each
+         *        solver of the cooperation
+         * @return false if the formula is unsatisfiable
+         */
+        bool probe(Executor& executor);
+
+        /**
+         * Give a value to the replaced variables of a model of the
+         * simplified formula
+         * @param model the model, extended in place
+         */
+        void extendModel(vec<lbool>& model) const;
+
+        /** @return the number of failed literals found */
+        int nbFailed() const {
+            return failed;
+        }
+
+        /** @return the number of literals implied by both polarities */
+        int nbImplied() const {
+            return implied;
+        }
+
+        /** @return the number of variables replaced by an equivalent literal */
+        int nbEquivalent() const {
+            return equivalent;
+        }
+
+    private:
+        Prober(const Prober& other);
+        Prober& operator=(const Prober& other);
+
+        /** The workers of the probing */
+        friend class ProbeTask;
+        /** The workers of the substitution */
+        friend class SubstituteTask;
+
+        /** Probe the share of the variables of a worker on its solver */
+        void probeShare(int worker, int nbWorkers);
+
+        /**
+         * Compute the strongly connected components of the implication graph
+         * and their representative
+         * @return false if a literal is equivalent to its negation
+         */
+        bool findEquivalences();
+
+        /** The cooperation holding the solvers */
+        Cooperation& coop;
+
+        /** The negations of the failed literals found by each worker */
+        vec<vec<Lit> > failures;
+        /** The literals implied by both polarities found by each worker */
+        vec<vec<Lit> > commons;
+        /**
+         * The implications found by each worker, two literals each: the
+         * first one implies the second one
+         */
+        vec<vec<Lit> > implications;
+        /** The literal equivalent to the positive literal of each variable */
+        vec<Lit> representative;
+
+        /** The number of failed literals found */
+        int failed;
+        /** The number of literals implied by both polarities */
+        int implied;
+        /** The number of variables replaced by an equivalent literal */
+        int equivalent;
+    };
+
+}
+
+#endif	/* PROBER_H */
@@ -0,0 +1,227 @@
+/*
+ * File:   ReplayLog.h
+ * Author: bhoessen
+ *
+ * Record of the cooperation of one solver thread and its replay.
+ */
+
+#ifndef REPLAYLOG_H
+#define	REPLAYLOG_H
+
+#include <stdio.h>
+
+#include "penelope/core/SolverTypes.h"
+#include "penelope/utils/Vec.h"
+
+namespace penelope {
+
+    class Solver;
+    class Cooperation;
+
+    /**
+     * The replay log of a solver thread contains everything the thread
+     * received from the others, in the order it received it:
+     * - S conflicts propagations: a synchronization point (a barrier, the end
+     *   of an epoch or, in the non deterministic mode, an import that brought
+     *   something). It is followed by the imports done at that point
+     * - C producer lbd size lit... : an imported clause
+     * - U producer lit : an imported unit clause
+     * - P conflicts propagations level : the memory pressure was applied,
+     *   or released for the level 0
+     * - R conflicts decisions propagations : a restart
+     * - E conflicts propagations : the end of the search
+     * The literals are written as in the DIMACS format.
+     *
+     * Since the search of a solver only depends on its configuration and on
+     * what it imports, feeding the same imports at the same points to a
+     * single solver reproduces exactly what the thread did in the portfolio.
+     * The restarts and the synchronization points are checked while
+     * replaying: any difference is reported as a divergence.
+     */
+    class ReplayLog {
+    public:
+
+        /**
+         * Create a new log, neither recording nor replaying
+         */
+        ReplayLog();
+
+        /**
+         * Destructor. Closes the file of the log.
+         */
+        ~ReplayLog();
+
+        /**
+         * Start to record the cooperation of a thread
+         * @param fileName the file of the log
+         * @param thread the thread that will be recorded
+         * @param nbThreads the number of threads of the portfolio
+         * @param mode the deterministic mode of the portfolio
+         * @return true if the file could be created
+         */
+        bool record(const char* fileName, int thread, int nbThreads, int mode);
+
+        /**
+         * Open a log in order to replay it
+         * @param fileName the file of the log
+         * @return true if the file could be read and starts with a valid
+         *         header
+         */
+        bool replay(const char* fileName);
+
+        /** @return true if the log is replayed, false if it is recorded */
+        bool isReplaying() const {
+            return replaying;
+        }
+
+        /** @return the recorded thread */
+        int thread() const {
+            return recordedThread;
+        }
+
+        /** @return the number of threads of the recorded portfolio */
+        int nbThreads() const {
+            return recordedThreads;
+        }
+
+        /** @return the deterministic mode of the recorded portfolio */
+        int mode() const {
+            return recordedMode;
+        }
+
+        /** @return the number of divergences found while replaying */
+        int nbDivergences() const {
+            return divergences;
+        }
+
+        //---------------------------------------
+        // Recording
+
+        /**
+         * Record a synchronization point. In the non deterministic mode, it is
+         * only written if something is imported afterwards.
+         * @param s the recorded solver
+         * @param force true to write it even if nothing is imported
+         */
+        void checkpoint(const Solver* s, bool force);
+
+        /**
+         * Record an imported clause
+         * @param producer the thread that exported it
+         * @param lits the clause, its size being stored in the first element
+         * @param lbd the lbd of the clause
+         */
+        void importedClause(int producer, const Lit* lits, int lbd);
+
+        /**
+         * Record an imported unit clause
+         * @param producer the thread that exported it
+         * @param l the literal
+         */
+        void importedUnit(int producer, Lit l);
+
+        /**
+         * Record that the memory pressure was applied to the solver, or
+         * released
+         * @param s the recorded solver
+         * @param level the level of the memory pressure
+         */
+        void pressure(const Solver* s, int level);
+
+        /**
+         * Record a restart
+         * @param s the recorded solver
+         */
+        void restart(const Solver* s);
+
+        /**
+         * Record the end of the search
+         * @param s the recorded solver
+         */
+        void end(const Solver* s);
+
+        //---------------------------------------
+        // Replaying
+
+        /**
+         * Import what the recorded thread imported at this point of the
+         * search
+         * @param s the replaying solver
+         * @param coop the cooperation of the solver
+         * @return true if the recorded thread stopped its search at this
+         *         point
+         */
+        bool replayImports(Solver* s, Cooperation* coop);
+
+        /**
+         * Check the memory pressure recorded at this point of the search
+         * @param s the replaying solver
+         * @return the level of the pressure to apply, 0 if it was released,
+         *         -1 if nothing was recorded at this point
+         */
+        int replayPressure(const Solver* s);
+
+        /**
+         * Check a restart of the replaying solver against the record
+         * @param s the replaying solver
+         */
+        void replayRestart(const Solver* s);
+
+    private:
+
+        ReplayLog(const ReplayLog& other);
+        ReplayLog& operator=(const ReplayLog& other);
+
+        /**
+         * Read the next event of the log
+         * @return false at the end of the file
+         */
+        bool readEvent();
+
+        /**
+         * Compare the position of the next event with the one of the solver
+         * @return <0 if the event is before the solver, 0 if they are at the
+         *         same point and >0 if the event is after the solver
+         */
+        int compareEvent(const Solver* s) const;
+
+        /**
+         * Report a divergence between the record and the replay
+         * @param s the replaying solver
+         * @param what what diverged
+         */
+        void diverge(const Solver* s, const char* what);
+
+        /** Write the pending synchronization point, if any */
+        void flushCheckpoint();
+
+        /** The file of the log */
+        FILE* file;
+        /** true when replaying, false when recording */
+        bool replaying;
+        /** The header of the log */
+        int recordedThread;
+        int recordedThreads;
+        int recordedMode;
+        /** The number of divergences found while replaying */
+        int divergences;
+
+        /** The synchronization point not written yet (while recording) */
+        bool pendingCheckpoint;
+        uint64_t pendingConflicts;
+        uint64_t pendingPropagations;
+
+        /** The next event (while replaying), 0 at the end of the log */
+        char nextType;
+        uint64_t nextConflicts;
+        uint64_t nextPropagations;
+        uint64_t nextDecisions;
+        int nextProducer;
+        int nextLbd;
+        /** The clause of the next event, its size in the first element */
+        vec<Lit> nextLits;
+    };
+
+}
+
+#endif	/* REPLAYLOG_H */
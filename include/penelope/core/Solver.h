@@ -26,6 +26,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "penelope/utils/Alg.h"
 #include "penelope/utils/Options.h"
 #include "penelope/utils/INIParser.h"
+#include "penelope/utils/Profiler.h"
+#include "penelope/utils/PerfCounters.h"
+#include "penelope/utils/Atomic.h"
 #include "SolverTypes.h"
 #include "BoundedQueue.h"
 
@@ -40,6 +43,23 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 /** The limit in number of conflict before the first call to reduceDB */
 #define INIT_LIMIT 500
 
+/** The learnt clauses whose lbd is at most this value are vivified */
+#define VIVIFY_LBD 6
+
+/**
+ * The number of watchers an imported clause can visit while being
+ * strengthened
+ */
+#define IMPORT_STRENGTHEN_BUDGET 1000
+
+/**
+ * The learnt clauses that are not longer than this and whose lbd is not
+ * higher than MINIMIZE_BINARY_LBD are minimized with the binary clauses
+ */
+#define MINIMIZE_BINARY_SIZE 30
+/** See MINIMIZE_BINARY_SIZE */
+#define MINIMIZE_BINARY_LBD 6
+
 
 
 namespace penelope {
@@ -48,9 +68,93 @@ namespace penelope {
     // Solver -- the main class:
 
     class Cooperation;
+    class XorEngine;
 
     enum FirstPhaseInit { allTrue, allFalse, randomize};
 
+    /**
+     * What happened to a traced imported clause. A clause gets at most one
+     * of the fates from TRACE_UNIT to TRACE_DELETED_UNUSED, the clauses
+     * still waiting to be used having none. TRACE_FROZEN is not a fate: a
+     * clause can be frozen several times before it gets one.
+     */
+    enum TraceFate {
+        /** the clause was received */
+        TRACE_IMPORTED = 0,
+        /** the clause became a unit (or empty) clause at level 0 */
+        TRACE_UNIT,
+        /** the clause was not kept at import */
+        TRACE_REJECTED,
+        /** the clause was used in propagation */
+        TRACE_USED,
+        /** the clause was deleted without ever being attached */
+        TRACE_NEVER_ATTACHED,
+        /** the clause was deleted while attached once, without being used */
+        TRACE_DELETED_UNUSED,
+        /** the clause was frozen (detached) */
+        TRACE_FROZEN,
+        TRACE_NB_FATES
+    };
+
+    /**
+     * The number of buckets of the latency histograms. Bucket b counts the
+     * clauses that took less than 2^b microseconds to travel, the last one
+     * counts the others.
+     */
+#define TRACE_LATENCY_BUCKETS 24
+
+    /**
+     * The memory (in bytes) used by the different parts of a solver
+     */
+    struct MemoryBreakdown {
+        /** The clauses of the arena that are still alive */
+        uint64_t arenaLive;
+        /** The clauses of the arena that were freed but not collected yet */
+        uint64_t arenaWasted;
+        /** The watch lists */
+        uint64_t watches;
+        /** The references of the original and learnt clauses */
+        uint64_t clauseLists;
+        /** The trail and the limits of its decision levels */
+        uint64_t trail;
+        /** The data kept for each variable (value, reason, activity, ...) */
+        uint64_t varData;
+
+        /** Retrieve the total number of bytes */
+        inline uint64_t total() const {
+            return arenaLive + arenaWasted + watches + clauseLists + trail + varData;
+        }
+    };
+
+    /**
+     * A copy of the counters of a solver, taken by another thread without
+     * stopping it. The counters are read independently from each other.
+     */
+    struct SolverSnapshot {
+        uint64_t conflicts;
+        uint64_t propagations;
+        uint64_t decisions;
+        uint64_t restarts;
+        /** The number of learnt clauses in the database */
+        int learnts;
+        /** The number of exported clauses */
+        int64_t exported;
+        /** The average LBD of the learnt clauses */
+        double lbdAverage;
+        /** The number of imported units */
+        int importedUnits;
+        /** The number of imported clauses */
+        int importedClauses;
+        /** The number of units waiting in the rings of this solver */
+        int pendingUnits;
+        /** The number of clauses waiting in the rings of this solver */
+        int pendingClauses;
+        /** The last memory usage reported by this solver */
+        MemoryBreakdown memory;
+        /** The last estimation of the progress of the search, in [0,1] */
+        double progress;
+    };
+
     class Solver {
     public:
 
@@ -74,6 +178,30 @@ namespace penelope {
          */
         void initialize(Cooperation* coop, int t, const INIParser& parser);
 
+        /**
+         * Set the parameters of the solver
+         * @param conf the configuration holding the parameters (the missing
+         *        ones are taken from the default configuration)
+         * @param parser the parser of the configuration file
+         */
+        void configure(const std::string& conf, const INIParser& parser);
+
+        /**
+         * Restart the search with another configuration. The learnt clauses
+         * are removed, except the ones whose lbd is at most keptLBD, and the
+         * activities and the phases are reset. The units found so far are
+         * kept.
+         * @param conf the new configuration
+         * @param parser the parser of the configuration file
+         * @param keptLBD the maximal lbd of the learnt clauses that are kept
+         */
+        void reconfigure(const std::string& conf, const INIParser& parser, int keptLBD);
+
+        /** @return the name of the configuration of the solver */
+        const std::string& getConfiguration() const {
+            return configuration;
+        }
+
         // Problem specification:
         //
 
@@ -131,6 +259,42 @@ namespace penelope {
          */
         bool simplify(Cooperation* coop);
 
+        /**
+         * Propagate a literal at level 1, then go back to level 0 without
+         * changing the polarities
+         * @param p the literal
+         * @param implied where the literals implied by p are stored
+         * @param indirect where the literals implied by p through a clause of
+         *        more than two literals are stored
+         * @return false if the propagation of p fails
+         */
+        bool probe(Lit p, vec<Lit>& implied, vec<Lit>& indirect);
+
+        /**
+         * Replace each variable of the original clauses by the literal it is
+         * equivalent to, before the search. The replaced variables are not
+         * decision variables anymore.
+         * @param representative the literal equivalent to the positive
+         *        literal of each variable, the literal itself if it is not
+         *        replaced
+         * @return false if the formula becomes unsatisfiable
+         */
+        bool substitute(const vec<Lit>& representative);
+
+        /**
+         * Vivify the learnt clauses with a small lbd or used since the last
+         * reduction, the smallest lbd first, within vivifyBudget
+         * propagations: the negation of the literals of a clause is
+         * propagated one literal after the other, without the clause. The
+         * clause is shortened to the literals propagated so far when this
+         * leads to a conflict or makes its next literal true, and the false
+         * literals are removed. The clauses whose lbd falls to
+         * maxLBDExchanged are exported. Called at level 0.
+         * @param coop the cooperation where the clauses are exported
+         * @return false if the formula becomes unsatisfiable
+         */
+        bool vivify(Cooperation* coop);
+
         /**
          * Search for a model that respects a given set of assumptions.
          */
@@ -142,6 +306,16 @@ namespace penelope {
          */
         lbool solveLimited(const vec<Lit>& assumps, Cooperation* coop);
 
+        /**
+         * Solve the guiding paths of the cooperation (see GuidingPaths) one
+         * after the other, keeping the learnt clauses, until a model is
+         * found, every path is refuted or the search is stopped. The final
+         * conflict of each refuted path is shared with the other threads.
+         * @return l_True if a model was found, l_False if the formula is
+         *         unsatisfiable, l_Undef otherwise
+         */
+        lbool solveGuidingPaths(Cooperation* coop);
+
         /**
          * Search without assumptions.
          */
@@ -225,6 +399,14 @@ namespace penelope {
          */
         void getProvenLiterals(vec<Lit>& provenLits) const;
         
+        /**
+         * Retrieve the n-th original clause
+         * @return the n-th original clause
+         */
+        CRef getOriginalClause(int n) const{
+            return clauses[n];
+        }
+
         /**
          * Retrieve the n-th learnt clause
          * @return the n-th learnt clause
@@ -270,6 +452,40 @@ namespace penelope {
          * imported from each thread
          */
         uint64_t* nbClauseImported;
+        /**
+         * The fates of the traced clauses, according to the thread that
+         * generated them: traceFates[g * TRACE_NB_FATES + fate]
+         */
+        uint64_t* traceFates;
+        /**
+         * The latency histograms of the traced clauses, according to the
+         * thread that generated them: traceLatency[g * TRACE_LATENCY_BUCKETS + b]
+         */
+        uint64_t* traceLatency;
+        /**
+         * The sum, for the traced clauses, of the number of conflicts made by
+         * the generator while the clause was travelling
+         */
+        uint64_t* traceConflictLag;
+
+        /**
+         * Record an event for a traced clause
+         * @param g the thread that generated the clause
+         * @param fate what happened to the clause
+         */
+        inline void traceFate(int g, TraceFate fate){
+            traceFates[g * TRACE_NB_FATES + fate]++;
+        }
+
+        /**
+         * Record the fate of a traced clause, which is not traced any more
+         * @param c the clause
+         * @param fate what happened to the clause
+         */
+        inline void traceFate(Clause& c, TraceFate fate){
+            traceFate(c.getGenerator(), fate);
+            c.setTraced(false);
+        }
 
         // Mode of operation:
         //
@@ -325,6 +541,11 @@ namespace penelope {
         /** first interpretation variables are chosen randomly */
         bool firstInterpretation;
         int deterministic_mode;
+        /**
+         * The number of propagations at which the current epoch ends
+         * (deterministic mode 3), 0 before the first epoch
+         */
+        uint64_t nextEpoch;
         vec<Lit> importedUnits;
         // Statistics: (read-only member variable)
         //
@@ -339,6 +560,17 @@ namespace penelope {
          * @return
          */
         CRef addExtraClause(vec<Lit>& lits, int lbd);
+
+        /**
+         * Strengthen a clause received from another thread against the
+         * formula of this solver, whatever the current decision level: a
+         * literal is removed when it implies another literal of the clause
+         * (or its own negation) through the binary clauses, within
+         * IMPORT_STRENGTHEN_BUDGET binary clauses visited
+         * @param lits the literals of the clause, shortened in place
+         * @return false if the clause is satisfied at level 0, and useless
+         */
+        bool strengthenImport(vec<Lit>& lits);
         /** Enqueue a literal. Assumes value of literal is undefined. */
         void uncheckedEnqueue(Lit p, CRef from = CRef_Undef);
         int tailUnitLit;
@@ -365,6 +597,22 @@ namespace penelope {
          */
         void analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, unsigned int &lbd);
 
+        /**
+         * Compute the number of different decision levels of a set of
+         * literals
+         * @param lits the literals
+         * @return the lbd of lits
+         */
+        unsigned int computeLBD(const vec<Lit>& lits);
+
+        /**
+         * Remove from a learnt clause the literals whose negation is implied
+         * by the asserting literal through a binary clause
+         * @param out_learnt the clause, the asserting literal first
+         * @return true if a literal was removed
+         */
+        bool binaryMinimize(vec<Lit>& out_learnt);
+
         /**
          * Retrieve for a given variable the level of the variable. If the
          * variable isn't assigned, the result is unknown
@@ -380,7 +628,9 @@ namespace penelope {
         int decisionLevel() const;
 
         /**
-         * Perform unit propagation. Returns possibly conflicting clause.
+         * Perform unit propagation, on the clauses then on the XOR
+         * constraints, until no literal is implied. Returns possibly
+         * conflicting clause.
          * @return
          */
         CRef propagate(Cooperation* coop = NULL);
@@ -393,6 +643,38 @@ namespace penelope {
             return nbExportedClauses;
         }
 
+        /**
+         * Retrieve the time spent by this thread in each phase of the search.
+         * Empty unless compiled with PENELOPE_PROFILE
+         */
+        const PhaseProfile& getProfile() const{
+            return profile;
+        }
+
+        /**
+         * Open the hardware counters of this solver. Must be called by the
+         * thread that will run the search.
+         * @return true if at least one counter could be opened
+         */
+        bool openCounters(){
+            return counters.open();
+        }
+
+        /**
+         * Retrieve the hardware counters of this thread, accumulated by
+         * phase of the search. Empty unless openCounters succeeded.
+         */
+        const PhaseCounters& getCounters() const{
+            return counters;
+        }
+
+        /**
+         * Copy the counters of this solver. Can be called from another thread
+         * while this solver is searching.
+         * @param snap where the counters will be copied
+         */
+        void snapshot(SolverSnapshot& snap) const;
+
         /**
          * Retrieve a clause from its reference
          * @param ref the reference of the clause we wish
@@ -442,6 +724,41 @@ namespace penelope {
 
         void printConfiguration() const;
 
+        /**
+         * Estimate the memory used by this solver, i.e., the clause arena, the
+         * watch lists and the per variable data.
+         * @return the estimated number of bytes used by this solver
+         */
+        uint64_t memoryFootprint();
+
+        /**
+         * Estimate the memory used by each part of this solver. Must be
+         * called by the thread of this solver, or once it stopped.
+         * @param mem where the number of bytes of each part will be stored
+         */
+        void memoryBreakdown(MemoryBreakdown& mem);
+
+        /**
+         * Make this solver lighter when the portfolio gets close to its memory
+         * budget: less clauses are exported and the next reduction of the
+         * learnt clause database happens sooner.
+         */
+        void applyMemoryPressure();
+
+        /**
+         * Undo applyMemoryPressure once the portfolio is back under its
+         * memory budget: the configured maxLBDExchange is restored, and so
+         * are the conflicts removed from the current reduction interval.
+         * @return true if the pressure was applied to this solver
+         */
+        bool releaseMemoryPressure();
+
+        /**
+         * Remove every learnt clause and compact the clause arena. Used to
+         * give back memory when this solver is stopped.
+         */
+        void releaseLearnts();
+
         int nbClausesNeverAttached;
         int nbClausesNotLearnt;
 
@@ -454,9 +771,25 @@ namespace penelope {
          */
         int maxLBDAccepted;
 
+        /**
+         * If set to true, the imported clauses are strengthened against the
+         * units and the binary implications of this solver before being
+         * added (see strengthenImport)
+         */
+        bool strengthenImports;
+
+        /** The number of imported clauses shortened by strengthenImport */
+        int nbImportsStrengthened;
+
+        /** The number of literals removed by strengthenImport */
+        int nbImportLitsRemoved;
+
         /** The first phase initialization policy */
         FirstPhaseInit fphase;
 
+        /** The name of the configuration of the solver (see configure) */
+        std::string configuration;
+
         /** The restart factor in the case of avglbd restart */
         double restartFactor;
 
@@ -500,6 +833,151 @@ namespace penelope {
          */
         unsigned int widthRestartC;
 
+        /**
+         * If true, the thread of this solver runs a local search on its
+         * original clauses instead of the CDCL search (see LocalSearch)
+         */
+        bool localSearchWorker;
+
+        /**
+         * If true, the thread of this solver divides the search space with
+         * the other threads of the divide and conquer mode (see
+         * solveGuidingPaths)
+         */
+        bool divideWorker;
+
+        /**
+         * The exponent of the break values in the flip probabilities of the
+         * local search: a variable breaking b clauses is flipped with a
+         * probability proportional to (1 + b)^-localSearchCb
+         */
+        double localSearchCb;
+
+        /**
+         * The number of flips of the first run of the local search, doubled
+         * at each restart
+         */
+        int localSearchFlips;
+
+        /**
+         * The number of flips between two publications of the best
+         * assignment of the local search
+         */
+        int localSearchPublish;
+
+        /**
+         * If true, the best assignment published by the local search
+         * threads replaces the polarities of this solver at its next restart
+         */
+        bool useLocalSearchPhases;
+
+        /**
+         * Copy the preferred polarity of each variable
+         * @param phases where the polarities are copied (true for a negative
+         *        literal)
+         */
+        void getPolarities(vec<char>& phases) const;
+
+        /**
+         * Replace the preferred polarity of the unassigned variables. The
+         * new polarities also become the reference of the deviation measured
+         * by the progress saving based reduction (see usePsm), so that the
+         * change isn't taken for a deviation of the search.
+         * @param phases the new polarities (true for a negative literal)
+         */
+        void setPolarities(const vec<char>& phases);
+
+        /**
+         * Copy the polarities the deviation of the progress saving based
+         * reduction is measured from (see usePsm)
+         * @param phases where the polarities are copied
+         */
+        void getSavedPolarities(vec<char>& phases) const {
+            savePolarity.copyTo(phases);
+        }
+
+        /**
+         * @return the deviation of the polarities from the saved ones, as
+         *         measured by the progress saving based reduction
+         */
+        int getHammingDistance() const {
+            return hammingDistance;
+        }
+
+        /**
+         * The number of conflicts before the first rephasing. The following
+         * ones happen after 2, 3, ... times as many conflicts. 0 disables the
+         * rephasing.
+         */
+        int rephaseInterval;
+
+        /**
+         * The polarities taken by the successive rephasings, cyclically: b
+         * for the longest trail reached in the portfolio, i for its inverse,
+         * o for the original polarities and r for random ones
+         */
+        std::string rephaseCycle;
+
+        /** The number of rephasings done so far */
+        int nbRephases;
+
+        /**
+         * The number of propagations each vivification of the learnt clauses
+         * can spend, at the first restart following a reduction of the
+         * learnt clause database. 0 disables the vivification.
+         */
+        int vivifyBudget;
+
+        /** The number of learnt clauses shortened by the vivification */
+        int nbVivified;
+
+        /** The number of literals removed by the vivification */
+        int nbVivifiedLits;
+
+        /**
+         * The number of learnt clauses exported because the vivification
+         * brought their lbd down to maxLBDExchanged
+         */
+        int nbVivifiedExported;
+
+        /**
+         * If true, the XOR constraints encoded by the original clauses are
+         * recovered at the start of the search, and propagated by a
+         * Gauss-Jordan elimination along with the clauses
+         */
+        bool useXor;
+
+        /**
+         * @return the engine propagating the recovered XOR constraints, NULL
+         *         if they were not recovered
+         */
+        const XorEngine* getXorEngine() const {
+            return xors;
+        }
+
+        /**
+         * @return the size of the longest trail reached since the last
+         *         rephasing
+         */
+        int getBestTrail() const {
+            return bestTrail;
+        }
+
+        /**
+         * Copy the polarities of the longest trail reached since the last
+         * rephasing
+         * @param phases where the polarities are copied
+         */
+        void getBestPolarities(vec<char>& phases) const;
+
+        /**
+         * Replace the polarities by the next ones of rephaseCycle. Called at
+         * level 0, once nextRephase is reached.
+         * @param coop the cooperation, where the longest trail of the
+         *        portfolio is published and read
+         */
+        void rephase(Cooperation* coop);
+
     protected:
 
         // Solver state:
@@ -584,6 +1062,37 @@ namespace penelope {
          */
         int hammingDistance;
 
+        /** The polarity of each variable when it was created (see fphase) */
+        vec<char> originalPolarity;
+
+        /**
+         * The polarities of the longest trail reached since the last
+         * rephasing. The variables that were not on that trail keep the
+         * polarities of the previous best trails.
+         */
+        vec<char> bestPolarity;
+
+        /** The size of the longest trail reached since the last rephasing */
+        int bestTrail;
+
+        /** The number of conflicts at which the next rephasing happens */
+        uint64_t nextRephase;
+
+        /** true if the learnt clauses are to be vivified at the next restart */
+        bool vivifyPending;
+
+        /**
+         * true while the solver propagates outside of the search (probing,
+         * vivification): the lbd of the learnt clauses is not updated
+         */
+        bool inprocessing;
+
+        /** The XOR constraints are propagated on the trail of the solver */
+        friend class XorEngine;
+
+        /** The engine of the recovered XOR constraints, NULL if useXor is false */
+        XorEngine* xors;
+
         /** The last computed deviation */
         double lastDeviation;
 
@@ -670,6 +1179,18 @@ namespace penelope {
         /** The number of clauses that were exported in this thread */
         int64_t nbExportedClauses;
 
+        /** The time spent in each phase of the search */
+        PhaseProfile profile;
+
+        /** The hardware counters of the search, by phase */
+        PhaseCounters counters;
+
+        /**
+         * The number of learnt clauses, published for the threads that take
+         * snapshots of this solver
+         */
+        int nbLearntsSnapshot;
+
         // The different options for the solver
         bool usePsm;
 
@@ -677,6 +1198,18 @@ namespace penelope {
 
         unsigned int maxLBDExchanged;
 
+        /** The value of maxLBDExchanged given by the configuration */
+        unsigned int configuredMaxLBDExchanged;
+
+        /**
+         * The number of conflicts removed by the memory pressure from the
+         * current reduction interval (see controlReduce)
+         */
+        int pressureReduceCut;
+
+        /** true while the memory pressure applies to this solver */
+        bool pressured;
+
         unsigned int maxLBD;
 
         bool restartAvgLBD;
@@ -789,6 +1322,35 @@ namespace penelope {
          */
         lbool search(int nof_conflicts, Cooperation* coop);
 
+        /**
+         * Save the polarities of the current trail as the best ones. Called
+         * at a conflict, when the trail is longer than the best one.
+         */
+        void saveBestTrail();
+
+        /**
+         * Go back to level 0 after a probing or a vivification, without
+         * changing the polarities
+         */
+        void cancelProbe();
+
+        /**
+         * Perform unit propagation on the clauses only
+         * @param coop the cooperation where the clauses whose lbd improves
+         *        are exported
+         * @return the conflicting clause, or CRef_Undef
+         */
+        CRef propagateClauses(Cooperation* coop);
+
+        /**
+         * Give away a part of the guiding path to an idle thread: the first
+         * decision after the assumptions becomes an assumption, and the
+         * assumptions with its negation make the path given away. Called
+         * when the decision level is above the assumptions.
+         * @param coop the cooperation holding the guiding paths
+         */
+        void splitGuidingPath(Cooperation* coop);
+
         /**
          * Main solve method (assumptions given in 'assumptions').
          * @param coop
@@ -879,7 +1441,13 @@ namespace penelope {
          */
         bool satisfied(const Clause& c) const;
 
-        void relocAll(ClauseAllocator& to);
+        /**
+         * Relocate every clause reference of the solver in a new allocator
+         * @param to the allocator the clauses will be copied to
+         * @param onlyLearnts if true, only the learnt region is relocated and
+         *        the problem clauses keep their current references
+         */
+        void relocAll(ClauseAllocator& to, bool onlyLearnts = false);
 
         // Misc:
         //
@@ -974,7 +1542,7 @@ namespace penelope {
     }
 
     inline void Solver::checkGarbage(double gf) {
-        if (ca.wasted() > ca.size() * gf)
+        if (ca.learntWasted() > ca.learntSize() * gf || ca.problemWasted() > ca.problemSize() * gf)
             garbageCollect();
     }
 
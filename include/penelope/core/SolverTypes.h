@@ -137,12 +137,14 @@ class Clause {
       unsigned isUsed     : 1;
       unsigned lbd        : 20;
       unsigned size       : 31;
+      unsigned traced     : 1;
       int8_t generator;
       bool usedOnce;
+      bool vivified;
       int nbAttached;
       
       header_t() : mark(0), learnt(0), has_extra(0), reloced(0), usefull(0),
-      isAttached(0), nbFreezeLeft(0), isUsed(0), lbd(0), size(0), generator(-2), usedOnce(false), nbAttached(0) {}
+      isAttached(0), nbFreezeLeft(0), isUsed(0), lbd(0), size(0), traced(0), generator(-2), usedOnce(false), vivified(false), nbAttached(0) {}
       
     } header;
     union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
@@ -162,6 +164,7 @@ class Clause {
         header.nbFreezeLeft = 7;
         header.isUsed = 1;
         header.lbd = 0;
+        header.traced = 0;
         
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -210,6 +213,14 @@ public:
     void setUsedOnce(){header.usedOnce = true;}
     /** Check if the clause was used at least once */
     bool getUsedOnce(){return header.usedOnce;}
+    /** Specify that the clause went through the vivification */
+    void setVivified(){header.vivified = true;}
+    /** Check if the clause went through the vivification */
+    bool isVivified() const {return header.vivified;}
+    /** Specify that the fate of this imported clause is traced */
+    void setTraced(bool t){header.traced = t;}
+    /** Check if the fate of this imported clause is traced */
+    bool isTraced() const {return header.traced;}
 
     /**
      * Retrieve the number of times the clause might be frozen before being
@@ -260,48 +271,93 @@ public:
 
 
 //=================================================================================================
-// ClauseAllocator -- a simple class for allocating memory for clauses:
+// ClauseAllocator -- a generational allocator for clauses:
+//
+// Problem clauses and learnt clauses are stored in two distinct regions. The region of a clause is
+// encoded in the most significant bit of its reference, which allows the learnt region (where
+// almost all the garbage is produced) to be compacted without copying the problem clauses.
 
 
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
-class ClauseAllocator : public RegionAllocator<uint32_t>
+class ClauseAllocator
 {
+    /** The region containing the clauses of the initial problem */
+    RegionAllocator<uint32_t> problem;
+    /** The region containing the learnt (and imported) clauses */
+    RegionAllocator<uint32_t> learnt;
+
     static int clauseWord32Size(int size, bool has_extra){
         return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
  public:
+    typedef RegionAllocator<uint32_t>::Ref Ref;
+    enum { Unit_Size = RegionAllocator<uint32_t>::Unit_Size };
+    /** The bit set in the references of the clauses stored in the learnt region */
+    static const uint32_t Learnt_Region = 0x80000000;
+
     bool extra_clause_field;
 
-    ClauseAllocator(uint32_t start_cap) : RegionAllocator<uint32_t>(start_cap), extra_clause_field(false){}
-    ClauseAllocator() : extra_clause_field(false){}
+    ClauseAllocator(uint32_t problem_cap, uint32_t learnt_cap) : problem(problem_cap), learnt(learnt_cap), extra_clause_field(false){}
+    ClauseAllocator() : problem(512*1024), learnt(512*1024), extra_clause_field(false){}
+
+    uint32_t size        () const { return problem.size() + learnt.size(); }
+    uint32_t wasted      () const { return problem.wasted() + learnt.wasted(); }
+    uint32_t problemSize () const { return problem.size(); }
+    uint32_t problemWasted() const { return problem.wasted(); }
+    uint32_t learntSize  () const { return learnt.size(); }
+    uint32_t learntWasted() const { return learnt.wasted(); }
+
+    /** Check whether a reference designates a clause of the learnt region */
+    static bool inLearntRegion(Ref r) { return (r & Learnt_Region) != 0; }
 
     void moveTo(ClauseAllocator& to){
         to.extra_clause_field = extra_clause_field;
-        RegionAllocator<uint32_t>::moveTo(to); }
+        problem.moveTo(to.problem);
+        learnt.moveTo(to.learnt); }
+
+    /** Only move the learnt region, the problem region of 'to' is left untouched */
+    void moveLearntsTo(ClauseAllocator& to){
+        learnt.moveTo(to.learnt); }
 
     template<class Lits>
-    CRef alloc(const Lits& ps, bool learnt = false)
+    CRef alloc(const Lits& ps, bool isLearnt = false)
     {
         ASSERT_TRUE(sizeof(Lit)      == sizeof(uint32_t));
         ASSERT_TRUE(sizeof(float)    == sizeof(uint32_t));
-        bool use_extra = learnt | extra_clause_field;
+        bool use_extra = isLearnt | extra_clause_field;
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt);
+        RegionAllocator<uint32_t>& region = isLearnt ? learnt : problem;
+        CRef cid = region.alloc(clauseWord32Size(ps.size(), use_extra));
+        // The highest bit is reserved to identify the region (and Ref_Undef)
+        if (cid >= Learnt_Region - 1)
+            throw OutOfMemoryException();
+        if (isLearnt) cid |= Learnt_Region;
+        new (lea(cid)) Clause(ps, use_extra, isLearnt);
 
         return cid;
     }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
-    Clause&       operator[](Ref r)       { return (Clause&)RegionAllocator<uint32_t>::operator[](r); }
-    const Clause& operator[](Ref r) const { return (Clause&)RegionAllocator<uint32_t>::operator[](r); }
-    Clause*       lea       (Ref r)       { return (Clause*)RegionAllocator<uint32_t>::lea(r); }
-    const Clause* lea       (Ref r) const { return (Clause*)RegionAllocator<uint32_t>::lea(r); }
-    Ref           ael       (const Clause* t){ return RegionAllocator<uint32_t>::ael((uint32_t*)t); }
+    Clause&       operator[](Ref r)       { return *lea(r); }
+    const Clause& operator[](Ref r) const { return *lea(r); }
+    Clause*       lea       (Ref r)       { return (Clause*)(inLearntRegion(r) ? learnt.lea(r & ~Learnt_Region) : problem.lea(r)); }
+    const Clause* lea       (Ref r) const { return (const Clause*)(inLearntRegion(r) ? learnt.lea(r & ~Learnt_Region) : problem.lea(r)); }
+    Ref           ael       (const Clause* t){
+        if (learnt.contains((const uint32_t*)t)) return learnt.ael((const uint32_t*)t) | Learnt_Region;
+        return problem.ael((const uint32_t*)t); }
 
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        (inLearntRegion(cid) ? learnt : problem).free(clauseWord32Size(c.size(), c.has_extra()));
+    }
+
+    /** Remove the last literals of a clause, their memory is wasted */
+    void shrink(CRef cid, int i)
+    {
+        Clause& c = operator[](cid);
+        int before = clauseWord32Size(c.size(), c.has_extra());
+        c.shrink(i);
+        (inLearntRegion(cid) ? learnt : problem).free(before - clauseWord32Size(c.size(), c.has_extra()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -316,10 +372,14 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         if(c.getUsedOnce()){
             to[cr].setUsedOnce();
         }
+        if(c.isVivified()){
+            to[cr].setVivified();
+        }
 
         to[cr].setNbAttach(c.getNbAttach());
 
         to[cr].setGenerator(c.getGenerator());
+        to[cr].setTraced(c.isTraced());
         
         // Copy extra data-fields: 
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
@@ -334,6 +394,12 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
         }
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
     }
+
+    /** Same as reloc, but the clauses of the problem region keep their reference */
+    void relocLearnt(CRef& cr, ClauseAllocator& to)
+    {
+        if (inLearntRegion(cr)) reloc(cr, to);
+    }
 };
 
 
@@ -0,0 +1,146 @@
+/*
+ * File:   Supervisor.h
+ * Author: bhoessen
+ *
+ * Replacement of the configurations of the portfolio that do not
+ * contribute to the search.
+ */
+
+#ifndef SUPERVISOR_H
+#define	SUPERVISOR_H
+
+#include <pthread.h>
+
+#include "penelope/core/Solver.h"
+#include "penelope/core/ParameterSpace.h"
+
+/** The seed used to derive the new configurations */
+#define SUPERVISOR_SEED 91648253
+/** The number of parameters changed when a configuration is replaced */
+#define SUPERVISOR_CHANGES 2
+/** The learnt clauses with an lbd up to this value survive a replacement */
+#define SUPERVISOR_KEPT_LBD 3
+/** The number of periods a configuration runs before it can be replaced */
+#define SUPERVISOR_GRACE_PERIODS 2
+/**
+ * A solver is replaced if its score is below this ratio of the average score
+ * of the portfolio
+ */
+#define SUPERVISOR_LOSER_RATIO 0.5
+
+namespace penelope {
+
+    class Cooperation;
+
+    /**
+     * The supervisor owns a thread that periodically scores every solver of
+     * the portfolio on the last period:
+     * - its conflicts per second, relative to the fastest solver
+     * - the number of its clauses used by the others, relative to the most
+     *   useful solver
+     * - whether its progress estimate reached a new maximum
+     * The solver with the lowest score, if far enough below the average, is
+     * asked to stop its search (see Cooperation::replaceSolver). Its thread
+     * then calls replace, which restarts it with a configuration derived
+     * from its current one, keeping its units and its low lbd clauses.
+     *
+     * Only used in the non deterministic mode: the replacements depend on
+     * the speed of the solvers.
+     */
+    class Supervisor {
+    public:
+
+        /**
+         * Create a new supervisor
+         * @param coop the cooperation holding the solvers
+         * @param parser the parser of the configuration file, where the new
+         *        configurations are stored
+         * @param period the time between two evaluations, in milliseconds
+         * @param seed the seed used to derive the new configurations
+         */
+        Supervisor(Cooperation* coop, INIParser& parser, int period, uint64_t seed);
+
+        /**
+         * Destructor. Stops the supervisor thread if needed.
+         */
+        ~Supervisor();
+
+        /**
+         * Start the supervisor thread
+         * @return true if the thread started
+         */
+        bool start();
+
+        /**
+         * Stop the supervisor thread
+         */
+        void stop();
+
+        /**
+         * Score the solvers and ask the weakest one to stop if needed. Called
+         * by the supervisor thread.
+         */
+        void evaluate();
+
+        /**
+         * Give a new configuration to a solver that stopped its search
+         * because the supervisor asked it to. Called from the thread of the
+         * solver.
+         * @param t the thread of the solver
+         * @return true if the solver has a new configuration and must search
+         *         again
+         */
+        bool replace(int t);
+
+        /** @return the number of replaced configurations */
+        int nbReplacements() const {
+            return replacements;
+        }
+
+    private:
+
+        Supervisor(const Supervisor& other);
+        Supervisor& operator=(const Supervisor& other);
+
+        /** The body of the supervisor thread */
+        static void* run(void* data);
+
+        /** The cooperation holding the solvers */
+        Cooperation* coop;
+        /** The parser holding the configurations */
+        INIParser& parser;
+        /** The values of the parameters found in the configuration file */
+        ParameterSpace space;
+        /** The time between two evaluations, in milliseconds */
+        int period;
+        /** The seed used to derive the new configurations */
+        uint64_t seed;
+        /** Guards the parser and the statistics below */
+        pthread_mutex_t guard;
+
+        /** The number of conflicts of each solver at the last evaluation */
+        uint64_t* lastConflicts;
+        /** The number of clauses of each solver used by the others */
+        uint64_t* lastUsed;
+        /** The best progress of each solver since its last configuration */
+        double* bestProgress;
+        /** The number of evaluations since the last configuration */
+        int* age;
+        /** The number of configurations each solver had */
+        int* generation;
+        /** The time of the last evaluation, in nanoseconds */
+        uint64_t lastTime;
+        /** The number of replaced configurations */
+        int replacements;
+
+        /** The supervisor thread */
+        pthread_t thread;
+        /** true while the supervisor thread is running */
+        bool running;
+        /** Set to ask the supervisor thread to stop */
+        volatile bool stopRequested;
+    };
+
+}
+
+#endif	/* SUPERVISOR_H */
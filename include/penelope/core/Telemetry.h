@@ -0,0 +1,110 @@
+/*
+ * File:   Telemetry.h
+ * Author: bhoessen
+ *
+ * Periodic report of the counters of each solver in a machine readable
+ * format.
+ */
+
+#ifndef TELEMETRY_H
+#define	TELEMETRY_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "penelope/core/Solver.h"
+
+namespace penelope {
+
+    class Cooperation;
+
+    /**
+     * The telemetry owns a reporter thread that wakes up at a fixed interval,
+     * takes a snapshot of every solver and writes one record per solver. The
+     * search threads are never blocked and never do any I/O.
+     */
+    class Telemetry {
+    public:
+
+        /** The available output formats */
+        enum Format {
+            /** one JSON object per line */
+            FORMAT_JSON,
+            /** comma separated values, with a header line */
+            FORMAT_CSV
+        };
+
+        /**
+         * Create a new telemetry
+         * @param coop the cooperation holding the solvers to report
+         * @param fileName the file where the records will be written
+         * @param interval the time between two reports, in milliseconds
+         * @param format the output format
+         */
+        Telemetry(Cooperation* coop, const char* fileName, int interval, Format format);
+
+        /**
+         * Destructor. Stops the reporter thread if needed.
+         */
+        ~Telemetry();
+
+        /**
+         * Parse the name of a format
+         * @param name "json" or "csv"
+         * @param format where the format will be stored
+         * @return true if the name is a known format
+         */
+        static bool parseFormat(const char* name, Format& format);
+
+        /**
+         * Start the reporter thread
+         * @return true if the output file could be opened and the thread
+         *         started
+         */
+        bool start();
+
+        /**
+         * Write a last record, stop the reporter thread and close the output
+         */
+        void stop();
+
+        /**
+         * Write one record per solver. Called by the reporter thread.
+         */
+        void report();
+
+    private:
+
+        Telemetry(const Telemetry& other);
+        Telemetry& operator=(const Telemetry& other);
+
+        /** The body of the reporter thread */
+        static void* run(void* data);
+
+        /** The cooperation holding the solvers */
+        Cooperation* coop;
+        /** The name of the output file */
+        const char* fileName;
+        /** The output file */
+        FILE* output;
+        /** The time between two reports, in milliseconds */
+        int interval;
+        /** The output format */
+        Format format;
+        /** The reporter thread */
+        pthread_t thread;
+        /** true while the reporter thread is running */
+        bool running;
+        /** Set to ask the reporter thread to stop */
+        volatile bool stopRequested;
+        /** The time of the start, in nanoseconds */
+        uint64_t startTime;
+        /** The time of the last report, in nanoseconds */
+        uint64_t lastTime;
+        /** The snapshots taken at the last report */
+        SolverSnapshot* last;
+    };
+
+}
+
+#endif	/* TELEMETRY_H */
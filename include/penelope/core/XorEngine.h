@@ -0,0 +1,205 @@
+/*
+ * File:   XorEngine.h
+ * Author: bhoessen
+ *
+ * The XOR constraints recovered from the clauses of a solver, propagated
+ * by a Gauss-Jordan elimination.
+ */
+
+#ifndef XORENGINE_H
+#define	XORENGINE_H
+
+#include "penelope/core/SolverTypes.h"
+#include "penelope/utils/Vec.h"
+
+/** The longest XOR constraints recovered from the clauses */
+#define XOR_MAX_SIZE 6
+/** The Gauss-Jordan elimination is only done on the systems of at most
+ * that many XOR constraints */
+#define XOR_GAUSS_MAX_ROWS 2048
+/** See XOR_GAUSS_MAX_ROWS, for the number of variables of the system */
+#define XOR_GAUSS_MAX_VARS 4096
+
+namespace penelope {
+
+    class Solver;
+
+    /**
+     * The XOR constraints of a solver, recovered from its original clauses:
+     * the 2^(k-1) clauses over the same k variables that forbid every
+     * assignment of the same parity encode the XOR of these variables. The
+     * clauses are kept: they already propagate each constraint on its own.
+     * When the system is small enough and its constraints share variables,
+     * it is kept in reduced row echelon form on its unassigned variables by
+     * a Gauss-Jordan elimination: each row has an unassigned pivot that
+     * occurs in no other row, and the row combinations left with at most
+     * one unassigned variable are conflicting or unit. The elimination is
+     * resumed at each propagation fixpoint of the clauses, for the rows
+     * whose pivot was assigned. Otherwise the engine propagates nothing.
+     *
+     * The literals implied by the engine have no reason clause: the clause
+     * is built on demand by the conflict analysis, from the variables of the
+     * constraint that implied the literal, and freed once the literal is
+     * unassigned.
+     */
+    class XorEngine {
+    public:
+
+        /**
+         * Create an engine without any constraint
+         * @param s the solver whose clauses are recovered
+         */
+        XorEngine(Solver& s);
+
+        /**
+         * Find the XOR constraints encoded by clauses
+         * @param ca the allocator of the clauses
+         * @param clauses the clauses, without any assigned literal
+         * @param vars where the variables of each constraint are added
+         * @param parities where the parity of each constraint is added
+         */
+        static void find(const ClauseAllocator& ca, const vec<CRef>& clauses,
+                vec<vec<Var> >& vars, vec<char>& parities);
+
+        /**
+         * Recover the constraints from the original clauses of the solver
+         * without any assigned literal. Called once, at level 0.
+         */
+        void recover();
+
+        /**
+         * Run the Gauss-Jordan elimination if a variable of the system was
+         * assigned since the last one
+         * @return the conflicting clause, or CRef_Undef
+         */
+        CRef propagate();
+
+        /**
+         * Forget the literals of the trail that are about to be unassigned,
+         * freeing their reason clause
+         * @param size the size of the trail after the backtrack
+         */
+        void backtrack(int size);
+
+        /**
+         * @return the reason clause of a variable implied by the engine,
+         *         built if it does not exist yet, or CRef_Undef if the
+         *         variable was not implied by the engine
+         */
+        CRef reason(Var v);
+
+        /** Forget the last conflicting clause, after a garbage collection */
+        void relocated() {
+            conflict = CRef_Undef;
+        }
+
+        /** @return the number of recovered constraints */
+        int nbXors() const {
+            return xors.size();
+        }
+
+        /** @return true if the system is eliminated */
+        bool hasGauss() const {
+            return gauss;
+        }
+
+        /** @return the number of literals implied by the elimination */
+        uint64_t nbEliminated() const {
+            return eliminated;
+        }
+
+        /** @return the number of conflicts found by the engine */
+        uint64_t nbConflicts() const {
+            return conflicts;
+        }
+
+    private:
+        XorEngine(const XorEngine& other);
+        XorEngine& operator=(const XorEngine& other);
+
+        /** Prepare the matrix of the elimination */
+        void buildMatrix();
+
+        /**
+         * Give a new pivot to the rows whose pivot is assigned, then look
+         * for the rows with at most one unassigned column
+         * @return the conflicting clause, or CRef_Undef
+         */
+        CRef eliminate();
+
+        /**
+         * Assign the last unassigned variable of a constraint
+         * @param vars the variables of the constraint
+         * @param v the unassigned variable
+         * @param value its value
+         */
+        void imply(const vec<Var>& vars, Var v, bool value);
+
+        /**
+         * Build the clause of a constraint under the current assignment,
+         * the literal of its implied variable first
+         * @param vars the variables of the constraint
+         * @param implied the variable whose literal is true, var_Undef if
+         *        all of them are false
+         */
+        CRef buildClause(const vec<Var>& vars, Var implied);
+
+        /**
+         * Build the conflicting clause of a constraint, freeing the previous
+         * one
+         */
+        CRef conflicting(const vec<Var>& vars);
+
+        /** The solver */
+        Solver& s;
+
+        /** The variables of each constraint */
+        vec<vec<Var> > xors;
+        /** The parity of each constraint */
+        vec<char> parities;
+        /** The position of the next literal of the trail seen by the engine */
+        int qhead;
+
+        /** 1 for the variables implied by the engine */
+        vec<char> implied;
+        /** The variables of the constraint that implied each variable */
+        vec<vec<Var> > reasons;
+        /** The last conflicting clause, freed by the next one */
+        CRef conflict;
+
+        /** true if the system is eliminated */
+        bool gauss;
+        /** true if a variable of the system was assigned since the last
+         * elimination */
+        bool dirty;
+        /** The column of each variable, -1 if it is in no constraint */
+        vec<int> column;
+        /** The variable of each column */
+        vec<Var> columnVar;
+        /** The number of words of a row of the matrix */
+        int words;
+        /**
+         * The rows of the system, one after the other, combined by the
+         * successive eliminations
+         */
+        vec<uint64_t> rows;
+        /** The parity of each row */
+        vec<char> rowParities;
+        /** The pivot column of each row, -1 if it has none */
+        vec<int> pivots;
+        /** The unassigned columns */
+        vec<uint64_t> unassigned;
+        /** The variables of a row */
+        vec<Var> rowVars;
+        /** The literals of the clause being built */
+        vec<Lit> lits;
+
+        /** The number of literals implied by the elimination */
+        uint64_t eliminated;
+        /** The number of conflicts found by the engine */
+        uint64_t conflicts;
+    };
+
+}
+
+#endif	/* XORENGINE_H */
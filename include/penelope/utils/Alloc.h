@@ -71,6 +71,7 @@ class RegionAllocator
     const T* lea       (Ref r) const { ASSERT_TRUE(r < sz); return &memory[r]; }
     Ref      ael       (const T* t)  { ASSERT_TRUE((void*)t >= (void*)&memory[0] && (void*)t < (void*)&memory[sz-1]);
         return  (Ref)(t - &memory[0]); }
+    bool     contains  (const T* t) const { return memory != NULL && t >= &memory[0] && t < &memory[sz]; }
 
     void     moveTo(RegionAllocator& to) {
         if (to.memory != NULL) ::free(to.memory);
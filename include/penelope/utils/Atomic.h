@@ -0,0 +1,65 @@
+/*
+ * File:   Atomic.h
+ * Author: bhoessen
+ *
+ * Atomic accesses, used to read the counters of a thread from another one
+ * without any lock.
+ */
+
+#ifndef ATOMIC_H
+#define	ATOMIC_H
+
+namespace penelope {
+
+    /**
+     * Read a value written by another thread. No ordering is guaranteed with
+     * the other memory accesses, but the value is never torn.
+     * @param ptr the address of the value
+     * @return the value
+     */
+    template<class T>
+    inline T atomicLoad(const T* ptr) {
+        T ret;
+        __atomic_load(ptr, &ret, __ATOMIC_RELAXED);
+        return ret;
+    }
+
+    /**
+     * Write a value that will be read by another thread. No ordering is
+     * guaranteed with the other memory accesses.
+     * @param ptr the address of the value
+     * @param val the new value
+     */
+    template<class T>
+    inline void atomicStore(T* ptr, T val) {
+        __atomic_store(ptr, &val, __ATOMIC_RELAXED);
+    }
+
+    /**
+     * Read a value published by another thread with atomicStoreRelease:
+     * every write done by that thread before the publication is visible
+     * after this read.
+     * @param ptr the address of the value
+     * @return the value
+     */
+    template<class T>
+    inline T atomicLoadAcquire(const T* ptr) {
+        T ret;
+        __atomic_load(ptr, &ret, __ATOMIC_ACQUIRE);
+        return ret;
+    }
+
+    /**
+     * Publish a value: every write done before it is visible to the threads
+     * reading it with atomicLoadAcquire.
+     * @param ptr the address of the value
+     * @param val the new value
+     */
+    template<class T>
+    inline void atomicStoreRelease(T* ptr, T val) {
+        __atomic_store(ptr, &val, __ATOMIC_RELEASE);
+    }
+
+}
+
+#endif	/* ATOMIC_H */
@@ -0,0 +1,78 @@
+/*
+ * File:   Barrier.h
+ * Author: bhoessen
+ *
+ * Synchronization point of a fixed group of threads.
+ */
+
+#ifndef BARRIER_H
+#define	BARRIER_H
+
+#include <pthread.h>
+
+namespace penelope {
+
+    /**
+     * A reusable barrier: the threads calling wait are blocked until every
+     * participant called it. A participant that will never wait again (e.g.,
+     * a solver that stopped its search) must leave the barrier, so that the
+     * others are not blocked forever.
+     */
+    class Barrier {
+    public:
+
+        /**
+         * Create a new barrier
+         * @param nbParticipants the number of threads that will wait on it
+         */
+        Barrier(int nbParticipants);
+
+        /**
+         * Destructor
+         */
+        ~Barrier();
+
+        /**
+         * Wait until every participant reached the barrier
+         */
+        void wait();
+
+        /**
+         * Remove the calling thread from the participants. Releases the
+         * waiting threads if it was the last one they were waiting for.
+         */
+        void leave();
+
+        /**
+         * Change the number of participants. No thread may be waiting.
+         * @param nbParticipants the new number of participants
+         */
+        void reset(int nbParticipants);
+
+        /**
+         * Retrieve the number of participants
+         */
+        int nbParticipants() const {
+            return participants;
+        }
+
+    private:
+        Barrier(const Barrier& other);
+        Barrier& operator=(const Barrier& other);
+
+        /** Release the waiting threads. The mutex must be held */
+        void release();
+
+        pthread_mutex_t mutex;
+        pthread_cond_t cond;
+        /** The number of threads taking part in the synchronization */
+        int participants;
+        /** The number of threads waiting in the current generation */
+        int arrived;
+        /** Incremented each time the waiting threads are released */
+        unsigned int generation;
+    };
+
+}
+
+#endif	/* BARRIER_H */
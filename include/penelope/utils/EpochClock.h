@@ -0,0 +1,87 @@
+/*
+ * File:   EpochClock.h
+ * Author: bhoessen
+ *
+ * Logical clocks of a group of threads.
+ */
+
+#ifndef EPOCHCLOCK_H
+#define	EPOCHCLOCK_H
+
+#include <pthread.h>
+
+namespace penelope {
+
+    /**
+     * The logical clock of each thread of a group, i.e., the number of epochs
+     * it completed. A thread only waits for the others to reach a given
+     * epoch, never for the whole group to meet at the same point.
+     */
+    class EpochClock {
+    public:
+
+        /** The clock of a thread that will not complete any other epoch */
+        static const int FINISHED;
+
+        /**
+         * Create the clocks, every thread being at epoch 0
+         * @param nbThreads the number of threads
+         */
+        EpochClock(int nbThreads);
+
+        /**
+         * Destructor
+         */
+        ~EpochClock();
+
+        /**
+         * Publish that a thread completed an epoch. Every write done by the
+         * thread before is visible to the threads that see the new value.
+         * @param t the thread
+         * @param e the epoch it completed
+         */
+        void publish(int t, int e);
+
+        /**
+         * Publish that a thread will not complete any other epoch
+         * @param t the thread
+         */
+        void finish(int t);
+
+        /**
+         * Retrieve the number of epochs completed by a thread
+         * @param t the thread
+         * @return the epoch, or FINISHED
+         */
+        int epoch(int t) const;
+
+        /**
+         * Wait until every thread but one completed an epoch (or finished)
+         * @param t the waiting thread
+         * @param e the epoch to wait for
+         */
+        void waitOthers(int t, int e);
+
+        /**
+         * Put every thread back to epoch 0. No thread may be waiting.
+         */
+        void reset();
+
+    private:
+        EpochClock(const EpochClock& other);
+        EpochClock& operator=(const EpochClock& other);
+
+        /** Check whether every thread but t completed the epoch e */
+        bool othersReached(int t, int e) const;
+
+        int nbThreads;
+        /** The epoch completed by each thread */
+        int* epochs;
+        pthread_mutex_t mutex;
+        /** Signaled each time a clock changes */
+        pthread_cond_t advanced;
+    };
+
+}
+
+#endif	/* EPOCHCLOCK_H */
@@ -0,0 +1,123 @@
+/*
+ * File:   Executor.h
+ * Author: bhoessen
+ *
+ * Execution of the solvers of a portfolio on a group of threads.
+ */
+
+#ifndef EXECUTOR_H
+#define	EXECUTOR_H
+
+#include <pthread.h>
+
+namespace penelope {
+
+    /**
+     * A piece of work executed once by every worker of an executor
+     */
+    class Task {
+    public:
+
+        virtual ~Task() {
+        }
+
+        /**
+         * Execute the task
+         * @param worker the number of the worker executing it, in
+         *        [0, nbWorkers[
+         */
+        virtual void execute(int worker) = 0;
+    };
+
+    /**
+     * Run the tasks of a portfolio. The workers of a task synchronize with
+     * each other (e.g., the barriers of the deterministic mode), so they must
+     * all run concurrently: an executor must provide one thread per worker.
+     * Applications embedding the solver can implement this interface to run
+     * the portfolio on their own threads.
+     */
+    class Executor {
+    public:
+
+        virtual ~Executor() {
+        }
+
+        /**
+         * Retrieve the number of workers, i.e., of concurrent executions of
+         * each task
+         */
+        virtual int nbWorkers() const = 0;
+
+        /**
+         * Execute a task on every worker and wait until they all finished
+         * @param task the task to execute
+         */
+        virtual void run(Task& task) = 0;
+    };
+
+    /**
+     * An executor owning a fixed pool of threads, created once and reused by
+     * every task
+     */
+    class ThreadPoolExecutor : public Executor {
+    public:
+
+        /**
+         * Create the pool and start its threads
+         * @param nbWorkers the number of threads
+         */
+        ThreadPoolExecutor(int nbWorkers);
+
+        /**
+         * Stop and join the threads of the pool
+         */
+        ~ThreadPoolExecutor();
+
+        int nbWorkers() const {
+            return nbThreads;
+        }
+
+        void run(Task& task);
+
+    private:
+        ThreadPoolExecutor(const ThreadPoolExecutor& other);
+        ThreadPoolExecutor& operator=(const ThreadPoolExecutor& other);
+
+        /** What a thread of the pool needs to know */
+        struct Worker {
+            ThreadPoolExecutor* pool;
+            int id;
+            pthread_t thread;
+        };
+
+        /** The body of the threads of the pool */
+        static void* work(void* data);
+
+        /** The number of threads of the pool */
+        int nbThreads;
+        /** The threads of the pool */
+        Worker* workers;
+        pthread_mutex_t mutex;
+        /** Signaled when a new task is available or the pool stops */
+        pthread_cond_t taskReady;
+        /** Signaled when a worker finished the current task */
+        pthread_cond_t taskDone;
+        /** The task being executed, NULL if none */
+        Task* task;
+        /** Incremented each time a new task is submitted */
+        unsigned int generation;
+        /** The number of workers still executing the current task */
+        int running;
+        /** true when the threads must stop */
+        bool stopping;
+    };
+
+    /**
+     * Retrieve the number of processors available to this process
+     * @return the number of online processors, at least 1
+     */
+    int nbProcessors();
+
+}
+
+#endif	/* EXECUTOR_H */
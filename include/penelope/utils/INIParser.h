@@ -10,6 +10,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace penelope{
 
@@ -51,6 +52,29 @@ namespace penelope{
          */
         const std::string& getValueForConf(const std::string& conf, const std::string& attribute) const ;
 
+        /**
+         * Set the value of an attribute for a given configuration. The
+         * configuration is created if needed.
+         * @param conf the configuration
+         * @param attribute the name of the attribute
+         * @param value the new value of the attribute
+         */
+        void setValueForConf(const std::string& conf, const std::string& attribute, const std::string& value);
+
+        /**
+         * Copy every attribute of a configuration into another one, which is
+         * created if needed
+         * @param from the configuration that is copied
+         * @param to the configuration that receives the attributes
+         */
+        void copyConfiguration(const std::string& from, const std::string& to);
+
+        /**
+         * Retrieve the name of every configuration
+         * @param confs where the names will be added
+         */
+        void getConfigurations(std::vector<std::string>& confs) const;
+
     private:
 
         /** The name of the file that was parsed */
@@ -0,0 +1,189 @@
+/*
+ * File:   PerfCounters.h
+ * Author: bhoessen
+ *
+ * Hardware and software performance counters of the calling thread.
+ */
+
+#ifndef PERFCOUNTERS_H
+#define	PERFCOUNTERS_H
+
+#include "penelope/utils/IntTypes.h"
+
+namespace penelope {
+
+    /**
+     * The performance counters of one thread, based on perf_event_open. Each
+     * counter is opened independently: the counters that are not supported by
+     * the kernel (or not allowed, see /proc/sys/kernel/perf_event_paranoid)
+     * are simply reported as unavailable. On other systems, no counter is
+     * available.
+     */
+    class PerfCounters {
+    public:
+
+        /** The measured events */
+        enum Counter {
+            /** CPU cycles spent in user space */
+            PERF_CYCLES = 0,
+            /** instructions retired in user space */
+            PERF_INSTRUCTIONS,
+            /** last level cache misses */
+            PERF_CACHE_MISSES,
+            /** mispredicted branches */
+            PERF_BRANCH_MISSES,
+            /** data TLB read misses */
+            PERF_DTLB_MISSES,
+            /** time spent on the cpu by the thread, in nanoseconds */
+            PERF_TASK_CLOCK,
+            PERF_NB_COUNTERS
+        };
+
+        PerfCounters();
+
+        /**
+         * Destructor, closes the counters
+         */
+        ~PerfCounters();
+
+        /**
+         * Open the counters for the calling thread. They start counting
+         * immediately.
+         * @return true if at least one counter is available
+         */
+        bool open();
+
+        /**
+         * Close the counters
+         */
+        void close();
+
+        /**
+         * Check whether a counter could be opened
+         * @param c the counter
+         */
+        inline bool available(Counter c) const {
+            return fds[c] >= 0;
+        }
+
+        /**
+         * Check whether at least one counter could be opened
+         */
+        bool isOpen() const;
+
+        /**
+         * Read the current value of every counter. The unavailable counters
+         * are read as 0.
+         * @param values an array of PERF_NB_COUNTERS elements
+         */
+        void read(uint64_t* values) const;
+
+        /**
+         * Retrieve the name of a counter
+         * @param c the counter
+         */
+        static const char* name(Counter c);
+
+    private:
+        PerfCounters(const PerfCounters& other);
+        PerfCounters& operator=(const PerfCounters& other);
+
+        /** The file descriptor of each counter, -1 if not available */
+        int fds[PERF_NB_COUNTERS];
+    };
+
+    /**
+     * The phases of the search that are measured separately by the
+     * PhaseCounters
+     */
+    enum CounterPhase {
+        /** propagation, conflict analysis and clause exchange */
+        COUNTERS_SEARCH = 0,
+        /** reduction of the learnt clause database and garbage collection */
+        COUNTERS_REDUCE,
+        COUNTERS_NB_PHASES
+    };
+
+    /**
+     * The performance counters of one thread, accumulated by phase. The
+     * counters are only read when the phase changes, so the phases should be
+     * coarse enough to amortize the read system calls.
+     */
+    class PhaseCounters {
+    public:
+
+        PhaseCounters();
+
+        /**
+         * Open the counters for the calling thread
+         * @return true if at least one counter is available
+         */
+        inline bool open() {
+            return counters.open();
+        }
+
+        /**
+         * Check whether the counters are measured
+         */
+        inline bool isOpen() const {
+            return counters.isOpen();
+        }
+
+        /**
+         * Check whether a counter is measured
+         * @param c the counter
+         */
+        inline bool available(PerfCounters::Counter c) const {
+            return counters.available(c);
+        }
+
+        /**
+         * Start accumulating the counters in a phase
+         * @param p the phase
+         */
+        void start(CounterPhase p);
+
+        /**
+         * Accumulate the events since the last call to start or switchTo in
+         * the current phase, then start accumulating in another one
+         * @param p the new phase
+         */
+        void switchTo(CounterPhase p);
+
+        /**
+         * Accumulate the events since the last call to start or switchTo in
+         * the current phase and stop accumulating
+         */
+        void stop();
+
+        /**
+         * Retrieve the value accumulated by a counter in a phase
+         * @param p the phase
+         * @param c the counter
+         */
+        inline uint64_t value(CounterPhase p, PerfCounters::Counter c) const {
+            return totals[p][c];
+        }
+
+        /**
+         * Retrieve the name of a phase
+         * @param p the phase
+         */
+        static const char* name(CounterPhase p);
+
+    private:
+        PhaseCounters(const PhaseCounters& other);
+        PhaseCounters& operator=(const PhaseCounters& other);
+
+        PerfCounters counters;
+        /** The phase being measured, COUNTERS_NB_PHASES if none */
+        CounterPhase phase;
+        /** The value of the counters when the current phase was entered */
+        uint64_t mark[PerfCounters::PERF_NB_COUNTERS];
+        /** The values accumulated in each phase */
+        uint64_t totals[COUNTERS_NB_PHASES][PerfCounters::PERF_NB_COUNTERS];
+    };
+
+}
+
+#endif	/* PERFCOUNTERS_H */
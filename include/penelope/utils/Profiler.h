@@ -0,0 +1,146 @@
+/*
+ * File:   Profiler.h
+ * Author: bhoessen
+ *
+ * Time spent by a solver in the different phases of the search.
+ */
+
+#ifndef PROFILER_H
+#define	PROFILER_H
+
+#include "penelope/utils/IntTypes.h"
+#include "penelope/utils/System.h"
+
+namespace penelope {
+
+    /**
+     * The phases of the search that are profiled. The phases may be nested:
+     * the clauses exported while propagating are counted in both
+     * PROFILE_PROPAGATE and PROFILE_EXPORT, and every phase is part of
+     * PROFILE_SOLVE.
+     */
+    enum ProfilePhase {
+        PROFILE_SOLVE = 0,
+        PROFILE_PROPAGATE,
+        PROFILE_ANALYZE,
+        PROFILE_REDUCE,
+        PROFILE_GC,
+        PROFILE_IMPORT,
+        PROFILE_EXPORT,
+        PROFILE_NB_PHASES
+    };
+
+    /**
+     * The time accumulated by one thread in each phase. Each solver owns its
+     * own profile, so no synchronization is needed.
+     */
+    class PhaseProfile {
+    private:
+        /** The time spent in each phase, in nanoseconds */
+        uint64_t time[PROFILE_NB_PHASES];
+        /** The number of times each phase was entered */
+        uint64_t calls[PROFILE_NB_PHASES];
+
+    public:
+
+        PhaseProfile() {
+            clear();
+        }
+
+        /**
+         * Check whether the profiling was compiled in (make PROFILE=1)
+         * @return true if the phases are timed
+         */
+        static inline bool enabled() {
+#ifdef PENELOPE_PROFILE
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Retrieve the name of a phase
+         * @param p the phase
+         */
+        static inline const char* name(ProfilePhase p) {
+            static const char* names[PROFILE_NB_PHASES] = {
+                "solve", "propagate", "analyze", "reduceDB", "garbageCollect",
+                "importClauses", "exportClause"
+            };
+            return names[p];
+        }
+
+        /** Forget every measure */
+        inline void clear() {
+            for (int i = 0; i < PROFILE_NB_PHASES; i++) {
+                time[i] = 0;
+                calls[i] = 0;
+            }
+        }
+
+        /**
+         * Add a measure to a phase
+         * @param p the phase
+         * @param ns the time spent, in nanoseconds
+         */
+        inline void add(ProfilePhase p, uint64_t ns) {
+            time[p] += ns;
+            calls[p]++;
+        }
+
+        /**
+         * Retrieve the time spent in a phase, in seconds
+         * @param p the phase
+         */
+        inline double seconds(ProfilePhase p) const {
+            return time[p] / 1e9;
+        }
+
+        /**
+         * Retrieve the number of times a phase was entered
+         * @param p the phase
+         */
+        inline uint64_t nbCalls(ProfilePhase p) const {
+            return calls[p];
+        }
+    };
+
+    /**
+     * Measure the time between its construction and its destruction and add
+     * it to a phase of a profile
+     */
+    class ScopedPhaseTimer {
+    private:
+        PhaseProfile& profile;
+        ProfilePhase phase;
+        uint64_t start;
+
+        ScopedPhaseTimer(const ScopedPhaseTimer& other);
+        ScopedPhaseTimer& operator=(const ScopedPhaseTimer& other);
+
+    public:
+
+        ScopedPhaseTimer(PhaseProfile& prof, ProfilePhase p) :
+        profile(prof), phase(p), start(nanoTime()) {
+        }
+
+        ~ScopedPhaseTimer() {
+            profile.add(phase, nanoTime() - start);
+        }
+    };
+
+}
+
+/**
+ * Time the rest of the current scope as the given phase. Compiled to nothing
+ * unless PENELOPE_PROFILE is defined.
+ */
+#ifdef PENELOPE_PROFILE
+#define PROFILE_PHASE(profile, phase) \
+    penelope::ScopedPhaseTimer _phaseTimer(profile, phase)
+#else
+#define PROFILE_PHASE(profile, phase)
+#endif
+
+#endif	/* PROFILER_H */
@@ -32,6 +32,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 namespace penelope {
 
 static inline double cpuTime(void); // CPU-time in seconds.
+static inline uint64_t nanoTime(void); // Monotonic wall-clock time in nanoseconds.
 extern double memUsed();            // Memory in mega bytes (returns 0 for unsupported architectures).
 extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for unsupported architectures).
 
@@ -45,6 +46,8 @@ extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for
 
 static inline double penelope::cpuTime(void) { return (double)clock() / CLOCKS_PER_SEC; }
 
+static inline uint64_t penelope::nanoTime(void) { return (uint64_t)clock() * (1000000000 / CLOCKS_PER_SEC); }
+
 #else
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -55,6 +58,20 @@ static inline double penelope::cpuTime(void) {
     getrusage(RUSAGE_SELF, &ru);
     return (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1000000; }
 
+#if defined(__linux__)
+#include <time.h>
+
+static inline uint64_t penelope::nanoTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec; }
+#else
+static inline uint64_t penelope::nanoTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000; }
+#endif
+
 #endif
 
 #endif
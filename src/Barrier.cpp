@@ -0,0 +1,47 @@
+#include "penelope/utils/Barrier.h"
+
+using namespace penelope;
+
+Barrier::Barrier(int nbParticipants) : mutex(), cond(), participants(nbParticipants),
+arrived(0), generation(0) {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+Barrier::~Barrier() {
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&mutex);
+}
+
+void Barrier::release() {
+    arrived = 0;
+    generation++;
+    pthread_cond_broadcast(&cond);
+}
+
+void Barrier::wait() {
+    pthread_mutex_lock(&mutex);
+    arrived++;
+    if (arrived >= participants) {
+        release();
+    } else {
+        unsigned int current = generation;
+        while (current == generation)
+            pthread_cond_wait(&cond, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+void Barrier::leave() {
+    pthread_mutex_lock(&mutex);
+    participants--;
+    if (arrived > 0 && arrived >= participants) release();
+    pthread_mutex_unlock(&mutex);
+}
+
+void Barrier::reset(int nbParticipants) {
+    pthread_mutex_lock(&mutex);
+    participants = nbParticipants;
+    arrived = 0;
+    pthread_mutex_unlock(&mutex);
+}
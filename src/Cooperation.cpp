@@ -18,6 +18,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
  *******************************************************************************************/
 #include "penelope/core/Cooperation.h"
 #include "penelope/core/Solver.h"
+#include "penelope/core/XorEngine.h"
+
+#include <string.h>
 
 using namespace penelope;
 
@@ -26,11 +29,19 @@ Cooperation::Cooperation(int n, int l) : start(true), end(false), nbThreads(n),
         answers(NULL), extraUnits(NULL), headExtraUnits(NULL), tailExtraUnits(NULL), 
         extraClauses(NULL),
         headExtraClauses(NULL), tailExtraClauses(NULL),
-        extraClausesLBD(NULL),
+        extraClausesLBD(NULL), extraClausesTrace(NULL), traceRate(0),
+        nbTraceCandidates(NULL),
         initFreq(INITIAL_DET_FREQUENCE), deterministic_freq(NULL), 
         nbImportedExtraUnits(NULL), nbImportedExtraClauses(NULL), learntsz(NULL), 
         ctrl(' '), aimdx(AIMDX), aimdy(AIMDY), pairwiseImportedExtraClauses(NULL), 
-        deterministic_mode(false), garbage(), garbageGuardian(false, 1) {
+        deterministic_mode(0), garbage(), garbageGuardian(false, 1),
+        garbageBytes(0), memoryBudget(0), memoryUsed(NULL), memoryDetail(NULL),
+        stopped(NULL), stopGuardian(false, 1), replaced(NULL), syncBarrier(n), epochClock(n),
+        epochLength(LOGICAL_EPOCH_PROPAGATIONS), finalEpoch(NULL), epochTailUnits(NULL),
+        epochTailClauses(NULL), epochExportedUnits(NULL), epochExportedClauses(NULL), replayLogs(NULL),
+        nbLocalSearch(0), localSearchPhases(), localSearchUnsat(0), localSearchVersion(0),
+        importedPhasesVersion(NULL), solverPhases(), solverPhasesVersion(0), phasesRequested(false),
+        bestTrailPhases(), bestTrailSize(0), phaseGuardian(false, 1), nbDivide(0), guidingPaths() {
 
     solvers = new Solver [nbThreads];
     answers = new lbool [nbThreads];
@@ -74,9 +85,44 @@ Cooperation::Cooperation(int n, int l) : start(true), end(false), nbThreads(n),
     nbImportedExtraUnits = new int [nbThreads];
     pairwiseImportedExtraClauses = new int* [nbThreads];
     pairwiseLimitExportClauses = new double* [nbThreads];
+    memoryUsed = new uint64_t[nbThreads];
+    memoryDetail = new MemoryBreakdown[nbThreads];
+    stopped = new bool[nbThreads];
+    replaced = new bool[nbThreads];
+    nbTraceCandidates = new uint64_t[nbThreads];
+    finalEpoch = new int[nbThreads];
+    epochTailUnits = new int**[nbThreads];
+    epochTailClauses = new int**[nbThreads];
+    epochExportedUnits = new int*[nbThreads];
+    epochExportedClauses = new int*[nbThreads];
+    replayLogs = new ReplayLog*[nbThreads];
+    importedPhasesVersion = new uint64_t[nbThreads];
 
     for (int t = 0; t < nbThreads; t++) {
+        finalEpoch [t] = 0;
+        replayLogs [t] = NULL;
+        importedPhasesVersion [t] = 0;
+        epochTailUnits [t] = new int*[nbThreads];
+        epochTailClauses [t] = new int*[nbThreads];
+        epochExportedUnits [t] = new int[nbThreads];
+        epochExportedClauses [t] = new int[nbThreads];
+        for (int k = 0; k < nbThreads; k++) {
+            epochTailUnits[t][k] = new int[LOGICAL_EPOCH_SLOTS];
+            epochTailClauses[t][k] = new int[LOGICAL_EPOCH_SLOTS];
+            for (int e = 0; e < LOGICAL_EPOCH_SLOTS; e++) {
+                epochTailUnits[t][k][e] = 0;
+                epochTailClauses[t][k][e] = 0;
+            }
+            epochExportedUnits[t][k] = 0;
+            epochExportedClauses[t][k] = 0;
+        }
+
         learntsz [t] = 0;
+        memoryUsed [t] = 0;
+        memset(&memoryDetail[t], 0, sizeof(MemoryBreakdown));
+        stopped [t] = false;
+        replaced [t] = false;
+        nbTraceCandidates [t] = 0;
         answers [t] = l_Undef;
         deterministic_freq [t] = initFreq;
         nbImportedExtraClauses[t] = 0;
@@ -98,6 +144,38 @@ Cooperation::~Cooperation(){
     delete[](nbImportedExtraClauses);
     delete[](nbImportedExtraUnits);
     delete[](learntsz);
+    delete[](memoryUsed);
+    delete[](memoryDetail);
+    delete[](stopped);
+    delete[](replaced);
+    delete[](nbTraceCandidates);
+    delete[](finalEpoch);
+    for (int t = 0; t < nbThreads; t++) {
+        for (int k = 0; k < nbThreads; k++) {
+            delete[](epochTailUnits[t][k]);
+            delete[](epochTailClauses[t][k]);
+        }
+        delete[](epochTailUnits[t]);
+        delete[](epochTailClauses[t]);
+        delete[](epochExportedUnits[t]);
+        delete[](epochExportedClauses[t]);
+    }
+    delete[](epochTailUnits);
+    delete[](epochTailClauses);
+    delete[](epochExportedUnits);
+    delete[](epochExportedClauses);
+    for (int t = 0; t < nbThreads; t++)
+        delete replayLogs[t];
+    delete[](replayLogs);
+    delete[](importedPhasesVersion);
+    if (extraClausesTrace != NULL) {
+        for (int t = 0; t < nbThreads; t++) {
+            for (int k = 0; k < nbThreads; k++)
+                delete[](extraClausesTrace[t][k]);
+            delete[](extraClausesTrace[t]);
+        }
+        delete[](extraClausesTrace);
+    }
     for (int t = 0; t < nbThreads; t++) {
         delete[](headExtraUnits[t]);
         delete[](headExtraClauses[t]);
@@ -135,16 +213,31 @@ void Cooperation::resetSolvers(){
         delete[](garbage[i]);
     }
     garbage.shrink(garbage.size());
+    garbageBytes = 0;
+    syncBarrier.reset(nbThreads);
+    epochClock.reset();
     solvers = new Solver [nbThreads];
     answers = new lbool [nbThreads];
     for (int t = 0; t < nbThreads; t++) {
         learntsz [t] = 0;
         answers [t] = l_Undef;
+        memoryUsed [t] = 0;
+        memset(&memoryDetail[t], 0, sizeof(MemoryBreakdown));
+        stopped [t] = false;
+        replaced [t] = false;
+        nbTraceCandidates [t] = 0;
+        finalEpoch [t] = 0;
         for (int k = 0; k < nbThreads; k++) {
             headExtraUnits[t][k] = 0;
             tailExtraUnits[t][k] = 0;
             headExtraClauses[t][k] = 0;
             tailExtraClauses[t][k] = 0;
+            for (int e = 0; e < LOGICAL_EPOCH_SLOTS; e++) {
+                epochTailUnits[t][k][e] = 0;
+                epochTailClauses[t][k][e] = 0;
+            }
+            epochExportedUnits[t][k] = 0;
+            epochExportedClauses[t][k] = 0;
         }
     }
 
@@ -159,6 +252,7 @@ void Cooperation::exportExtraUnit(Solver* s, Lit unit) {
         if (t == id) continue;
         int ind = tailExtraUnits[id][t];
         if (((ind + 1) % MAX_EXTRA_UNITS) == headExtraUnits[id][t]) continue;
+        if (!underEpochBudget(&epochExportedUnits[id][t], MAX_EXTRA_UNITS)) continue;
 
         extraUnits[id][t][ind++].x = unit.x;
 
@@ -176,25 +270,30 @@ void Cooperation::importExtraUnits(Solver* s, vec<Lit>& unit_learnts) {
         if (t == id)
             continue;
 
-        int head = headExtraUnits[t][id];
-        int tail = tailExtraUnits[t][id];
-        if (head == tail)
-            continue;
+        importExtraUnits(s, t, tailExtraUnits[t][id], unit_learnts);
+    }
+}
 
-        int localEnd = tail;
-        if (tail < head) localEnd = MAX_EXTRA_UNITS;
+void Cooperation::importExtraUnits(Solver* s, int t, int tail, vec<Lit>& unit_learnts) {
 
-        for (int i = head; i < localEnd; i++)
-            storeExtraUnits(s, t, extraUnits[t][id][i], unit_learnts);
+    int id = s->threadId;
+    int head = headExtraUnits[t][id];
+    if (head == tail)
+        return;
 
-        if (tail < head)
-            for (int i = 0; i < tail; i++)
-                storeExtraUnits(s, t, extraUnits[t][id][i], unit_learnts);
+    int localEnd = tail;
+    if (tail < head) localEnd = MAX_EXTRA_UNITS;
 
-        head = tail;
-        if (head == MAX_EXTRA_UNITS) head = 0;
-        headExtraUnits[t][id] = head;
-    }
+    for (int i = head; i < localEnd; i++)
+        storeExtraUnits(s, t, extraUnits[t][id][i], unit_learnts);
+
+    if (tail < head)
+        for (int i = 0; i < tail; i++)
+            storeExtraUnits(s, t, extraUnits[t][id][i], unit_learnts);
+
+    head = tail;
+    if (head == MAX_EXTRA_UNITS) head = 0;
+    headExtraUnits[t][id] = head;
 }
 
 void Cooperation::importExtraUnits(Solver* s) {
@@ -238,6 +337,7 @@ void Cooperation::uncheckedEnqueue(Solver* s, int t, Lit l) {
 }
 
 void Cooperation::storeExtraUnits(Solver* s, int t, Lit l, vec<Lit>& unitLits) {
+    if (ReplayLog* log = recorder(s->threadId)) log->importedUnit(t, l);
     unitLits.push(l);
     nbImportedExtraUnits[s->threadId]++;
     pairwiseImportedExtraClauses[t][s->threadId]++;
@@ -246,6 +346,8 @@ void Cooperation::storeExtraUnits(Solver* s, int t, Lit l, vec<Lit>& unitLits) {
 void Cooperation::exportExtraClause(Solver* s, vec<Lit>& learnt, int lbd) {
 
     int id = s->threadId;
+    ExchangeTrace trace;
+    traceExport(s, trace);
 
     for (int t = 0; t < nbThreads; t++) {
 
@@ -255,15 +357,19 @@ void Cooperation::exportExtraClause(Solver* s, vec<Lit>& learnt, int lbd) {
         int ind = tailExtraClauses[id][t];
         if (((ind + 1) % MAX_EXTRA_CLAUSES) == headExtraClauses[id][t])
             continue;
+        if (!underEpochBudget(&epochExportedClauses[id][t], MAX_EXTRA_CLAUSES))
+            continue;
 
         //TODO: use allocator here to avoid problems and guardian
         Lit* tmp = new Lit [learnt.size() + 1];
         garbageGuardian.wait();
         garbage.push(tmp);
+        garbageBytes += sizeof(Lit) * (learnt.size() + 1);
         garbageGuardian.signal();
         extraClauses[id][t][ind] = tmp;
         extraClauses[id][t][ind][0] = mkLit(learnt.size());
         extraClausesLBD[id][t][ind] = lbd;
+        if (extraClausesTrace != NULL) extraClausesTrace[id][t][ind] = trace;
 
         for (int j = 0; j < learnt.size(); j++)
             extraClauses[id][t][ind][j + 1] = learnt[j];
@@ -282,6 +388,9 @@ void Cooperation::exportExtraClause(Solver* s, Clause& c) {
         return;
     }
 
+    ExchangeTrace trace;
+    traceExport(s, trace);
+
     for (int t = 0; t < nbThreads; t++) {
 
         //Check the size of the clause and if the thread t isn't the one
@@ -294,14 +403,18 @@ void Cooperation::exportExtraClause(Solver* s, Clause& c) {
         int ind = tailExtraClauses[id][t];
         if (((ind + 1) % MAX_EXTRA_CLAUSES) == headExtraClauses[id][t])
             continue;
+        if (!underEpochBudget(&epochExportedClauses[id][t], MAX_EXTRA_CLAUSES))
+            continue;
 
         Lit* tmp = new Lit [c.size() + 1];
         garbageGuardian.wait();
         garbage.push(tmp);
+        garbageBytes += sizeof(Lit) * (c.size() + 1);
         garbageGuardian.signal();
         extraClauses[id][t][ind] = tmp;
         extraClauses[id][t][ind][0] = mkLit(c.size());
         extraClausesLBD[id][t][ind] = c.lbd();
+        if (extraClausesTrace != NULL) extraClausesTrace[id][t][ind] = trace;
 
         for (int j = 0; j < c.size(); j++)
             extraClauses[id][t][ind][j + 1] = c[j];
@@ -315,44 +428,130 @@ void Cooperation::exportExtraClause(Solver* s, Clause& c) {
 void Cooperation::importExtraClauses(Solver* s) {
 
     int id = s->threadId;
+    if (ReplayLog* log = recorder(id)) log->checkpoint(s, deterministic_mode != 0);
 
     for (int t = 0; t < nbThreads; t++) {
 
         if (t == id)
             continue;
 
-        int head = headExtraClauses[t][id];
-        int tail = tailExtraClauses[t][id];
-        if (head == tail)
-            continue;
+        importExtraClauses(s, t, tailExtraClauses[t][id]);
+    }
+}
 
-        int localEnd = tail;
-        if (tail < head) localEnd = MAX_EXTRA_CLAUSES;
+void Cooperation::importExtraClauses(Solver* s, int t, int tail) {
 
-        for (int i = head; i < localEnd; i++)
-            addExtraClause(s, t, extraClauses[t][id][i], extraClausesLBD[t][id][i]);
+    int id = s->threadId;
+    int head = headExtraClauses[t][id];
+    if (head == tail)
+        return;
 
-        if (tail < head)
-            for (int i = 0; i < tail; i++)
-                addExtraClause(s, t, extraClauses[t][id][i], extraClausesLBD[t][id][i]);
+    int localEnd = tail;
+    if (tail < head) localEnd = MAX_EXTRA_CLAUSES;
 
-        head = tail;
-        if (head == MAX_EXTRA_CLAUSES) head = 0;
-        headExtraClauses[t][id] = head;
+    for (int i = head; i < localEnd; i++)
+        addExtraClause(s, t, extraClauses[t][id][i], extraClausesLBD[t][id][i], importTrace(t, id, i));
+
+    if (tail < head)
+        for (int i = 0; i < tail; i++)
+            addExtraClause(s, t, extraClauses[t][id][i], extraClausesLBD[t][id][i], importTrace(t, id, i));
+
+    head = tail;
+    if (head == MAX_EXTRA_CLAUSES) head = 0;
+    headExtraClauses[t][id] = head;
+}
+
+lbool Cooperation::endEpoch(Solver* s) {
+
+    int id = s->threadId;
+    int e = epochClock.epoch(id) + 1;
+
+    // remember where the exports of this epoch end, then publish it
+    for (int t = 0; t < nbThreads; t++) {
+        if (t == id) continue;
+        epochTailUnits[id][t][e % LOGICAL_EPOCH_SLOTS] = tailExtraUnits[id][t];
+        epochTailClauses[id][t][e % LOGICAL_EPOCH_SLOTS] = tailExtraClauses[id][t];
+        epochExportedUnits[id][t] = 0;
+        epochExportedClauses[id][t] = 0;
+    }
+    epochClock.publish(id, e);
+
+    // only the exports of the previous epoch are read: the others may still
+    // be working on this one
+    int previous = e - 1;
+    epochClock.waitOthers(id, previous);
+
+    // the solvers that finished before the end of the previous epoch
+    for (int t = 0; t < nbThreads; t++) {
+        if (t == id || epochClock.epoch(t) != EpochClock::FINISHED) continue;
+        if (finalEpoch[t] <= previous && answers[t] != l_Undef) return answers[t];
+    }
+
+    if (previous == 0) return l_Undef;
+    if (ReplayLog* log = recorder(id)) log->checkpoint(s, true);
+    for (int t = 0; t < nbThreads; t++) {
+        if (t == id) continue;
+        int last = previous;
+        if (epochClock.epoch(t) == EpochClock::FINISHED && finalEpoch[t] < last)
+            last = finalEpoch[t];
+        importExtraClauses(s, t, epochTailClauses[t][id][last % LOGICAL_EPOCH_SLOTS]);
+        importExtraUnits(s, t, epochTailUnits[t][id][last % LOGICAL_EPOCH_SLOTS], s->extraUnits);
+    }
+    return l_Undef;
+}
+
+void Cooperation::setReplayLog(int t, ReplayLog* log) {
+    delete replayLogs[t];
+    replayLogs[t] = log;
+}
+
+void Cooperation::finishSearch(int t) {
+    syncBarrier.leave();
+    if (deterministic_mode != 3 || epochClock.epoch(t) == EpochClock::FINISHED) return;
+
+    // the exports done since the last completed epoch are part of the final
+    // one
+    int e = epochClock.epoch(t) + 1;
+    for (int k = 0; k < nbThreads; k++) {
+        if (k == t) continue;
+        epochTailUnits[t][k][e % LOGICAL_EPOCH_SLOTS] = tailExtraUnits[t][k];
+        epochTailClauses[t][k][e % LOGICAL_EPOCH_SLOTS] = tailExtraClauses[t][k];
     }
+    finalEpoch[t] = e;
+    epochClock.finish(t);
 }
 
-void Cooperation::addExtraClause(Solver* s, int t, Lit* lt, int lbd) {
+void Cooperation::addExtraClause(Solver* s, int t, Lit* lt, int lbd, const ExchangeTrace* trace) {
 
     assert(s->threadId != t);
+    if (ReplayLog* log = recorder(s->threadId)) log->importedClause(t, lt, lbd);
     vec<Lit> extra_clause;
     int extra_backtrack_level = 0;
     int id = s->threadId;
     int size = var(lt[0]);
     int wtch = 0;
+    Lit* lits = lt + 1;
+
+    vec<Lit> strengthened;
+    if (s->strengthenImports) {
+        for (int i = 1; i < size + 1; i++) strengthened.push(lt[i]);
+        if (!s->strengthenImport(strengthened)) {
+            // satisfied at level 0: the clause is useless
+            if (trace != NULL) {
+                traceImport(s, t, *trace);
+                s->traceFate(t, TRACE_REJECTED);
+            }
+            nbImportedExtraClauses[id]++;
+            pairwiseImportedExtraClauses[t][id]++;
+            return;
+        }
+        size = strengthened.size();
+        lits = strengthened;
+        if (lbd > size) lbd = size;
+    }
 
-    for (int i = 1, j = 0; i < size + 1; i++) {
-        Lit q = lt[i];
+    for (int i = 0, j = 0; i < size; i++) {
+        Lit q = lits[i];
         if (s->value(q) == l_False && s->level(var(q)) == 0)
             continue;
         extra_clause.push(q);
@@ -365,6 +564,11 @@ void Cooperation::addExtraClause(Solver* s, int t, Lit* lt, int lbd) {
     }
 
 
+    if (trace != NULL) {
+        traceImport(s, t, *trace);
+        if (extra_clause.size() <= 1) s->traceFate(t, TRACE_UNIT);
+    }
+
     //conflict clause at level 0 --> formula is UNSAT
     if (extra_clause.size() == 0)
         setAnswer(id, l_False);
@@ -380,10 +584,15 @@ void Cooperation::addExtraClause(Solver* s, int t, Lit* lt, int lbd) {
     } else {
         // build clause from lits and add it to learnts(s) base
         CRef cr = s->addExtraClause(extra_clause, lbd);
+        if (trace != NULL && cr == CRef_Undef) s->traceFate(t, TRACE_REJECTED);
         if(cr != CRef_Undef){
             Clause& tmpClause = s->getClause(cr);
             tmpClause.setGenerator(t);
             tmpClause.lbd(lbd);
+            if (trace != NULL) {
+                tmpClause.setTraced(true);
+                if (!tmpClause.isAttached()) s->traceFate(t, TRACE_FROZEN);
+            }
             s->nbClauseImported[t]++;
 
 #ifndef FREEZE_ALL
@@ -470,6 +679,249 @@ void Cooperation::updateLimitExportClauses(Solver* s) {
     }
 }
 
+uint64_t Cooperation::exchangeMemory() const {
+    return ringsMemory() + garbageMemory();
+}
+
+uint64_t Cooperation::ringsMemory() const {
+    uint64_t rings = (uint64_t) nbThreads * nbThreads *
+            (MAX_EXTRA_UNITS * sizeof(Lit) + MAX_EXTRA_CLAUSES * (sizeof(Lit*) + sizeof(int)));
+    if (extraClausesTrace != NULL)
+        rings += (uint64_t) nbThreads * nbThreads * MAX_EXTRA_CLAUSES * sizeof(ExchangeTrace);
+    return rings;
+}
+
+uint64_t Cooperation::garbageMemory() const {
+    return atomicLoad(&garbageBytes) + garbage.capacity() * sizeof(Lit*);
+}
+
+int Cooperation::nbRunningSolvers() const {
+    int running = 0;
+    for (int t = 0; t < nbThreads; t++)
+        if (!atomicLoad(&stopped[t])) running++;
+    return running;
+}
+
+bool Cooperation::stopSolver(int t) {
+    stopGuardian.wait();
+    bool done = stopSolver_(t);
+    stopGuardian.signal();
+    return done;
+}
+
+bool Cooperation::stopSolver_(int t) {
+    if (deterministic_mode || atomicLoad(&stopped[t]))
+        return false;
+    // the local search cannot prove the unsatisfiability: another CDCL
+    // solver has to keep running
+    for (int k = 0; k < nbThreads; k++)
+        if (k != t && !isLocalSearch(k) && !atomicLoad(&stopped[k])) {
+            atomicStore(&stopped[t], true);
+            return true;
+        }
+    return false;
+}
+
+bool Cooperation::replaceSolver(int t) {
+    if (deterministic_mode || isStopped(t) || isLocalSearch(t) || isDivide(t))
+        return false;
+    atomicStore(&replaced[t], true);
+    return true;
+}
+
+void Cooperation::clearReplacement(int t) {
+    atomicStore(&replaced[t], false);
+}
+
+int Cooperation::updateLocalSearch(bool allowed) {
+    nbLocalSearch = 0;
+    for (int t = 0; t < nbThreads; t++) {
+        if (!solvers[t].localSearchWorker) continue;
+        if (!allowed) {
+            printf("c WARNING! Thread %d runs a CDCL search: the local search is not available "
+                    "in deterministic mode\n", t);
+            solvers[t].localSearchWorker = false;
+            continue;
+        }
+        nbLocalSearch++;
+    }
+    if (nbLocalSearch > 0 && nbLocalSearch == nbThreads) {
+        printf("c WARNING! Thread 0 runs a CDCL search: the local search alone cannot prove "
+                "the unsatisfiability\n");
+        solvers[0].localSearchWorker = false;
+        nbLocalSearch--;
+    }
+    return nbLocalSearch;
+}
+
+int Cooperation::updateDivide(bool allowed) {
+    nbDivide = 0;
+    for (int t = 0; t < nbThreads; t++) {
+        if (!solvers[t].divideWorker) continue;
+        if (!allowed) {
+            printf("c WARNING! Thread %d searches the whole space: the divide and conquer mode is "
+                    "only available in the non deterministic mode\n", t);
+            solvers[t].divideWorker = false;
+            continue;
+        }
+        nbDivide++;
+    }
+    guidingPaths.setWorkers(nbDivide);
+    return nbDivide;
+}
+
+void Cooperation::exchangePhases(Solver* s) {
+    if (atomicLoad(&phasesRequested)) {
+        phaseGuardian.wait();
+        if (phasesRequested) {
+            s->getPolarities(solverPhases);
+            solverPhasesVersion++;
+            phasesRequested = false;
+        }
+        phaseGuardian.signal();
+    }
+
+    if (!s->useLocalSearchPhases) return;
+    if (atomicLoad(&localSearchVersion) == importedPhasesVersion[s->threadId]) return;
+    phaseGuardian.wait();
+    s->setPolarities(localSearchPhases);
+    importedPhasesVersion[s->threadId] = localSearchVersion;
+    phaseGuardian.signal();
+}
+
+void Cooperation::publishLocalSearchPhases(const vec<char>& phases, int nbUnsat) {
+    phaseGuardian.wait();
+    if (localSearchVersion == 0 || nbUnsat < localSearchUnsat) {
+        phases.copyTo(localSearchPhases);
+        localSearchUnsat = nbUnsat;
+        atomicStore(&localSearchVersion, localSearchVersion + 1);
+    }
+    phaseGuardian.signal();
+}
+
+void Cooperation::publishBestTrail(Solver* s) {
+    if (s->getBestTrail() <= atomicLoad(&bestTrailSize)) return;
+    phaseGuardian.wait();
+    if (s->getBestTrail() > bestTrailSize) {
+        s->getBestPolarities(bestTrailPhases);
+        atomicStore(&bestTrailSize, s->getBestTrail());
+    }
+    phaseGuardian.signal();
+}
+
+bool Cooperation::fetchBestTrail(vec<char>& phases) {
+    if (atomicLoad(&bestTrailSize) == 0) return false;
+    phaseGuardian.wait();
+    bestTrailPhases.copyTo(phases);
+    phaseGuardian.signal();
+    return true;
+}
+
+bool Cooperation::fetchSolverPhases(vec<char>& phases, uint64_t& version) {
+    bool fresh = false;
+    phaseGuardian.wait();
+    if (solverPhasesVersion != version) {
+        solverPhases.copyTo(phases);
+        version = solverPhasesVersion;
+        fresh = true;
+    }
+    atomicStore(&phasesRequested, true);
+    phaseGuardian.signal();
+    return fresh;
+}
+
+void Cooperation::publishMemory(Solver* s) {
+    MemoryBreakdown mem;
+    s->memoryBreakdown(mem);
+    MemoryBreakdown& detail = memoryDetail[s->threadId];
+    atomicStore(&detail.arenaLive, mem.arenaLive);
+    atomicStore(&detail.arenaWasted, mem.arenaWasted);
+    atomicStore(&detail.watches, mem.watches);
+    atomicStore(&detail.clauseLists, mem.clauseLists);
+    atomicStore(&detail.trail, mem.trail);
+    atomicStore(&detail.varData, mem.varData);
+    atomicStore(&memoryUsed[s->threadId], mem.total());
+}
+
+void Cooperation::updateMemoryUsage(Solver* s) {
+
+    publishMemory(s);
+    if (ReplayLog* log = replayer(s->threadId)) {
+        // the pressure of the recorded portfolio is applied and released at
+        // the same points
+        int level = log->replayPressure(s);
+        if (level > 0) s->applyMemoryPressure();
+        else if (level == 0) s->releaseMemoryPressure();
+        return;
+    }
+    if (memoryBudget == 0) return;
+
+    // The stopped solvers are about to give back their learnt clauses, they
+    // are not taken into account to avoid stopping several solvers at once
+    uint64_t total = exchangeMemory();
+    for (int t = 0; t < nbThreads; t++)
+        if (!atomicLoad(&stopped[t])) total += atomicLoad(&memoryUsed[t]);
+
+    if (total < MEMORY_PRESSURE_TIGHTEN * memoryBudget) {
+        if (s->releaseMemoryPressure())
+            if (ReplayLog* log = recorder(s->threadId)) log->pressure(s, 0);
+        return;
+    }
+
+    // Every solver applies the restrictions on its own state
+    int level = total < MEMORY_PRESSURE_STOP * memoryBudget ? 1 : 2;
+    s->applyMemoryPressure();
+    if (ReplayLog* log = recorder(s->threadId)) log->pressure(s, level);
+
+    if (level < 2) return;
+
+    // Stop the running CDCL solver whose clauses were the least used by the
+    // others, the biggest one in case of a tie. The local search exports
+    // nothing: it would always be the least used. The choice and the stop are
+    // done under the same lock: the other threads may be choosing too.
+    stopGuardian.wait();
+    int weakest = -1;
+    uint64_t weakestUsage = 0, weakestMemory = 0;
+    for (int t = 0; t < nbThreads; t++) {
+        if (atomicLoad(&stopped[t]) || isLocalSearch(t)) continue;
+        uint64_t usage = 0, used = atomicLoad(&memoryUsed[t]);
+        for (int k = 0; k < nbThreads; k++)
+            if (k != t) usage += atomicLoad(&solvers[k].nbClauseUsed[t]);
+        if (weakest < 0 || usage < weakestUsage || (usage == weakestUsage && used > weakestMemory)) {
+            weakest = t;
+            weakestUsage = usage;
+            weakestMemory = used;
+        }
+    }
+    bool done = weakest >= 0 && stopSolver_(weakest);
+    stopGuardian.signal();
+    if (done && s->verbosity > 0)
+        printf("c memory governor: solver %d stopped (%.2f MB used of %.2f MB)\n", weakest,
+            total / (1024.0 * 1024.0), memoryBudget / (1024.0 * 1024.0));
+}
+
+void Cooperation::snapshot(int t, SolverSnapshot& snap) const {
+    solvers[t].snapshot(snap);
+    snap.importedUnits = atomicLoad(&nbImportedExtraUnits[t]);
+    snap.importedClauses = atomicLoad(&nbImportedExtraClauses[t]);
+    snap.pendingUnits = 0;
+    snap.pendingClauses = 0;
+    for (int k = 0; k < nbThreads; k++) {
+        if (k == t) continue;
+        snap.pendingUnits += (atomicLoad(&tailExtraUnits[k][t]) - atomicLoad(&headExtraUnits[k][t])
+                + MAX_EXTRA_UNITS) % MAX_EXTRA_UNITS;
+        snap.pendingClauses += (atomicLoad(&tailExtraClauses[k][t]) - atomicLoad(&headExtraClauses[k][t])
+                + MAX_EXTRA_CLAUSES) % MAX_EXTRA_CLAUSES;
+    }
+    const MemoryBreakdown& detail = memoryDetail[t];
+    snap.memory.arenaLive = atomicLoad(&detail.arenaLive);
+    snap.memory.arenaWasted = atomicLoad(&detail.arenaWasted);
+    snap.memory.watches = atomicLoad(&detail.watches);
+    snap.memory.clauseLists = atomicLoad(&detail.clauseLists);
+    snap.memory.trail = atomicLoad(&detail.trail);
+    snap.memory.varData = atomicLoad(&detail.varData);
+}
+
 void Cooperation::printStats(int& id) {
 
     uint64_t nbSharedExtraClauses = 0;
@@ -486,7 +938,7 @@ void Cooperation::printStats(int& id) {
 
     printf("c  -----------------------------------------------------------------------------------------------------------------------\n");
     printf("c | Penelope - all threads statistics                DETERMINISTIC MODE ? %s            initial limit export clauses : %3d |\n",
-            deterministic_mode == true ? "Y" : "N",
+            deterministic_mode != 0 ? "Y" : "N",
             limitExportClauses);
     printf("c |--------------------------------------------------------------------------------------------------------------------------------------------|\n");
     printf("c |  Thread  | winner  |   #restarts   |   decisions   |  #conflicts   |   %% shared cls  |  #extra units | #extra clauses | #not used directly | \n");
@@ -531,9 +983,23 @@ void Cooperation::printStats(int& id) {
         printf("%4.2f%% (%7ld/%7ld), deleted not used: %4.2f%% (%7d/%7ld) \n", (100.0 * totUsed) / totImported, totUsed, totImported, (100.0 * solvers[i].getNbImportedDeletedNotUsed() / totImported), solvers[i].getNbImportedDeletedNotUsed(), totImported);
         printf("c nb clauses never attached: %4.2f%% (%7d/%7ld)\n", (100.0 * solvers[i].nbClausesNeverAttached) / totImported, solvers[i].nbClausesNeverAttached, totImported);
         printf("c nb exported but not learnt: %7d\n", solvers[i].nbClausesNotLearnt);
+        if (solvers[i].vivifyBudget > 0)
+            printf("c vivification: %7d clauses shortened, %7d literals removed, %7d exported\n",
+                solvers[i].nbVivified, solvers[i].nbVivifiedLits, solvers[i].nbVivifiedExported);
+        if (solvers[i].strengthenImports)
+            printf("c strengthened imports: %7d clauses shortened, %7d literals removed\n",
+                solvers[i].nbImportsStrengthened, solvers[i].nbImportLitsRemoved);
+        if (const XorEngine* xors = solvers[i].getXorEngine())
+            printf("c xor: %7d constraints%s, %7ld eliminated, %7ld conflicts\n",
+                xors->nbXors(), xors->hasGauss() ? "" : " (no elimination)",
+                xors->nbEliminated(), xors->nbConflicts());
     }
     printf("c global usage of imported clauses: %4.2f%% (%7ld/%7ld)\n", (100.0 * globUsed) / globImported, globUsed, globImported);
 
+    if (memoryBudget != 0)
+        printf("c memory governor: budget %.2f MB, %d/%d solvers still running\n",
+            memoryBudget / (1024.0 * 1024.0), nbRunningSolvers(), nbThreads);
+
     printf("c Import usage matrix:\n");
     for(int i=0; i<nbThreads; i++){
         printf("c matrix | ");
@@ -548,10 +1014,142 @@ void Cooperation::printStats(int& id) {
         printf("\n");
     }
 
+    printTrace();
+
+    printProfile();
+
+    printCounters();
+
+    printMemory();
+
     Parallel_Info();
 
 }
 
+void Cooperation::setTraceRate(int rate) {
+    traceRate = rate;
+    if (traceRate <= 0 || extraClausesTrace != NULL) return;
+
+    extraClausesTrace = new ExchangeTrace**[nbThreads];
+    for (int t = 0; t < nbThreads; t++) {
+        extraClausesTrace[t] = new ExchangeTrace*[nbThreads];
+        for (int k = 0; k < nbThreads; k++) {
+            extraClausesTrace[t][k] = new ExchangeTrace[MAX_EXTRA_CLAUSES];
+            for (int i = 0; i < MAX_EXTRA_CLAUSES; i++)
+                extraClausesTrace[t][k][i].time = 0;
+        }
+    }
+}
+
+void Cooperation::traceImport(Solver* s, int t, const ExchangeTrace& trace) {
+    uint64_t us = (nanoTime() - trace.time) / 1000;
+    int b = 0;
+    while (b < TRACE_LATENCY_BUCKETS - 1 && (us >> b) != 0) b++;
+    s->traceLatency[t * TRACE_LATENCY_BUCKETS + b]++;
+    s->traceConflictLag[t] += atomicLoad(&solvers[t].conflicts) - trace.conflicts;
+    s->traceFate(t, TRACE_IMPORTED);
+}
+
+void Cooperation::printTrace() {
+
+    if (traceRate <= 0) return;
+
+    printf("c Traced clauses (1 out of %d exported clauses):\n", traceRate);
+    printf("c trace | from -> to | imported |     unit | rejected |     used | never att. | del. unused |  freezes | conflict lag | median latency\n");
+    for (int c = 0; c < nbThreads; c++) {
+        for (int p = 0; p < nbThreads; p++) {
+            if (p == c) continue;
+            const uint64_t* fates = &solvers[c].traceFates[p * TRACE_NB_FATES];
+            const uint64_t* latency = &solvers[c].traceLatency[p * TRACE_LATENCY_BUCKETS];
+            uint64_t imported = fates[TRACE_IMPORTED];
+            if (imported == 0) continue;
+
+            int median = 0;
+            uint64_t cumulated = 0;
+            while (median < TRACE_LATENCY_BUCKETS - 1 && (cumulated += latency[median]) * 2 < imported)
+                median++;
+
+            printf("c trace | %4d -> %-2d | %8lu | %8lu | %8lu | %8lu | %10lu | %11lu | %8lu | %12.1f | < %lu us\n",
+                p, c, imported, fates[TRACE_UNIT], fates[TRACE_REJECTED], fates[TRACE_USED],
+                fates[TRACE_NEVER_ATTACHED], fates[TRACE_DELETED_UNUSED], fates[TRACE_FROZEN],
+                (double) solvers[c].traceConflictLag[p] / imported, (uint64_t) 1 << median);
+            printf("c latency | %4d -> %-2d |", p, c);
+            for (int b = 0; b < TRACE_LATENCY_BUCKETS; b++)
+                printf(" %lu", latency[b]);
+            printf("\n");
+        }
+    }
+}
+
+void Cooperation::printProfile() {
+
+    if (!PhaseProfile::enabled()) return;
+
+    printf("c Time spent in each phase (seconds, %% of solve):\n");
+    printf("c profile | thread |");
+    for (int p = 0; p < PROFILE_NB_PHASES; p++)
+        printf(" %22s |", PhaseProfile::name((ProfilePhase) p));
+    printf("\n");
+    for (int t = 0; t < nbThreads; t++) {
+        const PhaseProfile& prof = solvers[t].getProfile();
+        double solve = prof.seconds(PROFILE_SOLVE);
+        printf("c profile | %6d |", t);
+        for (int p = 0; p < PROFILE_NB_PHASES; p++)
+            printf(" %12.3f (%6.2f%%) |", prof.seconds((ProfilePhase) p),
+                solve == 0 ? 0.0 : 100.0 * prof.seconds((ProfilePhase) p) / solve);
+        printf("\n");
+    }
+}
+
+void Cooperation::printCounters() {
+
+    bool measured = false;
+    for (int t = 0; t < nbThreads && !measured; t++)
+        measured = solvers[t].getCounters().isOpen();
+    if (!measured) return;
+
+    printf("c Hardware counters per million propagations (n/a = not available):\n");
+    printf("c counters | thread |    phase |");
+    for (int c = 0; c < PerfCounters::PERF_NB_COUNTERS; c++)
+        printf(" %14s |", PerfCounters::name((PerfCounters::Counter) c));
+    printf("    IPC\n");
+    for (int t = 0; t < nbThreads; t++) {
+        const PhaseCounters& counters = solvers[t].getCounters();
+        if (!counters.isOpen()) continue;
+        double mprops = solvers[t].propagations / 1e6;
+        for (int p = 0; p < COUNTERS_NB_PHASES; p++) {
+            printf("c counters | %6d | %8s |", t, PhaseCounters::name((CounterPhase) p));
+            for (int c = 0; c < PerfCounters::PERF_NB_COUNTERS; c++) {
+                PerfCounters::Counter counter = (PerfCounters::Counter) c;
+                if (!counters.available(counter)) printf(" %14s |", "n/a");
+                else printf(" %14.0f |", mprops == 0 ? 0.0 : counters.value((CounterPhase) p, counter) / mprops);
+            }
+            uint64_t cycles = counters.value((CounterPhase) p, PerfCounters::PERF_CYCLES);
+            if (cycles == 0) printf("    n/a\n");
+            else printf(" %6.2f\n", (double) counters.value((CounterPhase) p, PerfCounters::PERF_INSTRUCTIONS) / cycles);
+        }
+    }
+}
+
+void Cooperation::printMemory() {
+
+    const double MB = 1024.0 * 1024.0;
+    uint64_t total = 0;
+    printf("c Memory usage (MB):\n");
+    printf("c memory | thread | arena live | arena wasted |    watches | clause lists |      trail |   var data |      total\n");
+    for (int t = 0; t < nbThreads; t++) {
+        MemoryBreakdown mem;
+        solvers[t].memoryBreakdown(mem);
+        total += mem.total();
+        printf("c memory | %6d | %10.2f | %12.2f | %10.2f | %12.2f | %10.2f | %10.2f | %10.2f\n",
+            t, mem.arenaLive / MB, mem.arenaWasted / MB, mem.watches / MB, mem.clauseLists / MB,
+            mem.trail / MB, mem.varData / MB, mem.total() / MB);
+    }
+    total += exchangeMemory();
+    printf("c memory | exchange rings: %.2f, exported clauses: %.2f, accounted: %.2f, process peak: %.2f\n",
+        ringsMemory() / MB, garbageMemory() / MB, total / MB, memUsedPeak());
+}
+
 void Cooperation::printExMatrix() {
 
     printf("\nc  Final Matrix extra shared clauses limit size \n");
@@ -569,7 +1167,7 @@ void Cooperation::printExMatrix() {
 }
 
 void Cooperation::Parallel_Info() {
-    printf("c  DETERMINISTIC_MODE? : %s \n", (deterministic_mode == true ? "YES" : "NO"));
+    printf("c  DETERMINISTIC_MODE? : %s \n", (deterministic_mode != 0 ? "YES" : "NO"));
     printf("c  CONTROL POLICY?	 : %s  \n", (ctrl != 0 ? (ctrl == 1 ? "DYNAMIC (INCREMENTAL  en= +- 1)" : "DYNAMIC (AIMD: en=  en - a x en, en + b/en)") : "STATIC (fixed Limit Export Clauses)"));
     if (ctrl == 0)
         printf("c  LIMIT EXPORT CLAUSES (PAIRWISE) : [identity] x %d\n\n", limitExportClauses);
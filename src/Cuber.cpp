@@ -0,0 +1,262 @@
+#include "penelope/core/Cuber.h"
+#include "penelope/utils/Sort.h"
+
+#include <math.h>
+
+using namespace penelope;
+
+/**
+ * Order the variables by decreasing score
+ */
+struct ScoreGt {
+    const vec<double>& scores;
+
+    ScoreGt(const vec<double>& s) : scores(s) {
+    }
+
+    bool operator()(Var a, Var b) const {
+        return scores[a] > scores[b];
+    }
+};
+
+Cuber::Cuber(Solver& s) : solver(s), lits(), clauseStart(), occurrences(), occurrenceStart(), order(),
+assigns(), nbTrue(), nbFalse(), trail(), qhead(0), reduced(0), cubeLits(), cubeStart(),
+interrupted(false), units(), cubes(0), refuted(0), failed(0) {
+}
+
+bool Cuber::load() {
+    if (!solver.okay()) return false;
+    int nbLits = 2 * solver.nVars();
+    vec<int> counts(nbLits, 0);
+    vec<double> weights(nbLits, 0);
+
+    for (int i = 0; i < solver.nClauses(); i++) {
+        const Clause& c = solver.getClause(solver.getOriginalClause(i));
+        bool satisfied = false;
+        int size = 0;
+        for (int k = 0; k < c.size() && !satisfied; k++) {
+            satisfied = solver.value(c[k]) == l_True;
+            if (solver.value(c[k]) == l_Undef) size++;
+        }
+        if (satisfied) continue;
+        if (size == 0) return false;
+
+        clauseStart.push(lits.size());
+        for (int k = 0; k < c.size(); k++) {
+            if (solver.value(c[k]) == l_False) continue;
+            lits.push(c[k]);
+            counts[toInt(c[k])]++;
+            weights[toInt(c[k])] += ldexp(1.0, 2 - size);
+        }
+    }
+    clauseStart.push(lits.size());
+    int nbClauses = clauseStart.size() - 1;
+
+    // the occurrence lists are stored one after the other
+    occurrenceStart.growTo(nbLits + 1);
+    occurrenceStart[0] = 0;
+    for (int l = 0; l < nbLits; l++) occurrenceStart[l + 1] = occurrenceStart[l] + counts[l];
+    occurrences.growTo(lits.size());
+    for (int c = 0; c < nbClauses; c++)
+        for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            int l = toInt(lits[i]);
+            occurrences[occurrenceStart[l + 1] - counts[l]--] = c;
+        }
+
+    // the variables occurring often with both polarities come first
+    vec<double> scores(solver.nVars(), 0);
+    for (Var v = 0; v < solver.nVars(); v++) {
+        double pos = weights[toInt(mkLit(v))], neg = weights[toInt(~mkLit(v))];
+        scores[v] = 1024 * pos * neg + pos + neg;
+        if (solver.value(v) == l_Undef && pos + neg > 0) order.push(v);
+    }
+    sort(order, ScoreGt(scores));
+
+    // the variables assigned at level 0 do not occur anymore
+    assigns.growTo(solver.nVars(), l_Undef);
+    for (Var v = 0; v < solver.nVars(); v++) assigns[v] = solver.value(v);
+    nbTrue.growTo(nbClauses, 0);
+    nbFalse.growTo(nbClauses, 0);
+
+    // a unit clause of the solver may not be propagated yet
+    for (int c = 0; c < nbClauses; c++)
+        if (clauseStart[c + 1] - clauseStart[c] == 1 && value(lits[clauseStart[c]]) == l_Undef)
+            assign(lits[clauseStart[c]]);
+    return propagate();
+}
+
+void Cuber::assign(Lit l) {
+    assigns[var(l)] = lbool(!sign(l));
+    trail.push(l);
+}
+
+bool Cuber::propagate() {
+    while (qhead < trail.size()) {
+        Lit p = trail[qhead++];
+        int l = toInt(p);
+        for (int i = occurrenceStart[l]; i < occurrenceStart[l + 1]; i++) nbTrue[occurrences[i]]++;
+
+        // the counters are updated for every clause, even after a conflict,
+        // so that undo restores them
+        bool conflict = false;
+        l = toInt(~p);
+        for (int i = occurrenceStart[l]; i < occurrenceStart[l + 1]; i++) {
+            int c = occurrences[i];
+            nbFalse[c]++;
+            if (conflict || nbTrue[c] > 0) continue;
+            int free = clauseStart[c + 1] - clauseStart[c] - nbFalse[c];
+            if (free >= 2) {
+                reduced += ldexp(1.0, 2 - free);
+                continue;
+            }
+
+            // the literals assigned but not propagated yet decide
+            Lit unit = lit_Undef;
+            bool satisfied = false;
+            for (int k = clauseStart[c]; k < clauseStart[c + 1] && !satisfied; k++) {
+                lbool v = value(lits[k]);
+                if (v == l_True) satisfied = true;
+                else if (v == l_Undef) unit = lits[k];
+            }
+            if (satisfied) continue;
+            if (unit == lit_Undef) conflict = true;
+            else assign(unit);
+        }
+        if (conflict) return false;
+    }
+    return true;
+}
+
+void Cuber::undo(int size) {
+    for (int i = trail.size() - 1; i >= size; i--) {
+        Lit p = trail[i];
+        if (i < qhead) {
+            int l = toInt(p);
+            for (int k = occurrenceStart[l]; k < occurrenceStart[l + 1]; k++) nbTrue[occurrences[k]]--;
+            l = toInt(~p);
+            for (int k = occurrenceStart[l]; k < occurrenceStart[l + 1]; k++) nbFalse[occurrences[k]]--;
+        }
+        assigns[var(p)] = l_Undef;
+    }
+    trail.shrink(trail.size() - size);
+    if (qhead > size) qhead = size;
+}
+
+bool Cuber::lookahead(Lit l, double& score) {
+    int size = trail.size();
+    reduced = 0;
+    assign(l);
+    bool ok = propagate();
+    score = reduced;
+    undo(size);
+    return ok;
+}
+
+bool Cuber::select(vec<Lit>& cube, Var& best) {
+    best = var_Undef;
+    double bestScore = -1;
+    int looked = 0;
+    for (int i = 0; i < order.size() && looked < CUBER_CANDIDATES; i++) {
+        Var v = order[i];
+        if (assigns[v] != l_Undef) continue;
+        looked++;
+
+        double pos, neg;
+        bool okPos = lookahead(mkLit(v), pos);
+        bool okNeg = lookahead(~mkLit(v), neg);
+        if (okPos && okNeg) {
+            double score = 1024 * pos * neg + pos + neg;
+            if (score > bestScore) {
+                best = v;
+                bestScore = score;
+            }
+            continue;
+        }
+
+        // a failed literal: its negation holds at this node
+        failed++;
+        if (!okPos && !okNeg) return false;
+        Lit implied = okPos ? mkLit(v) : ~mkLit(v);
+        assign(implied);
+        cube.push(implied);
+        if (!propagate()) return false;
+        if (best != var_Undef && assigns[best] != l_Undef) {
+            best = var_Undef;
+            bestScore = -1;
+        }
+    }
+    return true;
+}
+
+void Cuber::emit(const vec<Lit>& cube) {
+    cubeStart.push(cubeLits.size());
+    for (int i = 0; i < cube.size(); i++) cubeLits.push(cube[i]);
+    cubes++;
+}
+
+void Cuber::split(vec<Lit>& cube, int depth) {
+    if (solver.asynch_interrupt) {
+        interrupted = true;
+        return;
+    }
+    int trailSize = trail.size();
+    int cubeSize = cube.size();
+    Var v;
+    if (!select(cube, v))
+        refuted++;
+    else if (depth == 0 || v == var_Undef)
+        emit(cube);
+    else
+        branch(cube, v, depth);
+    undo(trailSize);
+    cube.shrink(cube.size() - cubeSize);
+}
+
+void Cuber::branch(vec<Lit>& cube, Var v, int depth) {
+    double pos, neg;
+    lookahead(mkLit(v), pos);
+    lookahead(~mkLit(v), neg);
+    Lit first = pos <= neg ? mkLit(v) : ~mkLit(v);
+
+    for (int b = 0; b < 2 && !interrupted; b++) {
+        Lit l = b == 0 ? first : ~first;
+        int size = trail.size();
+        assign(l);
+        cube.push(l);
+        if (propagate())
+            split(cube, depth - 1);
+        else
+            refuted++;
+        undo(size);
+        cube.pop();
+    }
+}
+
+lbool Cuber::generate(int nbCubes, GuidingPaths& paths) {
+    if (!load()) return l_False;
+    int depth = 0;
+    while ((1 << depth) < nbCubes && depth < 30) depth++;
+
+    // the failed literals of the root hold for the whole formula
+    vec<Lit> cube;
+    Var v;
+    if (!select(cube, v)) return l_False;
+    cube.copyTo(units);
+    if (depth == 0 || v == var_Undef)
+        emit(cube);
+    else
+        branch(cube, v, depth);
+
+    // an incomplete tree does not cover the whole space
+    if (interrupted) return l_Undef;
+    if (cubes == 0) return l_False;
+    paths.clear();
+    vec<Lit> path;
+    for (int c = 0; c < cubes; c++) {
+        int end = c + 1 < cubes ? cubeStart[c + 1] : cubeLits.size();
+        path.clear();
+        for (int i = cubeStart[c]; i < end; i++) path.push(cubeLits[i]);
+        paths.push(path);
+    }
+    return l_Undef;
+}
@@ -0,0 +1,55 @@
+#include "penelope/utils/EpochClock.h"
+#include "penelope/utils/Atomic.h"
+
+#include <limits.h>
+
+using namespace penelope;
+
+const int EpochClock::FINISHED = INT_MAX;
+
+EpochClock::EpochClock(int n) : nbThreads(n), epochs(NULL), mutex(), advanced() {
+    epochs = new int[nbThreads];
+    for (int t = 0; t < nbThreads; t++) epochs[t] = 0;
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&advanced, NULL);
+}
+
+EpochClock::~EpochClock() {
+    pthread_cond_destroy(&advanced);
+    pthread_mutex_destroy(&mutex);
+    delete[](epochs);
+}
+
+void EpochClock::publish(int t, int e) {
+    atomicStoreRelease(&epochs[t], e);
+    pthread_mutex_lock(&mutex);
+    pthread_cond_broadcast(&advanced);
+    pthread_mutex_unlock(&mutex);
+}
+
+void EpochClock::finish(int t) {
+    publish(t, FINISHED);
+}
+
+int EpochClock::epoch(int t) const {
+    return atomicLoadAcquire(&epochs[t]);
+}
+
+bool EpochClock::othersReached(int t, int e) const {
+    for (int k = 0; k < nbThreads; k++)
+        if (k != t && atomicLoadAcquire(&epochs[k]) < e) return false;
+    return true;
+}
+
+void EpochClock::waitOthers(int t, int e) {
+    // most of the time, the others are already there
+    if (othersReached(t, e)) return;
+    pthread_mutex_lock(&mutex);
+    while (!othersReached(t, e))
+        pthread_cond_wait(&advanced, &mutex);
+    pthread_mutex_unlock(&mutex);
+}
+
+void EpochClock::reset() {
+    for (int t = 0; t < nbThreads; t++) atomicStore(&epochs[t], 0);
+}
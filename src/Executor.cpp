@@ -0,0 +1,76 @@
+#include "penelope/utils/Executor.h"
+
+#include <unistd.h>
+
+using namespace penelope;
+
+ThreadPoolExecutor::ThreadPoolExecutor(int nbWorkers) : nbThreads(nbWorkers), workers(NULL),
+mutex(), taskReady(), taskDone(), task(NULL), generation(0), running(0), stopping(false) {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&taskReady, NULL);
+    pthread_cond_init(&taskDone, NULL);
+    workers = new Worker[nbThreads];
+    for (int i = 0; i < nbThreads; i++) {
+        workers[i].pool = this;
+        workers[i].id = i;
+        pthread_create(&workers[i].thread, NULL, &ThreadPoolExecutor::work, &workers[i]);
+    }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor() {
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&taskReady);
+    pthread_mutex_unlock(&mutex);
+    for (int i = 0; i < nbThreads; i++)
+        pthread_join(workers[i].thread, NULL);
+    delete[](workers);
+    pthread_cond_destroy(&taskDone);
+    pthread_cond_destroy(&taskReady);
+    pthread_mutex_destroy(&mutex);
+}
+
+void ThreadPoolExecutor::run(Task& t) {
+    pthread_mutex_lock(&mutex);
+    task = &t;
+    running = nbThreads;
+    generation++;
+    pthread_cond_broadcast(&taskReady);
+    while (running > 0)
+        pthread_cond_wait(&taskDone, &mutex);
+    task = NULL;
+    pthread_mutex_unlock(&mutex);
+}
+
+void* ThreadPoolExecutor::work(void* data) {
+    Worker* worker = static_cast<Worker*> (data);
+    ThreadPoolExecutor* pool = worker->pool;
+    unsigned int done = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        while (!pool->stopping && pool->generation == done)
+            pthread_cond_wait(&pool->taskReady, &pool->mutex);
+        if (pool->stopping) {
+            pthread_mutex_unlock(&pool->mutex);
+            return NULL;
+        }
+        done = pool->generation;
+        Task* current = pool->task;
+        pthread_mutex_unlock(&pool->mutex);
+
+        current->execute(worker->id);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->running == 0) pthread_cond_signal(&pool->taskDone);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+int penelope::nbProcessors() {
+#ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n < 1 ? 1 : (int) n;
+#else
+    return 1;
+#endif
+}
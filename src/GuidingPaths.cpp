@@ -0,0 +1,150 @@
+#include "penelope/core/GuidingPaths.h"
+#include "penelope/utils/Atomic.h"
+
+#include <time.h>
+
+using namespace penelope;
+
+GuidingPaths::GuidingPaths() : mutex(), available(), paths(1), workers(0), busy(0), missing(0),
+done(false), splits(0), refuted(0), pruned(0) {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&available, NULL);
+}
+
+GuidingPaths::~GuidingPaths() {
+    pthread_cond_destroy(&available);
+    pthread_mutex_destroy(&mutex);
+}
+
+void GuidingPaths::update() {
+    atomicStore(&missing, workers - busy - (int) paths.size());
+}
+
+void GuidingPaths::setWorkers(int nbWorkers) {
+    pthread_mutex_lock(&mutex);
+    workers = nbWorkers;
+    update();
+    pthread_mutex_unlock(&mutex);
+}
+
+void GuidingPaths::clear() {
+    pthread_mutex_lock(&mutex);
+    paths.clear();
+    update();
+    pthread_mutex_unlock(&mutex);
+}
+
+void GuidingPaths::append(const vec<Lit>& path) {
+    paths.push_back(std::vector<Lit>(path.size()));
+    for (int i = 0; i < path.size(); i++) paths.back()[i] = path[i];
+    update();
+    pthread_cond_broadcast(&available);
+}
+
+void GuidingPaths::push(const vec<Lit>& path) {
+    pthread_mutex_lock(&mutex);
+    append(path);
+    pthread_mutex_unlock(&mutex);
+}
+
+GuidingPaths::Status GuidingPaths::take(vec<Lit>& path) {
+    pthread_mutex_lock(&mutex);
+    if (paths.empty() && !done) {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += GUIDING_PATH_WAIT * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (paths.empty() && !done)
+            if (pthread_cond_timedwait(&available, &mutex, &deadline) != 0) break;
+    }
+
+    Status status = done ? PATH_EXHAUSTED : PATH_NONE;
+    if (!done && !paths.empty()) {
+        const std::vector<Lit>& first = paths.front();
+        path.clear();
+        for (unsigned int i = 0; i < first.size(); i++) path.push(first[i]);
+        paths.pop_front();
+        busy++;
+        update();
+        status = PATH_TAKEN;
+    }
+    pthread_mutex_unlock(&mutex);
+    return status;
+}
+
+void GuidingPaths::split(const vec<Lit>& path) {
+    pthread_mutex_lock(&mutex);
+    splits++;
+    append(path);
+    pthread_mutex_unlock(&mutex);
+}
+
+int GuidingPaths::refute(const vec<Lit>& conflict) {
+    pthread_mutex_lock(&mutex);
+    busy--;
+    refuted++;
+
+    // a queued path containing the negation of every literal of the
+    // conflict is refuted as well
+    int removed = 0;
+    for (std::deque<std::vector<Lit> >::iterator it = paths.begin(); it != paths.end();) {
+        bool covered = true;
+        for (int i = 0; i < conflict.size() && covered; i++) {
+            covered = false;
+            for (unsigned int j = 0; j < it->size() && !covered; j++)
+                covered = (*it)[j] == ~conflict[i];
+        }
+        if (covered) {
+            it = paths.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    pruned += removed;
+
+    if (paths.empty() && busy == 0) {
+        done = true;
+        pthread_cond_broadcast(&available);
+    }
+    update();
+    pthread_mutex_unlock(&mutex);
+    return removed;
+}
+
+void GuidingPaths::release(const vec<Lit>& path) {
+    pthread_mutex_lock(&mutex);
+    busy--;
+    append(path);
+    pthread_mutex_unlock(&mutex);
+}
+
+bool GuidingPaths::wanted() const {
+    return atomicLoad(&missing) > 0;
+}
+
+bool GuidingPaths::exhausted() const {
+    return atomicLoad(&done);
+}
+
+int GuidingPaths::nbQueued() const {
+    pthread_mutex_lock(&mutex);
+    int n = (int) paths.size();
+    pthread_mutex_unlock(&mutex);
+    return n;
+}
+
+int GuidingPaths::nbSplits() const {
+    return atomicLoad(&splits);
+}
+
+int GuidingPaths::nbRefuted() const {
+    return atomicLoad(&refuted);
+}
+
+int GuidingPaths::nbPruned() const {
+    return atomicLoad(&pruned);
+}
@@ -103,3 +103,24 @@ const std::string& INIParser::getValueForConf(const std::string& conf, const std
     return emptyString;
     
 }
+
+void INIParser::setValueForConf(const std::string& conf, const std::string& key, const std::string& value){
+    values[conf][key]=value;
+}
+
+void INIParser::copyConfiguration(const std::string& from, const std::string& to){
+    std::map<std::string, std::map<std::string, std::string> >::const_iterator it(values.find(from));
+    if(it==values.end()){
+        values[to];
+        return;
+    }
+    std::map<std::string, std::string> tmp(it->second);
+    values[to]=tmp;
+}
+
+void INIParser::getConfigurations(std::vector<std::string>& confs) const{
+    std::map<std::string, std::map<std::string, std::string> >::const_iterator it;
+    for(it=values.begin(); it!=values.end(); ++it){
+        confs.push_back(it->first);
+    }
+}
@@ -0,0 +1,105 @@
+#include "penelope/core/LiveReport.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/utils/Atomic.h"
+#include "penelope/utils/System.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace penelope;
+
+/** The time between two checks of the triggers, in milliseconds */
+#define LIVE_REPORT_SLICE 50
+
+volatile sig_atomic_t LiveReport::requested = 0;
+
+LiveReport::LiveReport(Cooperation* c, const char* aControlFile) :
+coop(c), controlFile(aControlFile), thread(), running(false), stopRequested(false),
+startTime(0) {
+}
+
+LiveReport::~LiveReport() {
+    stop();
+}
+
+void LiveReport::request() {
+    requested = 1;
+}
+
+bool LiveReport::start() {
+    if (running) return true;
+    startTime = nanoTime();
+    stopRequested = false;
+    if (pthread_create(&thread, NULL, &LiveReport::run, this) != 0) return false;
+    running = true;
+    return true;
+}
+
+void LiveReport::stop() {
+    if (!running) return;
+    stopRequested = true;
+    pthread_join(thread, NULL);
+    running = false;
+}
+
+void* LiveReport::run(void* data) {
+    LiveReport* live = static_cast<LiveReport*> (data);
+    struct timespec slice;
+    slice.tv_sec = 0;
+    slice.tv_nsec = LIVE_REPORT_SLICE * 1000000L;
+    while (!live->stopRequested) {
+        nanosleep(&slice, NULL);
+        bool print = requested != 0;
+        requested = 0;
+        if (live->controlFile != NULL && access(live->controlFile, F_OK) == 0) {
+            unlink(live->controlFile);
+            print = true;
+        }
+        if (print) live->report();
+    }
+    return NULL;
+}
+
+void LiveReport::report() {
+    int nbThreads = coop->nThreads();
+    double time = (nanoTime() - startTime) / 1e9;
+
+    printf("c  -----------------------------------------------------------------------------------------------------------------------\n");
+    printf("c | Penelope - live statistics after %.1f s                                                                                |\n", time);
+    printf("c |------------------------------------------------------------------------------------------------------------------------------------------------|\n");
+    printf("c |  Thread  |  state  |   #restarts   |   decisions   |  #conflicts   |   %% shared cls  |  #extra units | #extra clauses | #pending cls | progress | memory MB |\n");
+    printf("c |----------|---------|---------------|---------------|---------------|-----------------|---------------|----------------|--------------|----------|-----------|\n");
+
+    uint64_t totalConflicts = 0;
+    uint64_t totalShared = 0;
+    for (int t = 0; t < nbThreads; t++) {
+        SolverSnapshot snap;
+        coop->snapshot(t, snap);
+        uint64_t shared = (uint64_t) snap.importedUnits + snap.importedClauses;
+        totalConflicts += snap.conflicts;
+        totalShared += shared;
+        printf("c | %8d | %7s | %13lu | %13lu | %13lu | %13lu %% | %13d | %14d | %12d | %7.3f%% | %9.2f |\n",
+            t, atomicLoad(&coop->stopped[t]) ? "stopped" : "running",
+            snap.restarts, snap.decisions, snap.conflicts,
+            snap.conflicts == 0 ? 0 : shared * 100 / snap.conflicts,
+            snap.importedUnits, snap.importedClauses, snap.pendingClauses,
+            snap.progress * 100, snap.memory.total() / (1024.0 * 1024.0));
+    }
+    printf("c |--------------------------------------------------------|---------------|-----------------|---------------------------------------------------------------------|\n");
+    printf("c |                                                        | %13lu | %13lu %% |                                                                     |\n",
+        totalConflicts, totalConflicts == 0 ? 0 : totalShared * 100 / totalConflicts);
+    printf("c  ------------------------------------------------------------------------------------------------------------------------------------------------\n");
+
+    printf("c Import usage matrix:\n");
+    for (int i = 0; i < nbThreads; i++) {
+        printf("c matrix | ");
+        for (int j = 0; j < nbThreads; j++) {
+            uint64_t imported = atomicLoad(&coop->solvers[i].nbClauseImported[j]);
+            uint64_t used = atomicLoad(&coop->solvers[i].nbClauseUsed[j]);
+            printf("%5.2f%% | ", imported == 0 ? 0.0 : (100.0 * used) / imported);
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
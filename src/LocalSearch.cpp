@@ -0,0 +1,207 @@
+#include "penelope/core/LocalSearch.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/core/ParameterSpace.h"
+
+#include <math.h>
+
+using namespace penelope;
+
+LocalSearch::LocalSearch(Solver& s, Cooperation* c) : solver(s), coop(c), lits(), clauseStart(),
+occurrences(), occurrenceStart(), values(), nbTrue(), unsat(), unsatPosition(), scores(),
+sinceBest(), bestSaved(false), best(), bestRun(0), bestEver(-1), phasesVersion(0), seed(0),
+flips(0), runFlips(0), runLength(0), restarts(0) {
+    seed = (uint64_t) s.random_seed + 0x9E3779B97F4A7C15ULL * (uint64_t) (s.threadId + 1);
+    for (int b = 0; b < LOCAL_SEARCH_MAX_BREAK; b++)
+        probabilities[b] = pow(1.0 + b, -s.localSearchCb);
+}
+
+void LocalSearch::load() {
+    int nbLits = 2 * solver.nVars();
+    vec<int> counts(nbLits, 0);
+
+    clauseStart.clear();
+    lits.clear();
+    for (int i = 0; i < solver.nClauses(); i++) {
+        const Clause& c = solver.getClause(solver.getOriginalClause(i));
+        bool satisfied = false;
+        for (int k = 0; k < c.size() && !satisfied; k++)
+            satisfied = solver.value(c[k]) == l_True;
+        if (satisfied) continue;
+
+        clauseStart.push(lits.size());
+        for (int k = 0; k < c.size(); k++) {
+            if (solver.value(c[k]) == l_False) continue;
+            lits.push(c[k]);
+            counts[toInt(c[k])]++;
+        }
+    }
+    clauseStart.push(lits.size());
+    int nbClauses = clauseStart.size() - 1;
+
+    // the occurrence lists are stored one after the other
+    occurrenceStart.growTo(nbLits + 1);
+    occurrenceStart[0] = 0;
+    for (int l = 0; l < nbLits; l++) occurrenceStart[l + 1] = occurrenceStart[l] + counts[l];
+    occurrences.growTo(lits.size());
+    for (int c = 0; c < nbClauses; c++)
+        for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+            int l = toInt(lits[i]);
+            occurrences[occurrenceStart[l + 1] - counts[l]--] = c;
+        }
+
+    values.growTo(solver.nVars(), 0);
+    nbTrue.growTo(nbClauses, 0);
+    unsatPosition.growTo(nbClauses, -1);
+}
+
+void LocalSearch::restart(const vec<char>* phases) {
+    for (Var v = 0; v < values.size(); v++) {
+        if (solver.value(v) != l_Undef)
+            values[v] = solver.value(v) == l_True;
+        else if (phases != NULL && v < phases->size())
+            values[v] = !(*phases)[v];
+        else
+            values[v] = ParameterSpace::random(seed) & 1;
+    }
+
+    unsat.clear();
+    for (int c = 0; c < nbTrue.size(); c++) {
+        nbTrue[c] = 0;
+        for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++)
+            if (isTrue(lits[i])) nbTrue[c]++;
+        unsatPosition[c] = -1;
+        if (nbTrue[c] == 0) {
+            unsatPosition[c] = unsat.size();
+            unsat.push(c);
+        }
+    }
+
+    bestRun = unsat.size();
+    if (bestEver < 0 || bestRun < bestEver) bestEver = bestRun;
+    sinceBest.clear();
+    bestSaved = false;
+    runFlips = 0;
+}
+
+int LocalSearch::breakValue(Var v) const {
+    // the clauses where v is the only true literal
+    int l = toInt(mkLit(v, !values[v]));
+    int b = 0;
+    for (int i = occurrenceStart[l]; i < occurrenceStart[l + 1]; i++)
+        if (nbTrue[occurrences[i]] == 1) b++;
+    return b;
+}
+
+void LocalSearch::flip(Var v) {
+    values[v] = !values[v];
+    if (!bestSaved) {
+        sinceBest.push(v);
+        if (sinceBest.size() >= values.size()) {
+            saveBest();
+            bestSaved = true;
+        }
+    }
+
+    int l = toInt(mkLit(v, !values[v]));
+    for (int i = occurrenceStart[l]; i < occurrenceStart[l + 1]; i++) {
+        int c = occurrences[i];
+        if (nbTrue[c]++ > 0) continue;
+        // c is satisfied: the last falsified clause takes its place
+        int last = unsat.last();
+        unsat[unsatPosition[c]] = last;
+        unsatPosition[last] = unsatPosition[c];
+        unsatPosition[c] = -1;
+        unsat.pop();
+    }
+
+    l = toInt(mkLit(v, values[v]));
+    for (int i = occurrenceStart[l]; i < occurrenceStart[l + 1]; i++) {
+        int c = occurrences[i];
+        if (--nbTrue[c] > 0) continue;
+        unsatPosition[c] = unsat.size();
+        unsat.push(c);
+    }
+}
+
+Var LocalSearch::pickVar(int c) {
+    int size = clauseStart[c + 1] - clauseStart[c];
+    scores.growTo(size);
+    double sum = 0;
+    for (int i = 0; i < size; i++) {
+        int b = breakValue(var(lits[clauseStart[c] + i]));
+        scores[i] = probabilities[b < LOCAL_SEARCH_MAX_BREAK ? b : LOCAL_SEARCH_MAX_BREAK - 1];
+        sum += scores[i];
+    }
+
+    double r = random01() * sum;
+    for (int i = 0; i < size - 1; i++) {
+        r -= scores[i];
+        if (r < 0) return var(lits[clauseStart[c] + i]);
+    }
+    return var(lits[clauseStart[c] + size - 1]);
+}
+
+double LocalSearch::random01() {
+    return (ParameterSpace::random(seed) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+bool LocalSearch::mustStop() const {
+    if (solver.asynch_interrupt || coop->isStopped(solver.threadId)) return true;
+    for (int t = 0; t < coop->nThreads(); t++)
+        if (coop->answer(t) != l_Undef) return true;
+    return false;
+}
+
+void LocalSearch::saveBest() {
+    if (bestSaved) return;
+    best.growTo(values.size());
+    for (Var v = 0; v < values.size(); v++) best[v] = !values[v];
+    for (int i = 0; i < sinceBest.size(); i++) best[sinceBest[i]] = !best[sinceBest[i]];
+}
+
+lbool LocalSearch::solve() {
+    if (!solver.simplify(coop)) {
+        coop->answers[solver.threadId] = l_False;
+        return l_False;
+    }
+    load();
+
+    // the first run starts from the initial polarities of the solver, the
+    // next ones from the polarities of the CDCL solvers
+    vec<char> phases;
+    solver.getPolarities(phases);
+    restart(&phases);
+    runLength = solver.localSearchFlips;
+    coop->fetchSolverPhases(phases, phasesVersion);
+
+    for (;;) {
+        if (unsat.size() == 0) {
+            solver.model.growTo(values.size());
+            for (Var v = 0; v < values.size(); v++)
+                solver.model[v] = lbool((bool)values[v]);
+            coop->answers[solver.threadId] = l_True;
+            return l_True;
+        }
+        if (flips % LOCAL_SEARCH_CHECK_FLIPS == 0 && mustStop()) return l_Undef;
+
+        if (runFlips > 0 && runFlips % solver.localSearchPublish == 0) {
+            saveBest();
+            coop->publishLocalSearchPhases(best, bestRun);
+        }
+        if (runFlips >= runLength) {
+            restart(coop->fetchSolverPhases(phases, phasesVersion) ? &phases : NULL);
+            runLength *= 2;
+            restarts++;
+        }
+
+        flip(pickVar(unsat[ParameterSpace::random(seed) % unsat.size()]));
+        flips++;
+        runFlips++;
+        if (unsat.size() < bestRun) {
+            bestRun = unsat.size();
+            if (bestRun < bestEver) bestEver = bestRun;
+            sinceBest.clear();
+            bestSaved = false;
+        }
+    }
+}
@@ -0,0 +1,228 @@
+#include "penelope/core/ParameterSpace.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace penelope;
+
+/** The kinds of values of the parameters */
+enum ParameterKind {
+    /** one value out of a list */
+    PARAM_CHOICE,
+    /** an integer in a range */
+    PARAM_INT,
+    /** a real in a range */
+    PARAM_DOUBLE
+};
+
+/**
+ * A parameter of the solvers that can be changed between two searches
+ */
+struct Parameter {
+    /** The name of the parameter in the configuration file */
+    const char* name;
+    ParameterKind kind;
+    /** The allowed values of a PARAM_CHOICE, ended by NULL */
+    const char* choices[4];
+    /** The range of a PARAM_INT or a PARAM_DOUBLE */
+    double min, max;
+    /** true if the range is covered on a logarithmic scale */
+    bool logScale;
+};
+
+/**
+ * The parameters that can be changed. The policies whose change would need
+ * to transform the learnt clauses (usePsm, importPolicy) are not part of it.
+ */
+static const Parameter parameters[] = {
+    {"restartPolicy", PARAM_CHOICE, {"avgLBD", "luby", "picosat", NULL}, 0, 0, false},
+    {"initPhasePolicy", PARAM_CHOICE, {"true", "false", "random", NULL}, 0, 0, false},
+    {"maxFreeze", PARAM_INT, {NULL}, 1, 20, false},
+    {"initialNbConflictBeforeReduce", PARAM_INT, {NULL}, 100, 5000, true},
+    {"nbConflictBeforeReduceIncrement", PARAM_INT, {NULL}, 10, 1000, true},
+    {"maxLBDExchange", PARAM_INT, {NULL}, 2, 12, false},
+    {"lubyFactor", PARAM_INT, {NULL}, 10, 1000, true},
+    {"maxLBD", PARAM_INT, {NULL}, 4, 30, false},
+    {"restartFactor", PARAM_DOUBLE, {NULL}, 0.5, 0.95, false}
+};
+
+/** The base of the Halton sequence of each parameter */
+static const int haltonBases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23};
+
+/** The largest base of haltonBases */
+#define HALTON_MAX_BASE 23
+
+/**
+ * Compute an element of a scrambled Van der Corput sequence of a given base
+ * @param index the index of the element, > 0
+ * @param base the base of the sequence
+ * @param digits the permutation applied to the digits of the index
+ * @return the element, in [0,1)
+ */
+static double vanDerCorput(int index, int base, const int* digits) {
+    double result = 0;
+    double f = 1.0 / base;
+    while (index > 0) {
+        result += f * digits[index % base];
+        index /= base;
+        f /= base;
+    }
+    return result;
+}
+
+/** The number of parameters that can be changed */
+#define NB_PARAMETERS ((int) (sizeof(parameters) / sizeof(Parameter)))
+
+ParameterSpace::ParameterSpace(const INIParser& parser) : values(NB_PARAMETERS) {
+    std::vector<std::string> confs;
+    parser.getConfigurations(confs);
+    for (unsigned int c = 0; c < confs.size(); c++) {
+        if (confs[c] != "default" && confs[c].compare(0, 6, "solver") != 0) continue;
+        for (int p = 0; p < NB_PARAMETERS; p++) {
+            const std::string& v(parser.getValueForConf(confs[c], parameters[p].name));
+            if (v.length() == 0) continue;
+            bool known = false;
+            for (unsigned int i = 0; i < values[p].size() && !known; i++)
+                known = values[p][i] == v;
+            if (!known) values[p].push_back(v);
+        }
+    }
+}
+
+uint64_t ParameterSpace::random(uint64_t& seed) {
+    // xorshift64*, the seed must never be 0
+    if (seed == 0) seed = 0x9E3779B97F4A7C15ULL;
+    seed ^= seed >> 12;
+    seed ^= seed << 25;
+    seed ^= seed >> 27;
+    return seed * 2685821657736338717ULL;
+}
+
+const std::string& ParameterSpace::valueOf(const INIParser& parser, const std::string& conf,
+        const std::string& attribute) {
+    const std::string& v(parser.getValueForConf(conf, attribute));
+    if (v.length() == 0) return parser.getValueForConf("default", attribute);
+    return v;
+}
+
+std::string ParameterSpace::draw(int p, const std::string& current, uint64_t& seed) const {
+    const Parameter& param = parameters[p];
+
+    // half of the time, a value of the configuration file is reused
+    std::vector<std::string> candidates;
+    for (unsigned int i = 0; i < values[p].size(); i++)
+        if (values[p][i] != current) candidates.push_back(values[p][i]);
+    if (!candidates.empty() && (random(seed) & 1))
+        return candidates[random(seed) % candidates.size()];
+
+    char buffer[32];
+    switch (param.kind) {
+        case PARAM_CHOICE:
+        {
+            candidates.clear();
+            for (int i = 0; param.choices[i] != NULL; i++)
+                if (current != param.choices[i]) candidates.push_back(param.choices[i]);
+            if (candidates.empty()) return current;
+            return candidates[random(seed) % candidates.size()];
+        }
+        case PARAM_INT:
+        {
+            // around the current value: between its half and its double
+            int lo = (int) param.min, hi = (int) param.max;
+            if (current.length() > 0) {
+                int v = atoi(current.c_str());
+                if (v / 2 > lo) lo = v / 2;
+                if (v * 2 < hi) hi = v * 2;
+                if (lo > hi) lo = hi = v;
+            }
+            snprintf(buffer, sizeof(buffer), "%d", lo + (int) (random(seed) % (hi - lo + 1)));
+            return std::string(buffer);
+        }
+        case PARAM_DOUBLE:
+        {
+            double u = (random(seed) >> 11) * (1.0 / 9007199254740992.0);
+            snprintf(buffer, sizeof(buffer), "%.3f", param.min + u * (param.max - param.min));
+            return std::string(buffer);
+        }
+    }
+    return current;
+}
+
+std::string ParameterSpace::valueAt(int p, double u) {
+    const Parameter& param = parameters[p];
+    char buffer[32];
+    if (param.kind == PARAM_CHOICE) {
+        int nbChoices = 0;
+        while (param.choices[nbChoices] != NULL) nbChoices++;
+        return std::string(param.choices[(int) (u * nbChoices)]);
+    }
+    if (param.kind == PARAM_INT && !param.logScale) {
+        // every integer of the range covers the same part of [0,1)
+        snprintf(buffer, sizeof(buffer), "%d", (int) param.min + (int) (u * (param.max - param.min + 1)));
+        return std::string(buffer);
+    }
+    double v = param.logScale ? param.min * pow(param.max / param.min, u)
+            : param.min + u * (param.max - param.min);
+    if (param.kind == PARAM_INT)
+        snprintf(buffer, sizeof(buffer), "%d", (int) floor(v + 0.5));
+    else
+        snprintf(buffer, sizeof(buffer), "%.3f", v);
+    return std::string(buffer);
+}
+
+std::string ParameterSpace::generate(INIParser& parser, const std::string& to, int index, uint64_t seed) const {
+    std::string description;
+    for (int p = 0; p < NB_PARAMETERS; p++) {
+        // the digits are scrambled, otherwise the first points of the
+        // sequences of close bases are correlated. The permutations only
+        // depend on the seed, so that they are the same for every index.
+        int base = haltonBases[p];
+        int digits[HALTON_MAX_BASE];
+        for (int d = 0; d < base; d++) digits[d] = d;
+        for (int d = base - 1; d > 1; d--) {
+            int k = 1 + (int) (random(seed) % d);
+            int tmp = digits[d];
+            digits[d] = digits[k];
+            digits[k] = tmp;
+        }
+        double u = vanDerCorput(index + 1, base, digits);
+
+        // the values chosen in the default configuration are kept
+        if (parser.getValueForConf("default", parameters[p].name).length() > 0) continue;
+        const std::string v(valueAt(p, u));
+        parser.setValueForConf(to, parameters[p].name, v);
+        if (description.length() > 0) description += " ";
+        description += parameters[p].name;
+        description += "=";
+        description += v;
+    }
+    return description;
+}
+
+std::string ParameterSpace::mutate(INIParser& parser, const std::string& from, const std::string& to,
+        int nbChanges, uint64_t& seed) const {
+    parser.copyConfiguration(from, to);
+
+    // draw nbChanges distinct parameters
+    int order[NB_PARAMETERS];
+    for (int p = 0; p < NB_PARAMETERS; p++) order[p] = p;
+    if (nbChanges > NB_PARAMETERS) nbChanges = NB_PARAMETERS;
+
+    std::string description;
+    for (int i = 0; i < nbChanges; i++) {
+        int j = i + (int) (random(seed) % (NB_PARAMETERS - i));
+        int p = order[j];
+        order[j] = order[i];
+        order[i] = p;
+
+        const std::string current(valueOf(parser, from, parameters[p].name));
+        const std::string v(draw(p, current, seed));
+        parser.setValueForConf(to, parameters[p].name, v);
+        if (description.length() > 0) description += " ";
+        description += parameters[p].name;
+        description += "=";
+        description += v;
+    }
+    return description;
+}
@@ -0,0 +1,127 @@
+#include "penelope/utils/PerfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+using namespace penelope;
+
+PerfCounters::PerfCounters() {
+    for (int i = 0; i < PERF_NB_COUNTERS; i++) fds[i] = -1;
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+const char* PerfCounters::name(Counter c) {
+    static const char* names[PERF_NB_COUNTERS] = {
+        "cycles", "instructions", "cache-misses", "branch-misses", "dTLB-misses",
+        "task-clock"
+    };
+    return names[c];
+}
+
+bool PerfCounters::isOpen() const {
+    for (int i = 0; i < PERF_NB_COUNTERS; i++)
+        if (fds[i] >= 0) return true;
+    return false;
+}
+
+#if defined(__linux__)
+
+bool PerfCounters::open() {
+    static const uint32_t types[PERF_NB_COUNTERS] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_SOFTWARE
+    };
+    static const uint64_t configs[PERF_NB_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_SW_TASK_CLOCK
+    };
+
+    close();
+    for (int i = 0; i < PERF_NB_COUNTERS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof (attr));
+        attr.type = types[i];
+        attr.size = sizeof (attr);
+        attr.config = configs[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // pid = 0 and cpu = -1: the calling thread, on any cpu
+        fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fds[i] < 0) fds[i] = -1;
+    }
+    return isOpen();
+}
+
+void PerfCounters::close() {
+    for (int i = 0; i < PERF_NB_COUNTERS; i++) {
+        if (fds[i] >= 0) ::close(fds[i]);
+        fds[i] = -1;
+    }
+}
+
+void PerfCounters::read(uint64_t* values) const {
+    for (int i = 0; i < PERF_NB_COUNTERS; i++) {
+        values[i] = 0;
+        if (fds[i] >= 0 && ::read(fds[i], &values[i], sizeof (uint64_t)) != sizeof (uint64_t))
+            values[i] = 0;
+    }
+}
+
+#else
+
+bool PerfCounters::open() {
+    return false;
+}
+
+void PerfCounters::close() {
+}
+
+void PerfCounters::read(uint64_t* values) const {
+    for (int i = 0; i < PERF_NB_COUNTERS; i++) values[i] = 0;
+}
+
+#endif
+
+PhaseCounters::PhaseCounters() : counters(), phase(COUNTERS_NB_PHASES) {
+    for (int c = 0; c < PerfCounters::PERF_NB_COUNTERS; c++) {
+        mark[c] = 0;
+        for (int p = 0; p < COUNTERS_NB_PHASES; p++) totals[p][c] = 0;
+    }
+}
+
+const char* PhaseCounters::name(CounterPhase p) {
+    static const char* names[COUNTERS_NB_PHASES] = {"search", "reduceDB"};
+    return names[p];
+}
+
+void PhaseCounters::start(CounterPhase p) {
+    if (!counters.isOpen()) return;
+    counters.read(mark);
+    phase = p;
+}
+
+void PhaseCounters::switchTo(CounterPhase p) {
+    if (!counters.isOpen()) return;
+    uint64_t now[PerfCounters::PERF_NB_COUNTERS];
+    counters.read(now);
+    if (phase != COUNTERS_NB_PHASES) {
+        for (int c = 0; c < PerfCounters::PERF_NB_COUNTERS; c++)
+            totals[phase][c] += now[c] - mark[c];
+    }
+    for (int c = 0; c < PerfCounters::PERF_NB_COUNTERS; c++) mark[c] = now[c];
+    phase = p;
+}
+
+void PhaseCounters::stop() {
+    switchTo(COUNTERS_NB_PHASES);
+}
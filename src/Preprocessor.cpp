@@ -0,0 +1,479 @@
+#include "penelope/core/Preprocessor.h"
+#include "penelope/core/XorEngine.h"
+#include "penelope/utils/Sort.h"
+
+using namespace penelope;
+
+namespace penelope {
+
+    /**
+     * The first subsumption pass of a large formula: each worker checks a
+     * share of the queued clauses against the formula, without modifying it
+     */
+    class SubsumptionTask : public Task {
+    public:
+
+        /** A clause related to one of the candidates by subsumes */
+        struct Found {
+            /** The position of the candidate */
+            int candidate;
+            /** The clause subsumed or strengthened by the candidate */
+            CRef other;
+        };
+
+        SubsumptionTask(Preprocessor& p, const vec<CRef>& c, int n) :
+        pre(p), candidates(c), nbWorkers(n), found(n) {
+        }
+
+        void execute(int worker) {
+            const ClauseAllocator& ca = pre.ca;
+            for (int i = worker; i < candidates.size(); i += nbWorkers) {
+                const Clause& c = ca[candidates[i]];
+                Var best = var(c[0]);
+                for (int k = 1; k < c.size(); k++)
+                    if (pre.occurs[var(c[k])].size() < pre.occurs[best].size()) best = var(c[k]);
+
+                const vec<CRef>& cs = pre.occurs[best];
+                for (int j = 0; j < cs.size(); j++) {
+                    const Clause& other = ca[cs[j]];
+                    if (cs[j] == candidates[i] || other.mark() || other.size() >= PREPROCESSOR_SUBSUMPTION_LIMIT)
+                        continue;
+                    if (c.subsumes(other) != lit_Error) {
+                        Found f;
+                        f.candidate = i;
+                        f.other = cs[j];
+                        found[worker].push(f);
+                    }
+                }
+            }
+        }
+
+        Preprocessor& pre;
+        /** The queued clauses */
+        const vec<CRef>& candidates;
+        int nbWorkers;
+        /** What each worker found, in the order of the candidates */
+        vec<vec<Found> > found;
+    };
+
+}
+
+Preprocessor::Preprocessor() : parallelClauses(PREPROCESSOR_PARALLEL_CLAUSES), ok(true), ca(), clauses(),
+remaining(0), occurs(ClauseDeleted(ca)), nbOccurrences(), elimHeap(ElimLt(nbOccurrences)),
+subsumptionQueue(), touched(), nbTouched(0), assigns(), trail(), qhead(0), eliminated(),
+frozen(), elimclauses(), addTmp(), eliminatedVars(0), subsumed(0), strengthened(0) {
+    ca.extra_clause_field = true;
+}
+
+void Preprocessor::initialiseMem(int nbVar, int nbClause) {
+    assigns.capacity(nbVar);
+    eliminated.capacity(nbVar);
+    touched.capacity(nbVar);
+    nbOccurrences.capacity(2 * nbVar);
+    clauses.capacity(nbClause);
+}
+
+Var Preprocessor::newVar() {
+    Var v = nVars();
+    assigns.push(l_Undef);
+    eliminated.push(false);
+    frozen.push(false);
+    touched.push(false);
+    nbOccurrences.push(0);
+    nbOccurrences.push(0);
+    occurs.init(v);
+    return v;
+}
+
+bool Preprocessor::addClause(const vec<Lit>& ps) {
+    ps.copyTo(addTmp);
+    return addClause_(addTmp);
+}
+
+bool Preprocessor::addClause_(vec<Lit>& ps) {
+    if (!ok) return false;
+
+    // Check if clause is satisfied and remove false/duplicate literals:
+    sort(ps);
+    Lit p;
+    int i, j;
+    for (i = j = 0, p = lit_Undef; i < ps.size(); i++)
+        if (value(ps[i]) == l_True || ps[i] == ~p)
+            return true;
+        else if (value(ps[i]) != l_False && ps[i] != p)
+            ps[j++] = p = ps[i];
+    ps.shrink(i - j);
+
+    if (ps.size() == 0)
+        return ok = false;
+    if (ps.size() == 1)
+        return ok = enqueue(ps[0]) && propagate();
+
+    CRef cr = ca.alloc(ps, false);
+    clauses.push(cr);
+    remaining++;
+    subsumptionQueue.insert(cr);
+    for (int k = 0; k < ps.size(); k++) {
+        Var v = var(ps[k]);
+        occurs[v].push(cr);
+        nbOccurrences[toInt(ps[k])]++;
+        touched[v] = 1;
+        nbTouched++;
+        if (elimHeap.inHeap(v)) elimHeap.increase(v);
+    }
+    return true;
+}
+
+bool Preprocessor::enqueue(Lit l) {
+    if (value(l) != l_Undef) return value(l) == l_True;
+    assigns[var(l)] = lbool(!sign(l));
+    trail.push(l);
+    return true;
+}
+
+bool Preprocessor::propagate() {
+    vec<CRef> cs;
+    while (qhead < trail.size()) {
+        Lit p = trail[qhead++];
+        // the occurrences of the variable change while they are simplified
+        occurs.lookup(var(p)).copyTo(cs);
+        for (int i = 0; i < cs.size(); i++) {
+            const Clause& c = ca[cs[i]];
+            if (c.mark()) continue;
+            bool satisfied = false;
+            for (int k = 0; k < c.size() && !satisfied; k++) satisfied = c[k] == p;
+            if (satisfied)
+                removeClause(cs[i]);
+            else if (!strengthenClause(cs[i], ~p))
+                return ok = false;
+        }
+    }
+    return true;
+}
+
+void Preprocessor::removeClause(CRef cr) {
+    Clause& c = ca[cr];
+    for (int k = 0; k < c.size(); k++) {
+        nbOccurrences[toInt(c[k])]--;
+        updateElimHeap(var(c[k]));
+        occurs.smudge(var(c[k]));
+    }
+    c.mark(1);
+    ca.free(cr);
+    remaining--;
+}
+
+bool Preprocessor::strengthenClause(CRef cr, Lit l) {
+    Clause& c = ca[cr];
+    subsumptionQueue.insert(cr);
+    if (c.size() == 2) {
+        removeClause(cr);
+        c.strengthen(l);
+    } else {
+        c.strengthen(l);
+        remove(occurs[var(l)], cr);
+        nbOccurrences[toInt(l)]--;
+        updateElimHeap(var(l));
+    }
+    return c.size() == 1 ? enqueue(c[0]) : true;
+}
+
+void Preprocessor::updateElimHeap(Var v) {
+    if (elimHeap.inHeap(v) || (!eliminated[v] && assigns[v] == l_Undef))
+        elimHeap.update(v);
+}
+
+void Preprocessor::gatherTouchedClauses() {
+    if (nbTouched == 0) return;
+
+    // the mark 2 avoids queuing a clause twice
+    for (int i = 0; i < subsumptionQueue.size(); i++)
+        if (ca[subsumptionQueue[i]].mark() == 0)
+            ca[subsumptionQueue[i]].mark(2);
+
+    for (Var v = 0; v < nVars(); v++) {
+        if (!touched[v]) continue;
+        const vec<CRef>& cs = occurs.lookup(v);
+        for (int j = 0; j < cs.size(); j++)
+            if (ca[cs[j]].mark() == 0) {
+                subsumptionQueue.insert(cs[j]);
+                ca[cs[j]].mark(2);
+            }
+        touched[v] = 0;
+    }
+
+    for (int i = 0; i < subsumptionQueue.size(); i++)
+        if (ca[subsumptionQueue[i]].mark() == 2)
+            ca[subsumptionQueue[i]].mark(0);
+
+    nbTouched = 0;
+}
+
+bool Preprocessor::subsume(CRef cr, CRef other) {
+    const Clause& c = ca[cr];
+    if (c.mark() || ca[other].mark()) return true;
+    Lit l = c.subsumes(ca[other]);
+    if (l == lit_Undef) {
+        subsumed++;
+        removeClause(other);
+    } else if (l != lit_Error) {
+        strengthened++;
+        return strengthenClause(other, ~l);
+    }
+    return true;
+}
+
+bool Preprocessor::backwardSubsumptionCheck() {
+    while (subsumptionQueue.size() > 0) {
+        CRef cr = subsumptionQueue.peek();
+        subsumptionQueue.pop();
+        const Clause& c = ca[cr];
+        if (c.mark()) continue;
+
+        // the candidates are the clauses of its least frequent variable
+        Var best = var(c[0]);
+        for (int k = 1; k < c.size(); k++)
+            if (occurs[var(c[k])].size() < occurs[best].size()) best = var(c[k]);
+
+        const vec<CRef>& cs = occurs.lookup(best);
+        for (int j = 0; j < cs.size() && !c.mark(); j++) {
+            const Clause& other = ca[cs[j]];
+            if (cs[j] == cr || other.mark() || other.size() >= PREPROCESSOR_SUBSUMPTION_LIMIT)
+                continue;
+            Lit l = c.subsumes(other);
+            if (l == lit_Undef) {
+                subsumed++;
+                removeClause(cs[j]);
+            } else if (l != lit_Error) {
+                strengthened++;
+                if (!strengthenClause(cs[j], ~l)) return ok = false;
+                // the candidate was removed from the list: the next one
+                // took its place
+                if (var(l) == best) j--;
+            }
+        }
+        if (!propagate()) return false;
+    }
+    return true;
+}
+
+bool Preprocessor::parallelSubsumptionCheck(Executor& executor) {
+    occurs.cleanAll();
+    vec<CRef> candidates;
+    while (subsumptionQueue.size() > 0) {
+        if (!ca[subsumptionQueue.peek()].mark()) candidates.push(subsumptionQueue.peek());
+        subsumptionQueue.pop();
+    }
+
+    SubsumptionTask task(*this, candidates, executor.nbWorkers());
+    executor.run(task);
+
+    // the clauses changed since they were checked: each relation is checked
+    // again when it is applied, in the order of the queue whatever the
+    // number of workers
+    vec<int> next(task.nbWorkers, 0);
+    for (int i = 0; i < candidates.size(); i++) {
+        int worker = i % task.nbWorkers;
+        const vec<SubsumptionTask::Found>& found = task.found[worker];
+        for (; next[worker] < found.size() && found[next[worker]].candidate == i; next[worker]++)
+            if (!subsume(candidates[i], found[next[worker]].other)) return ok = false;
+        if (!propagate()) return false;
+    }
+    return true;
+}
+
+bool Preprocessor::merge(const Clause& _ps, const Clause& _qs, Var v, int& size) const {
+    bool ps_smallest = _ps.size() < _qs.size();
+    const Clause& ps = ps_smallest ? _qs : _ps;
+    const Clause& qs = ps_smallest ? _ps : _qs;
+
+    size = ps.size() - 1;
+    for (int i = 0; i < qs.size(); i++) {
+        if (var(qs[i]) != v) {
+            for (int j = 0; j < ps.size(); j++)
+                if (var(ps[j]) == var(qs[i])) {
+                    if (ps[j] == ~qs[i]) return false;
+                    else goto next;
+                }
+            size++;
+        }
+next:
+        ;
+    }
+    return true;
+}
+
+bool Preprocessor::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out) const {
+    bool ps_smallest = _ps.size() < _qs.size();
+    const Clause& ps = ps_smallest ? _qs : _ps;
+    const Clause& qs = ps_smallest ? _ps : _qs;
+
+    out.clear();
+    for (int i = 0; i < qs.size(); i++) {
+        if (var(qs[i]) != v) {
+            for (int j = 0; j < ps.size(); j++)
+                if (var(ps[j]) == var(qs[i])) {
+                    if (ps[j] == ~qs[i]) return false;
+                    else goto next;
+                }
+            out.push(qs[i]);
+        }
+next:
+        ;
+    }
+    for (int i = 0; i < ps.size(); i++)
+        if (var(ps[i]) != v) out.push(ps[i]);
+    return true;
+}
+
+void Preprocessor::mkElimClause(Var v, const Clause& c) {
+    int first = elimclauses.size();
+    int vPos = -1;
+    for (int i = 0; i < c.size(); i++) {
+        elimclauses.push(toInt(c[i]));
+        if (var(c[i]) == v) vPos = i + first;
+    }
+    ASSERT_TRUE(vPos != -1);
+    // the literal of the eliminated variable comes first
+    uint32_t tmp = elimclauses[vPos];
+    elimclauses[vPos] = elimclauses[first];
+    elimclauses[first] = tmp;
+    elimclauses.push(c.size());
+}
+
+void Preprocessor::mkElimClause(Lit x) {
+    elimclauses.push(toInt(x));
+    elimclauses.push(1);
+}
+
+bool Preprocessor::eliminateVar(Var v) {
+    vec<CRef> pos, neg;
+    const vec<CRef>& cls = occurs.lookup(v);
+    for (int i = 0; i < cls.size(); i++) {
+        const Clause& c = ca[cls[i]];
+        bool positive = false;
+        for (int k = 0; k < c.size(); k++)
+            if (c[k] == mkLit(v)) positive = true;
+        (positive ? pos : neg).push(cls[i]);
+    }
+
+    // the elimination must not increase the number of clauses
+    int cnt = 0;
+    int size = 0;
+    for (int i = 0; i < pos.size(); i++)
+        for (int j = 0; j < neg.size(); j++)
+            if (merge(ca[pos[i]], ca[neg[j]], v, size)
+                    && (++cnt > pos.size() + neg.size() || size > PREPROCESSOR_RESOLVENT_LIMIT))
+                return true;
+
+    // the clauses of the smallest side are enough to extend the models
+    eliminated[v] = true;
+    eliminatedVars++;
+    if (pos.size() > neg.size()) {
+        for (int i = 0; i < neg.size(); i++) mkElimClause(v, ca[neg[i]]);
+        mkElimClause(mkLit(v));
+    } else {
+        for (int i = 0; i < pos.size(); i++) mkElimClause(v, ca[pos[i]]);
+        mkElimClause(~mkLit(v));
+    }
+    for (int i = 0; i < pos.size(); i++) removeClause(pos[i]);
+    for (int i = 0; i < neg.size(); i++) removeClause(neg[i]);
+
+    // the clauses are replaced by their resolvents
+    vec<Lit> resolvent;
+    for (int i = 0; i < pos.size(); i++)
+        for (int j = 0; j < neg.size(); j++)
+            if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
+                return false;
+
+    occurs[v].clear(true);
+    return backwardSubsumptionCheck();
+}
+
+bool Preprocessor::preprocess(Executor* executor) {
+    if (!ok || !propagate()) return ok = false;
+    for (Var v = 0; v < nVars(); v++) updateElimHeap(v);
+
+    if (executor != NULL && executor->nbWorkers() > 1 && remaining >= parallelClauses
+            && !parallelSubsumptionCheck(*executor))
+        return false;
+
+    while (nbTouched > 0 || subsumptionQueue.size() > 0 || elimHeap.size() > 0) {
+        gatherTouchedClauses();
+        if (!backwardSubsumptionCheck()) return false;
+        while (elimHeap.size() > 0) {
+            Var v = elimHeap.removeMin();
+            if (eliminated[v] || frozen[v] || assigns[v] != l_Undef) continue;
+            if (!eliminateVar(v)) return ok = false;
+        }
+    }
+    return true;
+}
+
+int Preprocessor::freezeXors() {
+    vec<CRef> candidates;
+    for (int i = 0; i < clauses.size(); i++)
+        if (!ca[clauses[i]].mark()) candidates.push(clauses[i]);
+    vec<vec<Var> > xors;
+    vec<char> parities;
+    XorEngine::find(ca, candidates, xors, parities);
+
+    int nbFrozen = 0;
+    for (int x = 0; x < xors.size(); x++)
+        for (int i = 0; i < xors[x].size(); i++)
+            if (!frozen[xors[x][i]]) {
+                frozen[xors[x][i]] = true;
+                nbFrozen++;
+            }
+    return nbFrozen;
+}
+
+void Preprocessor::load(Solver& s) const {
+    s.initialiseMem(nVars(), remaining + trail.size());
+    while (s.nVars() < nVars()) s.newVar();
+    for (Var v = 0; v < nVars(); v++)
+        if (eliminated[v]) s.setDecisionVar(v, false);
+
+    vec<Lit> lits;
+    if (!ok) {
+        s.addClause(lits);
+        return;
+    }
+    for (int i = 0; i < trail.size(); i++) s.addClause(trail[i]);
+    for (int i = 0; i < clauses.size(); i++) {
+        const Clause& c = ca[clauses[i]];
+        if (c.mark()) continue;
+        lits.clear();
+        for (int k = 0; k < c.size(); k++) lits.push(c[k]);
+        s.addClause(lits);
+    }
+}
+
+void Preprocessor::extendModel(vec<lbool>& model) const {
+    // an eliminated variable without any clause left can take any value
+    model.growTo(nVars(), l_Undef);
+    for (Var v = 0; v < nVars(); v++)
+        if (eliminated[v] && model[v] == l_Undef) model[v] = l_False;
+
+    // the clauses are satisfied in the reverse order of the eliminations
+    int i, j;
+    for (i = elimclauses.size() - 1; i > 0; i -= j) {
+        bool satisfied = false;
+        for (j = elimclauses[i--]; j > 1 && !satisfied; j--, i--) {
+            Lit l = toLit(elimclauses[i]);
+            satisfied = (model[var(l)] ^ sign(l)) != l_False;
+        }
+        if (!satisfied) {
+            Lit x = toLit(elimclauses[i]);
+            model[var(x)] = lbool(!sign(x));
+        }
+    }
+}
+
+void Preprocessor::release() {
+    clauses.clear(true);
+    occurs.clear(true);
+    subsumptionQueue.clear(true);
+    elimHeap.clear(true);
+    ClauseAllocator(1, 1).moveTo(ca);
+}
@@ -0,0 +1,237 @@
+#include "penelope/core/Prober.h"
+
+using namespace penelope;
+
+namespace penelope {
+
+    /**
+     * Probe the share of the variables of each worker on its solver
+     */
+    class ProbeTask : public Task {
+    public:
+
+        ProbeTask(Prober& p, int n) : prober(p), nbWorkers(n) {
+        }
+
+        void execute(int worker) {
+            prober.probeShare(worker, nbWorkers);
+        }
+
+    private:
+        Prober& prober;
+        int nbWorkers;
+    };
+
+    /**
+     * Give the units found to the solver of each worker, and replace its
+     * variables by their representative
+     */
+    class SubstituteTask : public Task {
+    public:
+
+        SubstituteTask(Prober& p, const vec<Lit>& u, bool c, int n) :
+        prober(p), units(u), consistent(c), ok(n, true) {
+        }
+
+        void execute(int worker) {
+            Solver& s = prober.coop.solvers[worker];
+            if (!consistent) {
+                // a literal is equivalent to its negation
+                vec<Lit> empty;
+                ok[worker] = s.addClause(empty);
+                return;
+            }
+            for (int i = 0; i < units.size() && ok[worker]; i++) ok[worker] = s.addClause(units[i]);
+            if (ok[worker] && prober.equivalent > 0) ok[worker] = s.substitute(prober.representative);
+        }
+
+        Prober& prober;
+        /** The units found by the workers */
+        const vec<Lit>& units;
+        /** false if a literal is equivalent to its negation */
+        bool consistent;
+        /** false for the solvers whose formula became unsatisfiable */
+        vec<char> ok;
+    };
+
+}
+
+Prober::Prober(Cooperation& c) : coop(c), failures(), commons(), implications(), representative(),
+failed(0), implied(0), equivalent(0) {
+}
+
+void Prober::probeShare(int worker, int nbWorkers) {
+    Solver& s = coop.solvers[worker];
+    if (!s.okay()) return;
+    vec<Lit> positive, negative, indirect;
+    vec<char> seen(2 * s.nVars(), 0);
+    uint64_t budget = s.propagations + PROBE_BUDGET;
+
+    for (Var v = worker; v < s.nVars() && s.propagations < budget && !s.asynch_interrupt; v += nbWorkers) {
+        if (s.value(v) != l_Undef) continue;
+        Lit l = mkLit(v);
+        bool positiveOk = s.probe(l, positive, indirect);
+        for (int i = 0; i < indirect.size(); i++) {
+            implications[worker].push(l);
+            implications[worker].push(indirect[i]);
+        }
+        bool negativeOk = s.probe(~l, negative, indirect);
+        for (int i = 0; i < indirect.size(); i++) {
+            implications[worker].push(~l);
+            implications[worker].push(indirect[i]);
+        }
+
+        if (!positiveOk) failures[worker].push(~l);
+        if (!negativeOk) failures[worker].push(l);
+        if (!positiveOk || !negativeOk) continue;
+
+        // what both polarities imply holds anyway
+        for (int i = 0; i < positive.size(); i++) seen[toInt(positive[i])] = 1;
+        for (int i = 0; i < negative.size(); i++)
+            if (seen[toInt(negative[i])]) commons[worker].push(negative[i]);
+        for (int i = 0; i < positive.size(); i++) seen[toInt(positive[i])] = 0;
+    }
+}
+
+bool Prober::findEquivalences() {
+    const Solver& s = coop.solvers[0];
+    int nbLits = 2 * s.nVars();
+
+    // the implication graph: the binary clauses and the implications found
+    vec<Lit> edges;
+    for (int i = 0; i < s.nClauses(); i++) {
+        const Clause& c = coop.solvers[0].getClause(s.getOriginalClause(i));
+        Lit a = lit_Undef, b = lit_Undef;
+        int size = 0;
+        bool satisfied = false;
+        for (int k = 0; k < c.size() && !satisfied && size <= 2; k++) {
+            satisfied = s.value(c[k]) == l_True;
+            if (s.value(c[k]) != l_Undef) continue;
+            if (size++ == 0) a = c[k];
+            else b = c[k];
+        }
+        if (satisfied || size != 2) continue;
+        edges.push(~a), edges.push(b);
+        edges.push(~b), edges.push(a);
+    }
+    for (int w = 0; w < implications.size(); w++)
+        for (int i = 0; i < implications[w].size(); i += 2) {
+            Lit from = implications[w][i], to = implications[w][i + 1];
+            edges.push(from), edges.push(to);
+            edges.push(~to), edges.push(~from);
+        }
+
+    vec<int> start(nbLits + 1, 0);
+    for (int i = 0; i < edges.size(); i += 2) start[toInt(edges[i]) + 1]++;
+    for (int l = 0; l < nbLits; l++) start[l + 1] += start[l];
+    vec<int> fill(nbLits, 0);
+    vec<Lit> successors(edges.size() / 2);
+    for (int i = 0; i < edges.size(); i += 2) {
+        int l = toInt(edges[i]);
+        successors[start[l] + fill[l]++] = edges[i + 1];
+    }
+    edges.clear(true);
+
+    // Tarjan's algorithm, without recursion: a frame is a literal and the
+    // position of its next successor
+    vec<int> index(nbLits, -1), low(nbLits, 0);
+    vec<char> onStack(nbLits, 0);
+    vec<int> stack, frames, positions, stamp(s.nVars(), -1);
+    representative.clear();
+    for (Var v = 0; v < s.nVars(); v++) representative.push(mkLit(v));
+    int counter = 0;
+    bool consistent = true;
+
+    for (int root = 0; root < nbLits && consistent; root++) {
+        if (index[root] != -1 || start[root] == start[root + 1]) continue;
+        frames.push(root);
+        positions.push(start[root]);
+        index[root] = low[root] = counter++;
+        stack.push(root);
+        onStack[root] = 1;
+
+        while (frames.size() > 0) {
+            int l = frames.last();
+            if (positions.last() < start[l + 1]) {
+                int next = toInt(successors[positions.last()++]);
+                if (index[next] == -1) {
+                    frames.push(next);
+                    positions.push(start[next]);
+                    index[next] = low[next] = counter++;
+                    stack.push(next);
+                    onStack[next] = 1;
+                } else if (onStack[next] && index[next] < low[l]) {
+                    low[l] = index[next];
+                }
+                continue;
+            }
+
+            frames.pop();
+            positions.pop();
+            if (frames.size() > 0 && low[l] < low[frames.last()]) low[frames.last()] = low[l];
+            if (low[l] != index[l]) continue;
+
+            // l is the root of a component: its smallest variable represents it
+            int first = stack.size();
+            do {
+                onStack[stack[--first]] = 0;
+            } while (stack[first] != l);
+            Lit rep = toLit(stack[first]);
+            for (int i = first; i < stack.size(); i++) {
+                Lit member = toLit(stack[i]);
+                if (stamp[var(member)] == l) consistent = false;
+                stamp[var(member)] = l;
+                if (var(member) < var(rep)) rep = member;
+            }
+            // the component of the negations is found separately, with the
+            // negation of this representative
+            for (int i = first; i < stack.size(); i++) {
+                Lit member = toLit(stack[i]);
+                representative[var(member)] = rep ^ sign(member);
+            }
+            stack.shrink(stack.size() - first);
+        }
+    }
+
+    equivalent = 0;
+    for (Var v = 0; v < s.nVars(); v++)
+        if (representative[v] != mkLit(v)) equivalent++;
+    return consistent;
+}
+
+bool Prober::probe(Executor& executor) {
+    int nbWorkers = executor.nbWorkers();
+    failures.clear();
+    commons.clear();
+    implications.clear();
+    failures.growTo(nbWorkers);
+    commons.growTo(nbWorkers);
+    implications.growTo(nbWorkers);
+
+    ProbeTask probing(*this, nbWorkers);
+    executor.run(probing);
+
+    vec<Lit> units;
+    failed = implied = 0;
+    for (int w = 0; w < nbWorkers; w++) {
+        failed += failures[w].size();
+        implied += commons[w].size();
+        for (int i = 0; i < failures[w].size(); i++) units.push(failures[w][i]);
+        for (int i = 0; i < commons[w].size(); i++) units.push(commons[w][i]);
+    }
+    bool consistent = findEquivalences();
+    implications.clear(true);
+
+    SubstituteTask substitution(*this, units, consistent, nbWorkers);
+    executor.run(substitution);
+    for (int w = 0; w < nbWorkers; w++)
+        if (!substitution.ok[w]) return false;
+    return true;
+}
+
+void Prober::extendModel(vec<lbool>& model) const {
+    for (Var v = 0; v < representative.size(); v++) {
+        Lit rep = representative[v];
+        if (rep != mkLit(v)) model[v] = model[var(rep)] ^ sign(rep);
+    }
+}
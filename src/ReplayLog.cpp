@@ -0,0 +1,220 @@
+#include "penelope/core/ReplayLog.h"
+#include "penelope/core/Cooperation.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace penelope;
+
+/** The first word of the header of a replay log */
+#define REPLAY_LOG_MAGIC "penelope-replay"
+/** The version of the format of the replay log */
+#define REPLAY_LOG_VERSION 1
+
+/**
+ * Write a literal as in the DIMACS format
+ */
+static void writeLit(FILE* f, Lit l) {
+    fprintf(f, " %s%d", sign(l) ? "-" : "", var(l) + 1);
+}
+
+ReplayLog::ReplayLog() : file(NULL), replaying(false), recordedThread(0), recordedThreads(0),
+recordedMode(0), divergences(0), pendingCheckpoint(false), pendingConflicts(0),
+pendingPropagations(0), nextType(0), nextConflicts(0), nextPropagations(0), nextDecisions(0),
+nextProducer(0), nextLbd(0), nextLits() {
+}
+
+ReplayLog::~ReplayLog() {
+    if (file != NULL) fclose(file);
+}
+
+bool ReplayLog::record(const char* fileName, int thread, int nbThreads, int mode) {
+    file = fopen(fileName, "w");
+    if (file == NULL) return false;
+    replaying = false;
+    recordedThread = thread;
+    recordedThreads = nbThreads;
+    recordedMode = mode;
+    fprintf(file, "p %s %d thread %d threads %d mode %d\n", REPLAY_LOG_MAGIC,
+            REPLAY_LOG_VERSION, thread, nbThreads, mode);
+    return true;
+}
+
+bool ReplayLog::replay(const char* fileName) {
+    file = fopen(fileName, "r");
+    if (file == NULL) return false;
+    replaying = true;
+    char magic[32];
+    int version = 0;
+    if (fscanf(file, "p %31s %d thread %d threads %d mode %d", magic, &version,
+            &recordedThread, &recordedThreads, &recordedMode) != 5)
+        return false;
+    if (strcmp(magic, REPLAY_LOG_MAGIC) != 0 || version != REPLAY_LOG_VERSION) return false;
+    if (recordedThread < 0 || recordedThread >= recordedThreads) return false;
+    readEvent();
+    return true;
+}
+
+//=================================================================================================
+// Recording:
+
+void ReplayLog::checkpoint(const Solver* s, bool force) {
+    pendingCheckpoint = true;
+    pendingConflicts = s->conflicts;
+    pendingPropagations = s->propagations;
+    if (force) flushCheckpoint();
+}
+
+void ReplayLog::flushCheckpoint() {
+    if (!pendingCheckpoint) return;
+    fprintf(file, "S %lu %lu\n", pendingConflicts, pendingPropagations);
+    pendingCheckpoint = false;
+}
+
+void ReplayLog::importedClause(int producer, const Lit* lits, int lbd) {
+    flushCheckpoint();
+    int size = var(lits[0]);
+    fprintf(file, "C %d %d %d", producer, lbd, size);
+    for (int i = 1; i <= size; i++) writeLit(file, lits[i]);
+    fprintf(file, "\n");
+}
+
+void ReplayLog::importedUnit(int producer, Lit l) {
+    flushCheckpoint();
+    fprintf(file, "U %d", producer);
+    writeLit(file, l);
+    fprintf(file, "\n");
+}
+
+void ReplayLog::pressure(const Solver* s, int level) {
+    pendingCheckpoint = false;
+    fprintf(file, "P %lu %lu %d\n", s->conflicts, s->propagations, level);
+}
+
+void ReplayLog::restart(const Solver* s) {
+    pendingCheckpoint = false;
+    fprintf(file, "R %lu %lu %lu\n", s->conflicts, s->decisions, s->propagations);
+}
+
+void ReplayLog::end(const Solver* s) {
+    pendingCheckpoint = false;
+    fprintf(file, "E %lu %lu\n", s->conflicts, s->propagations);
+    fflush(file);
+}
+
+//=================================================================================================
+// Replaying:
+
+bool ReplayLog::readEvent() {
+    nextType = 0;
+    char type;
+    if (fscanf(file, " %c", &type) != 1) return false;
+
+    unsigned long conflicts = 0, propagations = 0, decisions = 0;
+    int read = 0;
+    switch (type) {
+        case 'S':
+        case 'E':
+            read = fscanf(file, "%lu %lu", &conflicts, &propagations) - 2;
+            break;
+        case 'P':
+            read = fscanf(file, "%lu %lu %d", &conflicts, &propagations, &nextLbd) - 3;
+            break;
+        case 'R':
+            read = fscanf(file, "%lu %lu %lu", &conflicts, &decisions, &propagations) - 3;
+            break;
+        case 'U':
+        {
+            int lit = 0;
+            read = fscanf(file, "%d %d", &nextProducer, &lit) - 2;
+            nextLits.clear();
+            nextLits.push(lit > 0 ? mkLit(lit - 1) : ~mkLit(-lit - 1));
+            break;
+        }
+        case 'C':
+        {
+            int size = 0;
+            read = fscanf(file, "%d %d %d", &nextProducer, &nextLbd, &size) - 3;
+            nextLits.clear();
+            nextLits.push(mkLit(size));
+            for (int i = 0; i < size && read == 0; i++) {
+                int lit = 0;
+                read = fscanf(file, "%d", &lit) - 1;
+                nextLits.push(lit > 0 ? mkLit(lit - 1) : ~mkLit(-lit - 1));
+            }
+            break;
+        }
+        default:
+            read = -1;
+    }
+    if (read != 0) {
+        fprintf(stderr, "c replay log: malformed event '%c'\n", type);
+        return false;
+    }
+    nextType = type;
+    nextConflicts = conflicts;
+    nextPropagations = propagations;
+    nextDecisions = decisions;
+    return true;
+}
+
+int ReplayLog::compareEvent(const Solver* s) const {
+    if (nextConflicts != s->conflicts) return nextConflicts < s->conflicts ? -1 : 1;
+    if (nextPropagations != s->propagations) return nextPropagations < s->propagations ? -1 : 1;
+    return 0;
+}
+
+void ReplayLog::diverge(const Solver* s, const char* what) {
+    if (divergences == 0)
+        printf("c replay: %s diverged at conflict %lu (recorded at conflict %lu, propagation %lu; "
+            "replayed propagation %lu)\n", what, s->conflicts, nextConflicts, nextPropagations,
+            s->propagations);
+    divergences++;
+}
+
+bool ReplayLog::replayImports(Solver* s, Cooperation* coop) {
+    // the restarts and the memory pressure happen after the propagation that
+    // follows a conflict: the ones still pending here were missed
+    while (nextType == 'P' || nextType == 'R') {
+        if (compareEvent(s) >= 0) break;
+        diverge(s, nextType == 'P' ? "memory pressure" : "restart");
+        readEvent();
+    }
+
+    if (nextType == 'S') {
+        // a synchronization point the replay went past is still imported,
+        // to stay as close as possible to the record
+        int cmp = compareEvent(s);
+        if (cmp > 0) return false;
+        if (cmp < 0) diverge(s, "synchronization");
+        readEvent();
+        while (nextType == 'C' || nextType == 'U') {
+            if (nextType == 'C')
+                coop->addExtraClause(s, nextProducer, &nextLits[0], nextLbd, NULL);
+            else
+                coop->storeExtraUnits(s, nextProducer, nextLits[0], s->extraUnits);
+            readEvent();
+        }
+    }
+
+    if (nextType == 'E' && compareEvent(s) <= 0) {
+        if (compareEvent(s) < 0) diverge(s, "end");
+        nextType = 0;
+        return true;
+    }
+    return nextType == 0;
+}
+
+int ReplayLog::replayPressure(const Solver* s) {
+    if (nextType != 'P' || nextConflicts > s->conflicts) return -1;
+    if (compareEvent(s) != 0) diverge(s, "memory pressure");
+    int level = nextLbd;
+    readEvent();
+    return level;
+}
+
+void ReplayLog::replayRestart(const Solver* s) {
+    if (nextType != 'R' || nextConflicts > s->conflicts) return;
+    if (compareEvent(s) != 0 || nextDecisions != s->decisions) diverge(s, "restart");
+    readEvent();
+}
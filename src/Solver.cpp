@@ -19,11 +19,11 @@
  **************************************************************************************************/
 
 #include <math.h>
-#include <omp.h>
 #include "penelope/utils/Sort.h"
 #include "penelope/core/Solver.h"
 #include "penelope/core/Cooperation.h"
 #include "penelope/core/Determanager.h"
+#include "penelope/core/XorEngine.h"
 #include <iostream>
 #include <sstream>
 
@@ -75,6 +75,9 @@ asynch_interrupt(false)
 , conflict()
 , nbClauseUsed(NULL)
 , nbClauseImported(NULL)
+, traceFates(NULL)
+, traceLatency(NULL)
+, traceConflictLag(NULL)
 , verbosity        (0)
 , var_decay(opt_var_decay)
 , clause_decay(opt_clause_decay)
@@ -101,6 +104,7 @@ asynch_interrupt(false)
 , threadId(-1) //The value will be set later by main
 , firstInterpretation(true)
 , deterministic_mode(0)
+, nextEpoch(0)
 , importedUnits()
 
 // Statistics: (formerly in 'SolverStats')
@@ -117,7 +121,11 @@ asynch_interrupt(false)
 , nbClausesNotLearnt(0)
 , rejectAtImport(false)
 , maxLBDAccepted(10)
+, strengthenImports(false)
+, nbImportsStrengthened(0)
+, nbImportLitsRemoved(0)
 , fphase(randomize)
+, configuration("default")
 , restartFactor(0.7)
 , historicLength(100)
 , trailAvgSize(5000)
@@ -129,6 +137,20 @@ asynch_interrupt(false)
 , widthRestartR(5)      
 , widthRestartW(10)
 , widthRestartC(1)
+, localSearchWorker(false)
+, divideWorker(false)
+, localSearchCb(2.38)
+, localSearchFlips(1000000)
+, localSearchPublish(100000)
+, useLocalSearchPhases(true)
+, rephaseInterval(0)
+, rephaseCycle("bobibr")
+, nbRephases(0)
+, vivifyBudget(0)
+, nbVivified(0)
+, nbVivifiedLits(0)
+, nbVivifiedExported(0)
+, useXor(false)
 
 , asyncStop(false)
 , maxFreeze(7)
@@ -153,6 +175,13 @@ asynch_interrupt(false)
 , savePolarity()
 , viewVariable()
 , hammingDistance(-1)
+, originalPolarity()
+, bestPolarity()
+, bestTrail(0)
+, nextRephase(0)
+, vivifyPending(false)
+, inprocessing(false)
+, xors(NULL)
 , lastDeviation(0.1)
 , nbNotAttachedDirectly(0)
 , decision()
@@ -185,9 +214,15 @@ asynch_interrupt(false)
 , conflict_budget(-1)
 , propagation_budget(-1)
 , nbExportedClauses(0)
+, profile()
+, counters()
+, nbLearntsSnapshot(0)
 , usePsm(true)
 , initLimit(INIT_LIMIT)
 , maxLBDExchanged(8)
+, configuredMaxLBDExchanged(8)
+, pressureReduceCut(0)
+, pressured(false)
 , maxLBD(20)
 , restartAvgLBD(true)
 , picoRestart(false)
@@ -207,14 +242,28 @@ Solver::~Solver() {
     if(nbClauseImported!=NULL){
         delete[](nbClauseImported);
     }
+    delete[](traceFates);
+    delete[](traceLatency);
+    delete[](traceConflictLag);
+    delete xors;
 }
 
 void Solver::initialize(Cooperation* coop, int t, const INIParser& parser){
     nbClauseUsed = new uint64_t[coop->nThreads()];
     nbClauseImported = new uint64_t[coop->nThreads()];
+    traceFates = new uint64_t[coop->nThreads() * TRACE_NB_FATES];
+    traceLatency = new uint64_t[coop->nThreads() * TRACE_LATENCY_BUCKETS];
+    traceConflictLag = new uint64_t[coop->nThreads()];
     for(int i=0; i<coop->nbThreads; i++){
         nbClauseImported[i] = 0;
         nbClauseUsed[i] = 0;
+        traceConflictLag[i] = 0;
+    }
+    for(int i=0; i<coop->nbThreads * TRACE_NB_FATES; i++){
+        traceFates[i] = 0;
+    }
+    for(int i=0; i<coop->nbThreads * TRACE_LATENCY_BUCKETS; i++){
+        traceLatency[i] = 0;
     }
 
     threadId = t;
@@ -225,6 +274,11 @@ void Solver::initialize(Cooperation* coop, int t, const INIParser& parser){
     if(!parser.configurationExist(solver)){
         solver = "default";
     }
+    configure(solver, parser);
+}
+
+void Solver::configure(const std::string& solver, const INIParser& parser){
+    configuration = solver;
 
     const std::string& usePsmStr(getValue(solver,"usePsm",parser));
     if(usePsmStr.length()>0){
@@ -264,6 +318,7 @@ void Solver::initialize(Cooperation* coop, int t, const INIParser& parser){
     if(maxLBDExchangeStr.length()>0){
         maxLBDExchanged = atoi(maxLBDExchangeStr.c_str());
     }
+    configuredMaxLBDExchanged = maxLBDExchanged;
 
     const std::string& maxLBDStr(getValue(solver,"maxLBD",parser));
     if(maxLBDStr.length()>0){
@@ -365,6 +420,15 @@ void Solver::initialize(Cooperation* coop, int t, const INIParser& parser){
         maxLBDAccepted = atoi(maxLBDAcceptedStr.c_str());
     }
 
+    const std::string& strengthenImportsStr(getValue(solver,"strengthenImports",parser));
+    if(strengthenImportsStr.length()>0){
+        if(strengthenImportsStr == std::string("true")){
+            strengthenImports = true;
+        }else if (strengthenImportsStr == std::string("false")){
+            strengthenImports = false;
+        }
+    }
+
     const std::string& lexicoFirstStr(getValue(solver,"lexicographicalFirstPropagation",parser));
     if(lexicoFirstStr.length()>0){
         if(lexicoFirstStr == std::string("true")){
@@ -430,6 +494,178 @@ void Solver::initialize(Cooperation* coop, int t, const INIParser& parser){
         widthRestartC = atoi(widthRestartCStr.c_str());
     }
 
+    const std::string& solverTypeStr(getValue(solver, "solverType", parser));
+    if(solverTypeStr.length() > 0){
+        if(solverTypeStr == std::string("cdcl")){
+            localSearchWorker = false;
+            divideWorker = false;
+        }else if (solverTypeStr == std::string("localsearch")){
+            localSearchWorker = true;
+            divideWorker = false;
+        }else if (solverTypeStr == std::string("divide")){
+            localSearchWorker = false;
+            divideWorker = true;
+        }else{
+            std::cerr << "Unknown value for \"solverType\" on configuration \"";
+            std::cerr << solver << "\". Allowed values are: cdcl/localsearch/divide";
+            std::cerr << std::endl;
+        }
+    }
+
+    const std::string& localSearchCbStr(getValue(solver, "localSearchCb", parser));
+    if(localSearchCbStr.length() > 0){
+        localSearchCb = atof(localSearchCbStr.c_str());
+    }
+
+    const std::string& localSearchFlipsStr(getValue(solver, "localSearchFlips", parser));
+    if(localSearchFlipsStr.length() > 0){
+        localSearchFlips = atoi(localSearchFlipsStr.c_str());
+    }
+
+    const std::string& localSearchPublishStr(getValue(solver, "localSearchPublish", parser));
+    if(localSearchPublishStr.length() > 0){
+        localSearchPublish = atoi(localSearchPublishStr.c_str());
+    }
+
+    const std::string& rephaseIntervalStr(getValue(solver, "rephaseInterval", parser));
+    if(rephaseIntervalStr.length() > 0){
+        rephaseInterval = atoi(rephaseIntervalStr.c_str());
+    }
+
+    const std::string& rephaseCycleStr(getValue(solver, "rephaseCycle", parser));
+    if(rephaseCycleStr.length() > 0){
+        if(rephaseCycleStr.find_first_not_of("bior") == std::string::npos){
+            rephaseCycle = rephaseCycleStr;
+        }else{
+            std::cerr << "Unknown value for \"rephaseCycle\" on configuration \"";
+            std::cerr << solver << "\". Allowed letters are: b/i/o/r";
+            std::cerr << std::endl;
+        }
+    }
+
+    const std::string& vivifyStr(getValue(solver, "vivify", parser));
+    if(vivifyStr.length() > 0){
+        vivifyBudget = atoi(vivifyStr.c_str());
+    }
+
+    const std::string& xorStr(getValue(solver, "xor", parser));
+    if(xorStr.length() > 0){
+        if(xorStr == std::string("true")){
+            useXor = true;
+        }else if (xorStr == std::string("false")){
+            useXor = false;
+        }
+    }
+
+    const std::string& localSearchPhasesStr(getValue(solver, "localSearchPhases", parser));
+    if(localSearchPhasesStr.length() > 0){
+        if(localSearchPhasesStr == std::string("true")){
+            useLocalSearchPhases = true;
+        }else if (localSearchPhasesStr == std::string("false")){
+            useLocalSearchPhases = false;
+        }
+    }
+
+}
+
+void Solver::getPolarities(vec<char>& phases) const {
+    polarity.copyTo(phases);
+}
+
+void Solver::setPolarities(const vec<char>& phases) {
+    for (int v = 0; v < phases.size() && v < polarity.size(); v++)
+        if (value(v) == l_Undef) polarity[v] = phases[v];
+    // the deviation is measured from the new polarities
+    polarity.copyTo(savePolarity);
+    hammingDistance = 0;
+}
+
+void Solver::getBestPolarities(vec<char>& phases) const {
+    bestPolarity.copyTo(phases);
+}
+
+void Solver::saveBestTrail() {
+    for (int i = 0; i < trail.size(); i++) bestPolarity[var(trail[i])] = sign(trail[i]);
+    bestTrail = trail.size();
+}
+
+void Solver::rephase(Cooperation* coop) {
+    char kind = rephaseCycle[nbRephases % rephaseCycle.size()];
+    nbRephases++;
+    nextRephase = conflicts + (uint64_t) rephaseInterval * (nbRephases + 1);
+
+    // the longest trail of the portfolio depends on the speed of the
+    // threads: the deterministic, recorded and replayed threads use their own
+    bool shared = deterministic_mode == 0 && coop->recorder(threadId) == NULL
+            && coop->replayer(threadId) == NULL;
+    if (shared) coop->publishBestTrail(this);
+
+    vec<char> phases;
+    switch (kind) {
+        case 'b':
+        case 'i':
+            if (!shared || !coop->fetchBestTrail(phases)) bestPolarity.copyTo(phases);
+            if (kind == 'i')
+                for (int v = 0; v < phases.size(); v++) phases[v] = !phases[v];
+            break;
+        case 'o':
+            originalPolarity.copyTo(phases);
+            break;
+        case 'r':
+            phases.growTo(nVars());
+            for (int v = 0; v < nVars(); v++) phases[v] = drand(random_seed, threadId) > 0.5;
+            break;
+    }
+    setPolarities(phases);
+    bestTrail = 0;
+}
+
+void Solver::splitGuidingPath(Cooperation* coop) {
+    Lit first = trail[trail_lim[assumptions.size()]];
+    vec<Lit> path;
+    assumptions.copyTo(path);
+    path.push(~first);
+    assumptions.push(first);
+    coop->guidingPaths.split(path);
+}
+
+lbool Solver::solveGuidingPaths(Cooperation* coop) {
+    GuidingPaths& paths = coop->guidingPaths;
+    vec<Lit> path;
+    for (;;) {
+        for (int t = 0; t < coop->nThreads(); t++)
+            if (coop->answer(t) != l_Undef) return coop->answer(t);
+        if (asynch_interrupt || coop->isStopped(threadId)) return l_Undef;
+
+        GuidingPaths::Status status = paths.take(path);
+        if (status == GuidingPaths::PATH_EXHAUSTED) {
+            coop->answers[threadId] = l_False;
+            return l_False;
+        }
+        if (status == GuidingPaths::PATH_NONE) continue;
+
+        lbool ret = solveLimited(path, coop);
+        if (ret == l_Undef) {
+            // the splits extended the assumptions
+            paths.release(assumptions);
+            return l_Undef;
+        }
+        // a model, or a refutation of the whole formula
+        if (ret == l_True || conflict.size() == 0) return ret;
+
+        // the final conflict only contains negated assumptions: it holds
+        // whatever the path
+        paths.refute(conflict);
+        if (conflict.size() == 1) {
+            coop->exportExtraUnit(this, conflict[0]);
+            if (!addClause(conflict[0])) {
+                coop->answers[threadId] = l_False;
+                return l_False;
+            }
+        } else {
+            coop->exportExtraClause(this, conflict, conflict.size());
+        }
+    }
 }
 
 void Solver::getProvenLiterals(vec<Lit>& provenLits) const {
@@ -470,6 +706,8 @@ void Solver::initialiseMem(int nbVar, int ){
     permDiff.capacity(nbVar);
     polarity.capacity(nbVar);
     savePolarity.capacity(nbVar);
+    originalPolarity.capacity(nbVar);
+    bestPolarity.capacity(nbVar);
     viewVariable.capacity(nbVar);
     trail.capacity(nbVar);
     //clauses.capacity(nbClauses);
@@ -492,6 +730,8 @@ Var Solver::newVar(bool sign, bool dvar) {
     }
     polarity.push(sign);
     savePolarity .push(sign);
+    originalPolarity.push(sign);
+    bestPolarity .push(sign);
     viewVariable .push(false);
     decision .push();
     trail .capacity(v + 1);
@@ -582,6 +822,7 @@ bool Solver::satisfied(const Clause& c) const {
 
 void Solver::cancelUntil(int aLevel) {
     if (decisionLevel() > aLevel) {
+        if (xors != NULL) xors->backtrack(trail_lim[aLevel]);
         for (int c = trail.size() - 1; c >= trail_lim[aLevel]; c--) {
             Var x = var(trail[c]);
             assigns [x] = l_Undef;
@@ -660,6 +901,7 @@ Lit Solver::pickBranchLit() {
  |  
  |________________________________________________________________________________________________@*/
 void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, unsigned int& lbd) {
+    PROFILE_PHASE(profile, PROFILE_ANALYZE);
     int pathC = 0;
     Lit p = lit_Undef;
     vec<Lit> lastDecisionLevel;
@@ -702,6 +944,9 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, unsigne
         while (!seen[var(trail[index--])]);
         p = trail[index + 1];
         confl = reason(var(p));
+        // the reason of a literal implied by a XOR constraint is built on
+        // demand, the UIP does not need one
+        if (confl == CRef_Undef && xors != NULL && pathC > 1) confl = xors->reason(var(p));
         seen[var(p)] = 0;
         pathC--;
     } while (pathC > 0);
@@ -719,20 +964,16 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, unsigne
 
     max_literals += out_learnt.size();
     out_learnt.shrink(i - j);
-    tot_literals += out_learnt.size();
     
     // Find the LBD measure 
-    lbd = 0;
-    lbdHelperCounter++;
-    for(int tmpI=0;tmpI<out_learnt.size();tmpI++)
-    {
-        
-        int l = level(var(out_learnt[tmpI]));
-        if (permDiff[l] != lbdHelperCounter) {
-            permDiff[l] = lbdHelperCounter;
-            lbd++;
-        }
-    }
+    lbd = computeLBD(out_learnt);
+
+    // Minimize the small clauses with the binary clauses of the asserting
+    // literal (see Glucose 2.1)
+    if (out_learnt.size() <= MINIMIZE_BINARY_SIZE && lbd <= MINIMIZE_BINARY_LBD
+            && binaryMinimize(out_learnt))
+        lbd = computeLBD(out_learnt);
+    tot_literals += out_learnt.size();
 
     // Find correct backtrack level:
     //
@@ -804,6 +1045,45 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels) {
     return true;
 }
 
+unsigned int Solver::computeLBD(const vec<Lit>& lits) {
+    unsigned int nblevels = 0;
+    lbdHelperCounter++;
+    for (int i = 0; i < lits.size(); i++) {
+        int l = level(var(lits[i]));
+        if (permDiff[l] != lbdHelperCounter) {
+            permDiff[l] = lbdHelperCounter;
+            nblevels++;
+        }
+    }
+    return nblevels;
+}
+
+bool Solver::binaryMinimize(vec<Lit>& out_learnt) {
+    // the literals of the clause, but the asserting one
+    lbdHelperCounter++;
+    for (int i = 1; i < out_learnt.size(); i++) permDiff[var(out_learnt[i])] = lbdHelperCounter;
+
+    // p, the negation of the asserting literal, implies the negation of
+    // the literals whose mark is decremented
+    Lit p = ~out_learnt[0];
+    const vec<Watcher>& ws = watches.lookup(p);
+    int nb = 0;
+    for (int k = 0; k < ws.size(); k++) {
+        Lit imp = ws[k].blocker;
+        if (permDiff[var(imp)] == lbdHelperCounter && value(imp) == l_True && ca[ws[k].cref].size() == 2) {
+            nb++;
+            permDiff[var(imp)] = lbdHelperCounter - 1;
+        }
+    }
+    if (nb == 0) return false;
+
+    int i, j;
+    for (i = j = 1; i < out_learnt.size(); i++)
+        if (permDiff[var(out_learnt[i])] == lbdHelperCounter) out_learnt[j++] = out_learnt[i];
+    out_learnt.shrink(i - j);
+    return true;
+}
+
 /*_________________________________________________________________________________________________
  |
  |  analyzeFinal : (p : Lit)  ->  [void]
@@ -825,11 +1105,13 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict) {
     for (int i = trail.size() - 1; i >= trail_lim[0]; i--) {
         Var x = var(trail[i]);
         if (seen[x]) {
-            if (reason(x) == CRef_Undef) {
+            CRef r = reason(x);
+            if (r == CRef_Undef && xors != NULL) r = xors->reason(x);
+            if (r == CRef_Undef) {
                 ASSERT_TRUE(level(x) > 0);
                 out_conflict.push(~trail[i]);
             } else {
-                Clause& c = ca[reason(x)];
+                Clause& c = ca[r];
                 for (int j = 1; j < c.size(); j++)
                     if (level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
@@ -866,6 +1148,18 @@ void Solver::uncheckedEnqueue(Lit p, CRef from) {
  |      * the propagation queue is empty, even if there was a conflict.
  |________________________________________________________________________________________________@*/
 CRef Solver::propagate(Cooperation* coop) {
+    CRef confl = propagateClauses(coop);
+    while (xors != NULL && confl == CRef_Undef) {
+        int assigned = trail.size();
+        confl = xors->propagate();
+        if (confl != CRef_Undef || trail.size() == assigned) break;
+        confl = propagateClauses(coop);
+    }
+    return confl;
+}
+
+CRef Solver::propagateClauses(Cooperation* coop) {
+    PROFILE_PHASE(profile, PROFILE_PROPAGATE);
     CRef confl = CRef_Undef;
     int num_props = 0;
     watches.cleanAll();
@@ -924,6 +1218,7 @@ CRef Solver::propagate(Cooperation* coop) {
                 }
                 c.setUsedOnce();
                 nbClauseUsed[c.getGenerator()]++;
+                if(c.isTraced()) traceFate(c, TRACE_USED);
             }
             
             if (value(first) == l_False) {
@@ -940,7 +1235,7 @@ CRef Solver::propagate(Cooperation* coop) {
                 }
                 uncheckedEnqueue(first, cr);
                 // DYNAMIC NBLEVEL trick (see competition '09 companion paper)
-                if (c.learnt() && c.lbd() > 3) {
+                if (c.learnt() && c.lbd() > 3 && !inprocessing) {
                     lbdHelperCounter++;
                     unsigned int nblevels = 0;
                     for (int tmpI = 0; tmpI < c.size(); tmpI++) {
@@ -990,6 +1285,7 @@ struct reduceDB_lt {
  |    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
  |________________________________________________________________________________________________@*/
 void Solver::reduceDB() {
+    PROFILE_PHASE(profile, PROFILE_REDUCE);
     int i, j;
     int nbAtt = 0;
     int nbDettached = 0;
@@ -1062,6 +1358,7 @@ void Solver::reduceDB() {
                     if (c.isAttached()) {
                         detachClause(learnts[i], true);
                         nbDettached++;
+                        if (c.isTraced()) traceFate(c.getGenerator(), TRACE_FROZEN);
                     }
                     if (c.getNbFreezeLeft() == 0 || c.lbd() > maxLBD) {
                         // delete clause
@@ -1071,7 +1368,9 @@ void Solver::reduceDB() {
                         }
                         if(c.getGenerator() != threadId && c.getNbAttach()==0){
                             nbClausesNeverAttached++;
+                            if (c.isTraced()) traceFate(c, TRACE_NEVER_ATTACHED);
                         }
+                        if (c.isTraced()) traceFate(c, TRACE_DELETED_UNUSED);
                         ca.free(learnts[i]);
                         continue;
                     }
@@ -1098,6 +1397,7 @@ void Solver::reduceDB() {
                 removeClause(learnts[i]);
                 if (c.getGenerator() != threadId && !c.getUsedOnce()) {
                     nbImportedDeletedNoUse++;
+                    if (c.isTraced()) traceFate(c, c.getNbAttach() == 0 ? TRACE_NEVER_ATTACHED : TRACE_DELETED_UNUSED);
                 }
             } else {
                 learnts[j++] = learnts[i];
@@ -1161,6 +1461,178 @@ bool Solver::simplify(Cooperation* coop) {
     return true;
 }
 
+bool Solver::probe(Lit p, vec<Lit>& implied, vec<Lit>& indirect) {
+    ASSERT_EQUAL(0, decisionLevel());
+    ASSERT_TRUE(value(p) == l_Undef);
+    implied.clear();
+    indirect.clear();
+    double savedAgility = agility;
+    inprocessing = true;
+
+    newDecisionLevel();
+    uncheckedEnqueue(p);
+    bool failed = propagate() != CRef_Undef;
+    for (int i = trail_lim[0] + 1; i < trail.size() && !failed; i++) {
+        implied.push(trail[i]);
+        CRef r = reason(var(trail[i]));
+        if (r != CRef_Undef && ca[r].size() > 2) indirect.push(trail[i]);
+    }
+
+    cancelProbe();
+    inprocessing = false;
+    agility = savedAgility;
+    return !failed;
+}
+
+void Solver::cancelProbe() {
+    // unlike cancelUntil, the saved polarities are left untouched
+    if (xors != NULL) xors->backtrack(trail_lim[0]);
+    for (int c = trail.size() - 1; c >= trail_lim[0]; c--) {
+        assigns[var(trail[c])] = l_Undef;
+        insertVarOrder(var(trail[c]));
+    }
+    qhead = trail_lim[0];
+    trail.shrink(trail.size() - trail_lim[0]);
+    trail_lim.shrink(trail_lim.size());
+}
+
+struct vivify_lt {
+    ClauseAllocator& ca;
+    vivify_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) {
+        return ca[x].lbd() < ca[y].lbd() || (ca[x].lbd() == ca[y].lbd() && ca[x].activity() > ca[y].activity()); }
+};
+
+bool Solver::vivify(Cooperation* coop) {
+    ASSERT_EQUAL(0, decisionLevel());
+    vivifyPending = false;
+    if (!ok) return false;
+
+    vec<CRef> candidates;
+    for (int i = 0; i < learnts.size(); i++) {
+        const Clause& c = ca[learnts[i]];
+        if (c.isAttached() && !c.isVivified() && c.size() > 2 && (c.lbd() <= VIVIFY_LBD || c.isUsed())
+                && !satisfied(c))
+            candidates.push(learnts[i]);
+    }
+    sort(candidates, vivify_lt(ca));
+
+    double savedAgility = agility;
+    inprocessing = true;
+    uint64_t budget = propagations + vivifyBudget;
+    vec<Lit> lits, clause;
+    bool removed = false;
+    for (int i = 0; i < candidates.size() && propagations < budget && !asynch_interrupt; i++) {
+        CRef cr = candidates[i];
+        ca[cr].setVivified();
+        if (satisfied(ca[cr])) continue;
+        detachClause(cr, true);
+        // the propagations may allocate clauses, moving the arena: the
+        // clause is only accessed through its reference once they are done
+        clause.clear();
+        for (int k = 0; k < ca[cr].size(); k++) clause.push(ca[cr][k]);
+
+        newDecisionLevel();
+        lits.clear();
+        for (int k = 0; k < clause.size(); k++) {
+            Lit l = clause[k];
+            if (value(l) == l_False) continue;
+            lits.push(l);
+            // the negation of the previous literals implies l
+            if (value(l) == l_True) break;
+            uncheckedEnqueue(~l);
+            if (propagate() != CRef_Undef) break;
+        }
+        cancelProbe();
+
+        if (lits.size() == clause.size()) {
+            int nbAttach = ca[cr].getNbAttach();
+            attachClause(cr);
+            ca[cr].setNbAttach(nbAttach);
+            continue;
+        }
+        nbVivified++;
+        nbVivifiedLits += clause.size() - lits.size();
+
+        if (lits.size() <= 1) {
+            removeClause(cr);
+            removed = true;
+            if (lits.size() == 1) uncheckedEnqueue(lits[0]);
+            if (lits.size() == 0 || propagate() != CRef_Undef) {
+                ok = false;
+                break;
+            }
+            continue;
+        }
+
+        Clause& c = ca[cr];
+        unsigned int lbd = c.lbd();
+        for (int k = 0; k < lits.size(); k++) c[k] = lits[k];
+        ca.shrink(cr, c.size() - lits.size());
+        if (c.lbd() > (unsigned int) c.size()) c.lbd(c.size());
+        int nbAttach = c.getNbAttach();
+        attachClause(cr);
+        c.setNbAttach(nbAttach);
+        if (exportPolicy == EXCHANGE_LBD && coop->limitszClauses() > 0
+                && lbd > (unsigned int) maxLBDExchanged && c.lbd() <= (unsigned int) maxLBDExchanged) {
+            coop->exportExtraClause(this, c);
+            nbVivifiedExported++;
+        }
+    }
+    inprocessing = false;
+    agility = savedAgility;
+
+    if (removed) {
+        int i, j;
+        for (i = j = 0; i < learnts.size(); i++)
+            if (ca[learnts[i]].mark() != 1) learnts[j++] = learnts[i];
+        learnts.shrink(i - j);
+    }
+    // the units found are exported
+    if (ok && trail.size() > tailUnitLit) {
+        vec<Lit> none;
+        exportClause(coop, none, 1);
+    }
+    return ok;
+}
+
+bool Solver::substitute(const vec<Lit>& representative) {
+    ASSERT_EQUAL(0, decisionLevel());
+    if (!ok) return false;
+
+    // the clauses with a replaced variable are removed, then added again
+    vec<Lit> replaced;
+    vec<int> positions;
+    int i, j;
+    for (i = j = 0; i < clauses.size(); i++) {
+        const Clause& c = ca[clauses[i]];
+        bool changed = false;
+        for (int k = 0; k < c.size() && !changed; k++)
+            changed = representative[var(c[k])] != mkLit(var(c[k]));
+        if (!changed) {
+            clauses[j++] = clauses[i];
+            continue;
+        }
+        positions.push(replaced.size());
+        for (int k = 0; k < c.size(); k++)
+            replaced.push(representative[var(c[k])] ^ sign(c[k]));
+        removeClause(clauses[i]);
+    }
+    clauses.shrink(i - j);
+    positions.push(replaced.size());
+
+    for (Var v = 0; v < nVars(); v++)
+        if (representative[v] != mkLit(v)) setDecisionVar(v, false);
+
+    vec<Lit> lits;
+    for (int c = 0; c + 1 < positions.size(); c++) {
+        lits.clear();
+        for (int k = positions[c]; k < positions[c + 1]; k++) lits.push(replaced[k]);
+        if (!addClause_(lits)) return false;
+    }
+    return true;
+}
+
 /*_________________________________________________________________________________________________
  |
  |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -1216,6 +1688,8 @@ lbool Solver::search(int nof_conflicts, Cooperation* coop) {
                 goto switchMode;
             }
             
+            if (rephaseInterval > 0 && trail.size() > bestTrail) saveBestTrail();
+
             trailAvg.push(trail.size());
             if( conflicts>nbConfBeforeRestartDelay && lbdLocalAvg.isvalid()  
                     && trail.size()>trailAvgFactor*trailAvg.getavg()) {
@@ -1274,6 +1748,7 @@ switchMode:
             }
             //Cooperation- switch deterministic mode barrier or not
             answer = importClauses(coop);
+            atomicStore(&nbLearntsSnapshot, learnts.size());
             if (answer != l_Undef) return answer;
             if(asyncStop){
                 return l_Undef;
@@ -1292,6 +1767,7 @@ switchMode:
             if (controlReduce < 0){
 
                 controlReduce = (currentLimit += controlReduceIncrement);
+                pressureReduceCut = 0;
                 int cpt = 0;
                 for (int i = 0; i < viewVariable.size(); i++) {
                     if (viewVariable[i]) {
@@ -1300,14 +1776,19 @@ switchMode:
                     }
                 }
                 // Reached bound on number of conflicts:
-                progress_estimate = progressEstimate();
+                atomicStore(&progress_estimate, progressEstimate());
                 //fprintf(stderr, "Deviation = %lf\n", (double) hammingDistance / (double) cpt);
                 if (minDeviation > (double) hammingDistance / (double) cpt)
                     minDeviation = (double) hammingDistance / (double) cpt;
                 // Reduce the set of learned clauses:
                 lastDeviation = (minDeviation < 0.01) ? 0.1 : minDeviation;
+                counters.switchTo(COUNTERS_REDUCE);
                 reduceDB();
+                counters.switchTo(COUNTERS_SEARCH);
                 ++nbReduce;
+                vivifyPending = vivifyBudget > 0;
+                atomicStore(&nbLearntsSnapshot, learnts.size());
+                coop->updateMemoryUsage(this);
             }
 
             // NO CONFLICT
@@ -1323,7 +1804,7 @@ switchMode:
             if ( restart ){
                 lbdLocalAvg.fastclear();
                 // Reached bound on number of conflicts:
-                progress_estimate = progressEstimate();
+                atomicStore(&progress_estimate, progressEstimate());
                 cancelUntil(0);
                 return l_Undef;
 	    }
@@ -1333,6 +1814,14 @@ switchMode:
                 return l_False;
             }
 
+            // Vivify the learnt clauses kept by the last reduction:
+            if (vivifyPending && decisionLevel() == 0 && !vivify(coop)){
+                return l_False;
+            }
+
+            if (divideWorker && decisionLevel() > assumptions.size() && coop->guidingPaths.wanted())
+                splitGuidingPath(coop);
+
             Lit next = lit_Undef;
             while (decisionLevel() < assumptions.size()) {
                 // Perform user provided assumption:
@@ -1414,12 +1903,21 @@ static double luby(double y, int x) {
 // NOTE: assumptions passed in member-variable 'assumptions'.
 
 lbool Solver::solve_(Cooperation* coop) {
+    PROFILE_PHASE(profile, PROFILE_SOLVE);
     model.clear();
     conflict.clear();
-    
+
+    if (useXor && xors == NULL && ok && decisionLevel() == 0) {
+        // the XOR constraints of the formula left by the simplifications
+        xors = new XorEngine(*this);
+        xors->recover();
+        ok = propagate(coop) == CRef_Undef;
+    }
     
     if (!ok){
         coop->answers[threadId] = l_False;
+        if (deterministic_mode) coop->finishSearch(threadId);
+        if (ReplayLog* log = coop->recorder(threadId)) log->end(this);
         return l_False;
     }
 
@@ -1441,12 +1939,15 @@ lbool Solver::solve_(Cooperation* coop) {
     learntsize_adjust_confl = learntsize_adjust_start_confl;
     learntsize_adjust_cnt = (int) learntsize_adjust_confl;
     lbool status = l_Undef;
+    coop->publishMemory(this);
+    nextRephase = conflicts + rephaseInterval;
 
 
     // Search:
     int nbRestartsPerformed = 0;
     int nbMaxConflicts = picobase;
     int nbRestBefIncWidth = widthRestartR;
+    counters.start(COUNTERS_SEARCH);
     while (status == l_Undef) {
         if(!picoRestart){
             double rest_base = luby_restart ?
@@ -1455,6 +1956,12 @@ lbool Solver::solve_(Cooperation* coop) {
         }
         status = search(nbMaxConflicts, coop);
         if (!withinBudget()||asyncStop) break;
+        if (status == l_Undef) {
+            if (ReplayLog* log = coop->recorder(threadId)) log->restart(this);
+            if (ReplayLog* log = coop->replayer(threadId)) log->replayRestart(this);
+            if (coop->nbLocalSearch > 0) coop->exchangePhases(this);
+            if (rephaseInterval > 0 && conflicts >= nextRephase) rephase(coop);
+        }
         if(picoRestart){
             nbMaxConflicts += picobase;
             if(nbMaxConflicts>picolimit){
@@ -1471,6 +1978,7 @@ lbool Solver::solve_(Cooperation* coop) {
         }
         nbRestartsPerformed++;
     }
+    counters.stop();
 
     int polSize = polarity.size();
     for(int i = 0 ; i<polSize ; i++) savePolarity[i] = polarity[i];
@@ -1488,6 +1996,9 @@ lbool Solver::solve_(Cooperation* coop) {
         ok = false;
 
     cancelUntil(0);
+    // the other solvers must not wait for this one anymore
+    if (deterministic_mode) coop->finishSearch(threadId);
+    if (ReplayLog* log = coop->recorder(threadId)) log->end(this);
     return status;
 }
 //=================================================================================================
@@ -1568,7 +2079,7 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& ) {
 //=================================================================================================
 // Garbage Collection methods:
 
-void Solver::relocAll(ClauseAllocator& to) {
+void Solver::relocAll(ClauseAllocator& to, bool onlyLearnts) {
     // All watchers:
     //
     // for (int i = 0; i < watches.size(); i++)
@@ -1579,7 +2090,8 @@ void Solver::relocAll(ClauseAllocator& to) {
             // printf(" >>> RELOCING: %s%d\n", sign(p)?"-":"", var(p)+1);
             vec<Watcher>& ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
-                ca.reloc(ws[j].cref, to);
+                if (onlyLearnts) ca.relocLearnt(ws[j].cref, to);
+                else ca.reloc(ws[j].cref, to);
         }
 
     // All reasons:
@@ -1589,7 +2101,8 @@ void Solver::relocAll(ClauseAllocator& to) {
 
         if (reason(v) != CRef_Undef &&
                 (ca[reason(v)].reloced() || locked(ca[reason(v)]))){
-            ca.reloc(vardata[v].reason, to);
+            if (onlyLearnts) ca.relocLearnt(vardata[v].reason, to);
+            else ca.reloc(vardata[v].reason, to);
         }
     }
 
@@ -1599,8 +2112,13 @@ void Solver::relocAll(ClauseAllocator& to) {
         ca.reloc(learnts[i], to);
     }
 
+    // The last conflicting XOR constraint:
+    //
+    if (xors != NULL) xors->relocated();
+
     // All original:
     //
+    if (onlyLearnts) return;
     for (int i = 0; i < clauses.size(); i++){
         ca.reloc(clauses[i], to);
     }
@@ -1609,18 +2127,130 @@ void Solver::relocAll(ClauseAllocator& to) {
 }
 
 void Solver::garbageCollect() {
+    PROFILE_PHASE(profile, PROFILE_GC);
+    // Problem clauses are only removed by 'simplify', so most of the garbage lies in the learnt
+    // region. Unless the problem region is itself too fragmented, only the learnt region is
+    // compacted: the pause is then proportional to the live learnt clauses, not to the whole heap.
+    bool onlyLearnts = ca.problemWasted() <= ca.problemSize() * garbage_frac;
+
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
-    ClauseAllocator to(ca.size() - ca.wasted());
+    ClauseAllocator to(onlyLearnts ? 0 : ca.problemSize() - ca.problemWasted(),
+            ca.learntSize() - ca.learntWasted());
 
-    relocAll(to);
+    uint32_t before = onlyLearnts ? ca.learntSize() : ca.size();
+    relocAll(to, onlyLearnts);
     if (verbosity >= 2){
-        printf("c |  Garbage collection:   %12d bytes => %12d bytes             |\n",
-            ca.size() * ClauseAllocator::Unit_Size, to.size() * ClauseAllocator::Unit_Size);
+        printf("c |  Garbage collection (%s):   %12d bytes => %12d bytes             |\n",
+            onlyLearnts ? "learnts" : "full", before * ClauseAllocator::Unit_Size,
+            to.size() * ClauseAllocator::Unit_Size);
+    }
+    if (onlyLearnts) to.moveLearntsTo(ca);
+    else to.moveTo(ca);
+}
+
+uint64_t Solver::memoryFootprint() {
+    MemoryBreakdown mem;
+    memoryBreakdown(mem);
+    return mem.total();
+}
+
+void Solver::memoryBreakdown(MemoryBreakdown& mem) {
+    mem.arenaWasted = (uint64_t) ca.wasted() * ClauseAllocator::Unit_Size;
+    mem.arenaLive = (uint64_t) ca.size() * ClauseAllocator::Unit_Size - mem.arenaWasted;
+    mem.watches = (uint64_t) nVars() * sizeof(vec<Watcher>) * 2;
+    for (int i = 0; i < 2 * nVars(); i++)
+        mem.watches += watches[toLit(i)].capacity() * sizeof(Watcher);
+    mem.clauseLists = (uint64_t) (clauses.capacity() + learnts.capacity()) * sizeof(CRef);
+    mem.trail = (uint64_t) trail.capacity() * sizeof(Lit) + trail_lim.capacity() * sizeof(int);
+    mem.varData = (uint64_t) assigns.capacity() * sizeof(lbool)
+            + (uint64_t) vardata.capacity() * sizeof(VarData)
+            + (uint64_t) activity.capacity() * sizeof(double)
+            + (uint64_t) (polarity.capacity() + savePolarity.capacity() + viewVariable.capacity()
+            + originalPolarity.capacity() + bestPolarity.capacity()
+            + decision.capacity() + seen.capacity()) * sizeof(char)
+            + (uint64_t) permDiff.capacity() * sizeof(int)
+            + (uint64_t) nVars() * 2 * sizeof(int); // the order heap
+}
+
+void Solver::applyMemoryPressure() {
+    pressured = true;
+    // Only the most useful clauses are still exported
+    if (maxLBDExchanged > 2) maxLBDExchanged--;
+    // and the learnt clause database is reduced sooner
+    if (controlReduce > 0) {
+        pressureReduceCut += controlReduce - controlReduce / 2;
+        controlReduce /= 2;
     }
-    to.moveTo(ca);
 }
 
+bool Solver::releaseMemoryPressure() {
+    if (!pressured) return false;
+    pressured = false;
+    maxLBDExchanged = configuredMaxLBDExchanged;
+    controlReduce += pressureReduceCut;
+    pressureReduceCut = 0;
+    return true;
+}
+
+void Solver::reconfigure(const std::string& conf, const INIParser& parser, int keptLBD) {
+    cancelUntil(0);
+    // the new configuration starts from its own values
+    releaseMemoryPressure();
+
+    // only the learnt clauses that are likely to help any configuration are
+    // kept, the units stay on the trail
+    int j = 0;
+    for (int i = 0; i < learnts.size(); i++) {
+        if ((int) ca[learnts[i]].lbd() <= keptLBD) learnts[j++] = learnts[i];
+        else removeClause(learnts[i]);
+    }
+    learnts.shrink(learnts.size() - j);
+    watches.cleanAll();
+    garbageCollect();
+
+    configure(conf, parser);
+
+    // the new configuration starts its own search
+    for (Var v = 0; v < nVars(); v++) {
+        activity[v] = 0;
+        switch (fphase){
+            case allFalse: {polarity[v] = false;break;}
+            case allTrue: {polarity[v] = true;break;}
+            case randomize: {polarity[v] = drand(random_seed, threadId) > 0.5;break;}
+        }
+        savePolarity[v] = polarity[v];
+        originalPolarity[v] = polarity[v];
+        bestPolarity[v] = polarity[v];
+    }
+    bestTrail = 0;
+    nbRephases = 0;
+    var_inc = 1;
+    rebuildOrderHeap();
+    controlReduce = initLimit;
+    asyncStop = false;
+    atomicStore(&nbLearntsSnapshot, learnts.size());
+}
+
+void Solver::releaseLearnts() {
+    cancelUntil(0);
+    for (int i = 0; i < learnts.size(); i++)
+        removeClause(learnts[i]);
+    learnts.clear(true);
+    watches.cleanAll();
+    garbageCollect();
+}
+
+void Solver::snapshot(SolverSnapshot& snap) const {
+    snap.conflicts = atomicLoad(&conflicts);
+    snap.propagations = atomicLoad(&propagations);
+    snap.decisions = atomicLoad(&decisions);
+    snap.restarts = atomicLoad(&starts);
+    snap.learnts = atomicLoad(&nbLearntsSnapshot);
+    snap.exported = atomicLoad(&nbExportedClauses);
+    snap.lbdAverage = snap.conflicts == 0 ? 0 : atomicLoad(&sumLBD) / snap.conflicts;
+    snap.progress = atomicLoad(&progress_estimate);
+}
 
 void Solver::printConfiguration() const{
 
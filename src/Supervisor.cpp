@@ -0,0 +1,163 @@
+#include "penelope/core/Supervisor.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/utils/Atomic.h"
+#include "penelope/utils/System.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <sstream>
+
+using namespace penelope;
+
+/** The time between two checks of the stop request, in milliseconds */
+#define SUPERVISOR_SLICE 50
+
+Supervisor::Supervisor(Cooperation* c, INIParser& p, int aPeriod, uint64_t aSeed) :
+coop(c), parser(p), space(p), period(aPeriod), seed(aSeed), guard(), lastConflicts(NULL),
+lastUsed(NULL), bestProgress(NULL), age(NULL), generation(NULL), lastTime(0), replacements(0),
+thread(), running(false), stopRequested(false) {
+    pthread_mutex_init(&guard, NULL);
+    int nbThreads = coop->nThreads();
+    lastConflicts = new uint64_t[nbThreads];
+    lastUsed = new uint64_t[nbThreads];
+    bestProgress = new double[nbThreads];
+    age = new int[nbThreads];
+    generation = new int[nbThreads];
+    for (int t = 0; t < nbThreads; t++) {
+        lastConflicts[t] = 0;
+        lastUsed[t] = 0;
+        bestProgress[t] = 0;
+        age[t] = 0;
+        generation[t] = 0;
+    }
+}
+
+Supervisor::~Supervisor() {
+    stop();
+    pthread_mutex_destroy(&guard);
+    delete[](lastConflicts);
+    delete[](lastUsed);
+    delete[](bestProgress);
+    delete[](age);
+    delete[](generation);
+}
+
+bool Supervisor::start() {
+    if (running) return true;
+    lastTime = nanoTime();
+    stopRequested = false;
+    if (pthread_create(&thread, NULL, &Supervisor::run, this) != 0) return false;
+    running = true;
+    return true;
+}
+
+void Supervisor::stop() {
+    if (!running) return;
+    stopRequested = true;
+    pthread_join(thread, NULL);
+    running = false;
+}
+
+void* Supervisor::run(void* data) {
+    Supervisor* supervisor = static_cast<Supervisor*> (data);
+    struct timespec slice;
+    slice.tv_sec = 0;
+    slice.tv_nsec = SUPERVISOR_SLICE * 1000000L;
+    int elapsed = 0;
+    while (!supervisor->stopRequested) {
+        nanosleep(&slice, NULL);
+        elapsed += SUPERVISOR_SLICE;
+        if (elapsed < supervisor->period) continue;
+        elapsed = 0;
+        supervisor->evaluate();
+    }
+    return NULL;
+}
+
+void Supervisor::evaluate() {
+    int nbThreads = coop->nThreads();
+    uint64_t now = nanoTime();
+    double elapsed = (now - lastTime) / 1e9;
+    lastTime = now;
+    if (elapsed <= 0) return;
+
+    pthread_mutex_lock(&guard);
+
+    // the measures of the last period
+    std::vector<double> rate(nbThreads, 0);
+    std::vector<double> used(nbThreads, 0);
+    std::vector<bool> progressed(nbThreads, false);
+    double maxRate = 0, maxUsed = 0;
+    for (int t = 0; t < nbThreads; t++) {
+        SolverSnapshot snap;
+        coop->snapshot(t, snap);
+        uint64_t usedByOthers = 0;
+        for (int k = 0; k < nbThreads; k++)
+            if (k != t) usedByOthers += atomicLoad(&coop->solvers[k].nbClauseUsed[t]);
+
+        rate[t] = (snap.conflicts - lastConflicts[t]) / elapsed;
+        used[t] = usedByOthers - lastUsed[t];
+        progressed[t] = snap.progress > bestProgress[t];
+        if (progressed[t]) bestProgress[t] = snap.progress;
+        lastConflicts[t] = snap.conflicts;
+        lastUsed[t] = usedByOthers;
+        age[t]++;
+
+        if (rate[t] > maxRate) maxRate = rate[t];
+        if (used[t] > maxUsed) maxUsed = used[t];
+    }
+
+    // each measure is relative to the best solver, the score is in [0,3]
+    int weakest = -1;
+    int nbEligible = 0;
+    double weakestScore = 0, totalScore = 0;
+    for (int t = 0; t < nbThreads; t++) {
+        if (atomicLoad(&coop->stopped[t]) || coop->isReplaced(t) || coop->isLocalSearch(t)) continue;
+        if (age[t] <= SUPERVISOR_GRACE_PERIODS) continue;
+        double score = (maxRate > 0 ? rate[t] / maxRate : 1) + (maxUsed > 0 ? used[t] / maxUsed : 1)
+                + (progressed[t] ? 1 : 0);
+        nbEligible++;
+        totalScore += score;
+        if (weakest < 0 || score < weakestScore) {
+            weakest = t;
+            weakestScore = score;
+        }
+    }
+
+    bool replace = nbEligible > 1 &&
+            weakestScore < SUPERVISOR_LOSER_RATIO * totalScore / nbEligible;
+    if (replace && coop->replaceSolver(weakest) && coop->solvers[weakest].verbosity > 0)
+        printf("c supervisor: solver %d (%s) scored %.2f of %.2f on average, it is replaced\n",
+            weakest, coop->solvers[weakest].getConfiguration().c_str(), weakestScore,
+            totalScore / nbEligible);
+    pthread_mutex_unlock(&guard);
+}
+
+bool Supervisor::replace(int t) {
+    if (!coop->isReplaced(t)) return false;
+    Solver& s = coop->solvers[t];
+
+    // nothing to do if the search is over
+    bool over = s.asynch_interrupt;
+    for (int k = 0; k < coop->nThreads() && !over; k++)
+        over = coop->answer(k) != l_Undef;
+    if (over) return false;
+
+    pthread_mutex_lock(&guard);
+    std::ostringstream name;
+    name << "solver" << t << "-r" << ++generation[t];
+    std::string changes = space.mutate(parser, s.getConfiguration(), name.str(), SUPERVISOR_CHANGES, seed);
+    std::string previous = s.getConfiguration();
+    s.reconfigure(name.str(), parser, SUPERVISOR_KEPT_LBD);
+    bestProgress[t] = 0;
+    age[t] = 0;
+    replacements++;
+    pthread_mutex_unlock(&guard);
+
+    coop->publishMemory(&s);
+    if (s.verbosity > 0)
+        printf("c supervisor: solver %d restarts as %s from %s with %s (%d learnts kept)\n", t,
+            name.str().c_str(), previous.c_str(), changes.c_str(), s.nLearnts());
+    coop->clearReplacement(t);
+    return true;
+}
@@ -28,9 +28,6 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 using namespace penelope;
 
-// TODO: split the memory reading functions into two: one for reading high-watermark of RSS, and
-// one for reading the current virtual memory size.
-
 static inline int memReadStat(int field)
 {
     pid_t pid = getpid();
@@ -56,13 +53,14 @@ static inline int memReadPeak(void)
     pid_t pid = getpid();
 
     std::stringstream nameBuf;
-    nameBuf << "/proc/" << pid << "/statm";
+    nameBuf << "/proc/" << pid << "/status";
     FILE* in = fopen(nameBuf.str().c_str(), "rb");
     if (in == NULL) return 0;
 
-    // Find the correct line, beginning with "VmPeak:":
+    // Find the correct line, beginning with "VmHWM:" (the peak resident set
+    // size, VmPeak being the peak of the virtual memory):
     int peak_kb = 0;
-    while (!feof(in) && fscanf(in, "VmPeak: %50d kB", &peak_kb) != 1)
+    while (!feof(in) && fscanf(in, "VmHWM: %50d kB", &peak_kb) != 1)
         while (!feof(in) && fgetc(in) != '\n')
             ;
     fclose(in);
@@ -72,7 +70,7 @@ static inline int memReadPeak(void)
 
 double penelope::memUsed() { return (double)memReadStat(0) * (double)getpagesize() / (1024*1024); }
 double penelope::memUsedPeak() {
-    double peak = memReadPeak() / 1024;
+    double peak = memReadPeak() / 1024.0;
     return peak == 0 ? memUsed() : peak; }
 
 #elif defined(__FreeBSD__)
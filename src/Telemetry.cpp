@@ -0,0 +1,130 @@
+#include "penelope/core/Telemetry.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/utils/System.h"
+
+#include <string.h>
+#include <time.h>
+
+using namespace penelope;
+
+/** The granularity of the sleep of the reporter thread, in milliseconds */
+#define TELEMETRY_SLICE 10
+
+Telemetry::Telemetry(Cooperation* c, const char* aFileName, int anInterval, Format aFormat) :
+coop(c), fileName(aFileName), output(NULL), interval(anInterval), format(aFormat),
+thread(), running(false), stopRequested(false), startTime(0), lastTime(0), last(NULL) {
+    if (interval < 1) interval = 1;
+}
+
+Telemetry::~Telemetry() {
+    stop();
+    delete[](last);
+}
+
+bool Telemetry::parseFormat(const char* name, Format& f) {
+    if (strcmp(name, "json") == 0) {
+        f = FORMAT_JSON;
+        return true;
+    } else if (strcmp(name, "csv") == 0) {
+        f = FORMAT_CSV;
+        return true;
+    }
+    return false;
+}
+
+bool Telemetry::start() {
+    if (running) return true;
+    output = fopen(fileName, "w");
+    if (output == NULL) return false;
+
+    if (last == NULL) last = new SolverSnapshot[coop->nThreads()];
+    memset(last, 0, sizeof(SolverSnapshot) * coop->nThreads());
+    startTime = lastTime = nanoTime();
+    if (format == FORMAT_CSV) {
+        fprintf(output, "time,thread,conflicts,conflicts_per_sec,propagations_per_sec,"
+                "decisions,restarts,learnts,lbd_avg,exported,imported_units,"
+                "imported_clauses,pending_units,pending_clauses,mem_arena_live,"
+                "mem_arena_wasted,mem_watches,mem_clause_lists,mem_trail,mem_var_data,"
+                "mem_rings,mem_exported\n");
+    }
+
+    stopRequested = false;
+    if (pthread_create(&thread, NULL, &Telemetry::run, this) != 0) {
+        fclose(output);
+        output = NULL;
+        return false;
+    }
+    running = true;
+    return true;
+}
+
+void Telemetry::stop() {
+    if (!running) return;
+    stopRequested = true;
+    pthread_join(thread, NULL);
+    running = false;
+    report();
+    fclose(output);
+    output = NULL;
+}
+
+void* Telemetry::run(void* data) {
+    Telemetry* tel = static_cast<Telemetry*> (data);
+    struct timespec slice;
+    slice.tv_sec = 0;
+    slice.tv_nsec = TELEMETRY_SLICE * 1000000L;
+    int elapsed = 0;
+    while (!tel->stopRequested) {
+        nanosleep(&slice, NULL);
+        elapsed += TELEMETRY_SLICE;
+        if (elapsed >= tel->interval) {
+            tel->report();
+            elapsed = 0;
+        }
+    }
+    return NULL;
+}
+
+void Telemetry::report() {
+    uint64_t now = nanoTime();
+    double time = (now - startTime) / 1e9;
+    double delta = (now - lastTime) / 1e9;
+    lastTime = now;
+    uint64_t rings = coop->ringsMemory();
+    uint64_t exported = coop->garbageMemory();
+
+    for (int t = 0; t < coop->nThreads(); t++) {
+        SolverSnapshot snap;
+        coop->snapshot(t, snap);
+        double confRate = delta == 0 ? 0 : (snap.conflicts - last[t].conflicts) / delta;
+        double propRate = delta == 0 ? 0 : (snap.propagations - last[t].propagations) / delta;
+        last[t] = snap;
+
+        if (format == FORMAT_JSON) {
+            fprintf(output, "{\"time\":%.3f,\"thread\":%d,\"conflicts\":%lu,"
+                    "\"conflicts_per_sec\":%.1f,\"propagations_per_sec\":%.1f,"
+                    "\"decisions\":%lu,\"restarts\":%lu,\"learnts\":%d,\"lbd_avg\":%.3f,"
+                    "\"exported\":%ld,\"imported_units\":%d,\"imported_clauses\":%d,"
+                    "\"pending_units\":%d,\"pending_clauses\":%d,"
+                    "\"memory\":{\"arena_live\":%lu,\"arena_wasted\":%lu,\"watches\":%lu,"
+                    "\"clause_lists\":%lu,\"trail\":%lu,\"var_data\":%lu,"
+                    "\"rings\":%lu,\"exported\":%lu}}\n",
+                    time, t, snap.conflicts, confRate, propRate, snap.decisions,
+                    snap.restarts, snap.learnts, snap.lbdAverage, snap.exported,
+                    snap.importedUnits, snap.importedClauses, snap.pendingUnits,
+                    snap.pendingClauses, snap.memory.arenaLive, snap.memory.arenaWasted,
+                    snap.memory.watches, snap.memory.clauseLists, snap.memory.trail,
+                    snap.memory.varData, rings, exported);
+        } else {
+            fprintf(output, "%.3f,%d,%lu,%.1f,%.1f,%lu,%lu,%d,%.3f,%ld,%d,%d,%d,%d,"
+                    "%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                    time, t, snap.conflicts, confRate, propRate, snap.decisions,
+                    snap.restarts, snap.learnts, snap.lbdAverage, snap.exported,
+                    snap.importedUnits, snap.importedClauses, snap.pendingUnits,
+                    snap.pendingClauses, snap.memory.arenaLive, snap.memory.arenaWasted,
+                    snap.memory.watches, snap.memory.clauseLists, snap.memory.trail,
+                    snap.memory.varData, rings, exported);
+        }
+    }
+    fflush(output);
+}
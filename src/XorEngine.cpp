@@ -0,0 +1,240 @@
+#include "penelope/core/XorEngine.h"
+#include "penelope/core/Solver.h"
+#include "penelope/utils/Sort.h"
+
+using namespace penelope;
+
+namespace penelope {
+
+    /**
+     * Order the candidate clauses by their size, then by their variables,
+     * so that the clauses over the same variables are next to each other
+     */
+    struct CandidateLt {
+        /** The literals of the candidates, sorted, one after the other */
+        const vec<Lit>& lits;
+        /** The position of the first literal of each candidate, plus the end */
+        const vec<int>& starts;
+
+        CandidateLt(const vec<Lit>& l, const vec<int>& s) : lits(l), starts(s) {
+        }
+
+        bool operator()(int x, int y) const {
+            int sx = starts[x + 1] - starts[x], sy = starts[y + 1] - starts[y];
+            if (sx != sy) return sx < sy;
+            for (int i = 0; i < sx; i++) {
+                Var a = var(lits[starts[x] + i]), b = var(lits[starts[y] + i]);
+                if (a != b) return a < b;
+            }
+            return false;
+        }
+    };
+
+}
+
+XorEngine::XorEngine(Solver& solver) : s(solver), xors(), parities(), qhead(0),
+implied(), reasons(), conflict(CRef_Undef), gauss(false), dirty(false), column(),
+columnVar(), words(0), rows(), rowParities(), pivots(), unassigned(), rowVars(), lits(),
+eliminated(0), conflicts(0) {
+}
+
+void XorEngine::find(const ClauseAllocator& ca, const vec<CRef>& clauses, vec<vec<Var> >& vars, vec<char>& parities) {
+    // the clauses that may be a part of a constraint, their literals sorted
+    vec<Lit> candidates;
+    vec<int> starts(1, 0);
+    for (int i = 0; i < clauses.size(); i++) {
+        const Clause& c = ca[clauses[i]];
+        if (c.size() < 3 || c.size() > XOR_MAX_SIZE) continue;
+        for (int k = 0; k < c.size(); k++) candidates.push(c[k]);
+        sort((Lit*) candidates + starts.last(), c.size());
+        starts.push(candidates.size());
+    }
+    vec<int> order;
+    for (int i = 0; i + 1 < starts.size(); i++) order.push(i);
+    CandidateLt lt(candidates, starts);
+    sort(order, lt);
+
+    vec<char> present(1 << XOR_MAX_SIZE, 0);
+    for (int i = 0, j; i < order.size(); i = j) {
+        for (j = i + 1; j < order.size() && !lt(order[i], order[j]); j++);
+        int first = starts[order[i]], size = starts[order[i] + 1] - first;
+        int half = 1 << (size - 1);
+        if (j - i < half) continue;
+
+        // a clause forbids the assignment where each of its literals is
+        // false: the one whose variables are true for its negative literals
+        int counts[2] = {0, 0};
+        for (int m = 0; m < 2 * half; m++) present[m] = 0;
+        for (int k = i; k < j; k++) {
+            int mask = 0, parity = 0;
+            for (int l = 0; l < size; l++)
+                if (sign(candidates[starts[order[k]] + l])) mask |= 1 << l, parity ^= 1;
+            if (present[mask]) continue;
+            present[mask] = 1;
+            counts[parity]++;
+        }
+        for (int parity = 0; parity < 2; parity++) {
+            if (counts[parity] < half) continue;
+            // every assignment of this parity is forbidden
+            vars.push();
+            for (int l = 0; l < size; l++) vars.last().push(var(candidates[first + l]));
+            parities.push(!parity);
+        }
+    }
+}
+
+void XorEngine::recover() {
+    ASSERT_EQUAL(0, s.decisionLevel());
+    implied.growTo(s.nVars(), 0);
+    reasons.growTo(s.nVars());
+
+    vec<CRef> candidates;
+    for (int i = 0; i < s.clauses.size(); i++) {
+        const Clause& c = s.ca[s.clauses[i]];
+        bool assigned = false;
+        for (int k = 0; k < c.size() && !assigned; k++) assigned = s.value(c[k]) != l_Undef;
+        if (!assigned) candidates.push(s.clauses[i]);
+    }
+    find(s.ca, candidates, xors, parities);
+    buildMatrix();
+}
+
+void XorEngine::buildMatrix() {
+    column.growTo(s.nVars(), -1);
+    if (xors.size() == 0 || xors.size() > XOR_GAUSS_MAX_ROWS) return;
+    bool shared = false;
+    for (int x = 0; x < xors.size(); x++)
+        for (int i = 0; i < xors[x].size(); i++) {
+            Var v = xors[x][i];
+            shared = shared || column[v] != -1;
+            if (column[v] != -1) continue;
+            column[v] = columnVar.size();
+            columnVar.push(v);
+        }
+    // the elimination does not find more than the clauses when no
+    // variable is shared by two constraints
+    if (!shared || columnVar.size() > XOR_GAUSS_MAX_VARS) return;
+
+    words = (columnVar.size() + 63) / 64;
+    rows.growTo(xors.size() * words, 0);
+    for (int x = 0; x < xors.size(); x++)
+        for (int i = 0; i < xors[x].size(); i++) {
+            int c = column[xors[x][i]];
+            rows[x * words + (c >> 6)] |= (uint64_t) 1 << (c & 63);
+        }
+    parities.copyTo(rowParities);
+    pivots.growTo(xors.size(), -1);
+    unassigned.growTo(words, 0);
+    gauss = true;
+    // the system alone may be inconsistent
+    dirty = true;
+}
+
+CRef XorEngine::propagate() {
+    if (!gauss) return CRef_Undef;
+    while (qhead < s.trail.size())
+        if (column[var(s.trail[qhead++])] >= 0) dirty = true;
+    return dirty ? eliminate() : CRef_Undef;
+}
+
+CRef XorEngine::eliminate() {
+    dirty = false;
+    int nbRows = xors.size();
+    for (int w = 0; w < words; w++) unassigned[w] = 0;
+    for (int c = 0; c < columnVar.size(); c++)
+        if (s.value(columnVar[c]) == l_Undef) unassigned[c >> 6] |= (uint64_t) 1 << (c & 63);
+
+    // the pivot of a row only occurs in this row: the rows whose pivot was
+    // assigned take one of their unassigned columns as their new pivot,
+    // eliminated from the other rows. The assigned columns are kept for
+    // the reasons.
+    for (int r = 0; r < nbRows; r++) {
+        if (pivots[r] >= 0 && s.value(columnVar[pivots[r]]) == l_Undef) continue;
+        pivots[r] = -1;
+        const uint64_t* p = &rows[r * words];
+        for (int k = 0; k < words && pivots[r] < 0; k++)
+            if ((p[k] & unassigned[k]) != 0) pivots[r] = k * 64 + __builtin_ctzll(p[k] & unassigned[k]);
+        if (pivots[r] < 0) continue;
+        int w = pivots[r] >> 6;
+        uint64_t bit = (uint64_t) 1 << (pivots[r] & 63);
+        for (int o = 0; o < nbRows; o++) {
+            if (o == r || !(rows[o * words + w] & bit)) continue;
+            uint64_t* q = &rows[o * words];
+            for (int k = 0; k < words; k++) q[k] ^= p[k];
+            rowParities[o] ^= rowParities[r];
+        }
+    }
+
+    // the rows with at most one unassigned column are conflicting or unit
+    for (int r = 0; r < nbRows; r++) {
+        const uint64_t* row = &rows[r * words];
+        int nbUnassigned = 0;
+        for (int k = 0; k < words && nbUnassigned < 2; k++) {
+            uint64_t m = row[k] & unassigned[k];
+            if (m != 0) nbUnassigned += (m & (m - 1)) != 0 ? 2 : 1;
+        }
+        if (nbUnassigned > 1) continue;
+
+        // the previous rows may have assigned its unassigned column
+        rowVars.clear();
+        bool parity = rowParities[r];
+        Var v = var_Undef;
+        for (int k = 0; k < words; k++)
+            for (uint64_t m = row[k]; m != 0; m &= m - 1) {
+                Var u = columnVar[k * 64 + __builtin_ctzll(m)];
+                rowVars.push(u);
+                if (s.value(u) == l_Undef) v = u;
+                else parity ^= s.value(u) == l_True;
+            }
+        if (v != var_Undef) {
+            imply(rowVars, v, parity);
+            eliminated++;
+        } else if (parity) {
+            return conflicting(rowVars);
+        }
+    }
+    return CRef_Undef;
+}
+
+void XorEngine::imply(const vec<Var>& vars, Var v, bool value) {
+    s.uncheckedEnqueue(mkLit(v, !value));
+    if (s.decisionLevel() == 0) return;
+    implied[v] = 1;
+    vars.copyTo(reasons[v]);
+}
+
+CRef XorEngine::buildClause(const vec<Var>& vars, Var v) {
+    lits.clear();
+    if (v != var_Undef) lits.push(mkLit(v, s.value(v) == l_False));
+    for (int i = 0; i < vars.size(); i++)
+        if (vars[i] != v) lits.push(mkLit(vars[i], s.value(vars[i]) == l_True));
+    CRef cr = s.ca.alloc(lits, true);
+    s.ca[cr].lbd(lits.size());
+    return cr;
+}
+
+CRef XorEngine::conflicting(const vec<Var>& vars) {
+    if (conflict != CRef_Undef) s.ca.free(conflict);
+    conflict = buildClause(vars, var_Undef);
+    conflicts++;
+    return conflict;
+}
+
+CRef XorEngine::reason(Var v) {
+    if (!implied[v]) return CRef_Undef;
+    if (s.vardata[v].reason == CRef_Undef) s.vardata[v].reason = buildClause(reasons[v], v);
+    return s.vardata[v].reason;
+}
+
+void XorEngine::backtrack(int size) {
+    for (int i = size; i < s.trail.size(); i++) {
+        Var v = var(s.trail[i]);
+        if (!implied[v]) continue;
+        implied[v] = 0;
+        if (s.vardata[v].reason != CRef_Undef) {
+            s.ca.free(s.vardata[v].reason);
+            s.vardata[v].reason = CRef_Undef;
+        }
+    }
+    if (qhead > size) qhead = size;
+}
@@ -17,8 +17,6 @@ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FO
 DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 **************************************************************************************************/
-#include <omp.h>
-
 #include <errno.h>
 
 #include <signal.h>
@@ -39,7 +37,17 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "penelope/utils/Options.h"
 #include "penelope/core/Dimacs.h"
 #include "penelope/core/Solver.h"
+#include "penelope/core/Telemetry.h"
+#include "penelope/core/LiveReport.h"
+#include "penelope/core/ReplayLog.h"
+#include "penelope/core/Supervisor.h"
+#include "penelope/core/ParameterSpace.h"
+#include "penelope/core/LocalSearch.h"
+#include "penelope/core/Cuber.h"
+#include "penelope/core/Preprocessor.h"
+#include "penelope/core/Prober.h"
 #include "penelope/utils/INIParser.h"
+#include "penelope/utils/Executor.h"
 
 #include <iostream>
 #include <limits>
@@ -112,19 +120,41 @@ void printStats(Cooperation& coop, int winner, const char* instance, std::ostrea
     for(int i=0; i<coop.nbThreads; i++){
         output << "exported " << i<< "\t";
     }
-    output << "total exported \n";
+    output << "total exported\tpropagations\ttotal conflicts\ttotal propagations\tpeak memory\n";
 
     int64_t totalExported = 0;
+    uint64_t totalConflicts = 0;
+    uint64_t totalPropagations = 0;
     output << cpu_time << '\t' << s.starts << '\t' << s.conflicts << '\t';
     output << s.tot_literals << '\t';
 
     for(int i=0; i<coop.nbThreads; i++){
         int64_t tmp = coop.solvers[i].getNbExportedClauses();
         totalExported += tmp;
+        totalConflicts += coop.solvers[i].conflicts;
+        totalPropagations += coop.solvers[i].propagations;
         output << tmp << '\t';
     }
-    output << totalExported << std::endl;
-
+    output << totalExported << '\t' << s.propagations << '\t';
+    output << totalConflicts << '\t' << totalPropagations << '\t';
+    output << memUsedPeak() << std::endl;
+
+    if(PhaseProfile::enabled()){
+        output << "#profile\tthread";
+        for(int p=0; p<PROFILE_NB_PHASES; p++){
+            output << '\t' << PhaseProfile::name((ProfilePhase)p);
+        }
+        output << '\n';
+        for(int i=0; i<coop.nbThreads; i++){
+            const PhaseProfile& prof = coop.solvers[i].getProfile();
+            output << "profile\t" << i;
+            for(int p=0; p<PROFILE_NB_PHASES; p++){
+                output << '\t' << prof.seconds((ProfilePhase)p);
+            }
+            output << '\n';
+        }
+        output.flush();
+    }
 
 }
 
@@ -158,6 +188,10 @@ BOOL WINAPI winSigStop(DWORD dwCtrlType){
 
 // Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
+static void SIGUSR1_report(int) {
+    LiveReport::request();
+}
+
 static void SIGINT_interrupt(int signum) {
     printf("\n"); printf("c *** INTERRUPTED, signal %d ***\n", signum);
     for(int i=0; i<cooperator->nbThreads; i++){
@@ -168,6 +202,107 @@ static void SIGINT_interrupt(int signum) {
 
 #include <iostream>
 
+//=================================================================================================
+// Tasks executed by each thread of the portfolio:
+
+/**
+ * Initialize the solver of each thread with its configuration
+ */
+class InitializeTask : public Task {
+public:
+    InitializeTask(Cooperation& c, INIParser& p, int v, int d) :
+    coop(c), parser(p), verbosity(v), determ(d) {
+    }
+
+    void execute(int t) {
+        coop.solvers[t].initialize(&coop, t, parser);
+        coop.solvers[t].threadId = t;
+        coop.solvers[t].verbosity = verbosity;
+        coop.solvers[t].deterministic_mode = determ;
+    }
+
+private:
+    Cooperation& coop;
+    INIParser& parser;
+    int verbosity;
+    int determ;
+};
+
+/**
+ * Give the preprocessed formula to the solver of each thread
+ */
+class LoadTask : public Task {
+public:
+    LoadTask(Cooperation& c, const Preprocessor& p) : coop(c), preprocessor(p) {
+    }
+
+    void execute(int t) {
+        preprocessor.load(coop.solvers[t]);
+    }
+
+private:
+    Cooperation& coop;
+    const Preprocessor& preprocessor;
+};
+
+/**
+ * Run the search of the solver of each thread
+ */
+class SolveTask : public Task {
+public:
+    SolveTask(Cooperation& c, bool p, int d, lbool& r, Supervisor* s) :
+    coop(c), perfCounters(p), determ(d), ret(r), supervisor(s), dummy() {
+    }
+
+    void execute(int t) {
+        coop.start = true;
+        if (perfCounters && !coop.solvers[t].openCounters()){
+            printf("c WARNING! Thread %d could not open its performance counters (see /proc/sys/kernel/perf_event_paranoid)\n", t);
+        }
+        try{
+            if (coop.isLocalSearch(t)){
+                LocalSearch localSearch(coop.solvers[t], &coop);
+                ret = localSearch.solve();
+                if (coop.solvers[t].verbosity > 0)
+                    printf("c local search %d: %lu flips, %d restarts, at best %d falsified clause(s)\n",
+                        t, localSearch.nbFlips(), localSearch.nbRestarts(), localSearch.bestUnsat());
+            } else if (coop.isDivide(t)){
+                ret = coop.solvers[t].solveGuidingPaths(&coop);
+            } else {
+                ret = coop.solvers[t].solveLimited(dummy, &coop);
+                // a replaced configuration searches again with its new parameters
+                while (ret == l_Undef && supervisor != NULL && supervisor->replace(t))
+                    ret = coop.solvers[t].solveLimited(dummy, &coop);
+            }
+        } catch (OutOfMemoryException&){
+            if (determ != 0){
+                // the other threads would wait forever on the next barrier
+                printf("c thread %d ran out of memory\n", t);
+                printf("c INDETERMINATE\n");
+                exit(0);
+            }
+            atomicStore(&coop.stopped[t], true);
+            if (coop.solvers[0].verbosity > 0)
+                printf("c memory governor: solver %d stopped (out of memory)\n", t);
+        }
+        if (coop.isStopped(t)){
+            try{
+                coop.solvers[t].releaseLearnts();
+                coop.publishMemory(&coop.solvers[t]);
+            } catch (OutOfMemoryException&){
+            }
+        }
+    }
+
+private:
+    Cooperation& coop;
+    bool perfCounters;
+    int determ;
+    lbool& ret;
+    Supervisor* supervisor;
+    vec<Lit> dummy;
+};
+
 
 //=================================================================================================
 // Main:
@@ -203,8 +338,17 @@ int main(int argc, char** argv)
 
 	IntOption    limitEx("MAIN", "limitEx","Limit size clause exchange.\n", 10, IntRange(0, std::numeric_limits<int>::max()));
 	IntOption    ctrl   ("MAIN", "ctrl","Dynamic control clause sharing with 2 modes.\n", 0, IntRange(0, 2));
+        IntOption    trace_rate("MAIN", "trace-rate","Trace one out of trace-rate exported clauses (0 = no tracing).\n", 0, IntRange(0, std::numeric_limits<int>::max()));
+        IntOption    mem_budget("MAIN", "mem-budget","Memory budget of the portfolio in megabytes (0 = 90% of mem-lim, if any).\n", 0, IntRange(0, std::numeric_limits<int>::max()));
         StringOption statsFile("MAIN", "stats", "The file where we will print the statistics of the winner",NULL);
         BoolOption force_print("MAIN", "force-print", "force to print the solution", false);
+        BoolOption perf_counters("MAIN", "perf", "Measure the hardware counters of each solver thread (perf_event_open)", false);
+        StringOption telemetryFile("MAIN", "telemetry", "The file where the counters of each thread will be periodically written",NULL);
+        IntOption    telemetryInterval("MAIN", "telemetry-interval","Time between two telemetry records in milliseconds.\n", 1000, IntRange(1, std::numeric_limits<int>::max()));
+        StringOption controlFile("MAIN", "control-file", "Print the live statistics each time this file is created (it is then removed); SIGUSR1 does the same",NULL);
+        StringOption telemetryFormat("MAIN", "telemetry-format", "The format of the telemetry records (json or csv)","json");
+        StringOption recordFile("MAIN", "record", "Record what each thread imports in <record>.<thread>, to replay it later",NULL);
+        StringOption replayFile("MAIN", "replay", "Replay on a single solver the thread recorded in this file",NULL);
 
         parseOptions(argc, argv, true);
 
@@ -217,7 +361,7 @@ int main(int argc, char** argv)
         const std::string& ncoresStr(parser.getValueForConf("global","ncores"));
         if(ncoresStr.length()>0){
         if (ncoresStr == std::string("max")) {
-                nbThreads = omp_get_num_procs();
+                nbThreads = nbProcessors();
             } else {
                 nbThreads = atoi(ncoresStr.c_str());
                 }
@@ -228,6 +372,8 @@ int main(int argc, char** argv)
         if(detStr.length()>0){
             if (detStr == std::string("true")) {
                 determ = 2;
+            } else if (detStr == std::string("logical")) {
+                determ = 3;
             } else if (detStr == std::string("false")) {
                 determ = 0;
             } else{
@@ -237,7 +383,20 @@ int main(int argc, char** argv)
 
         changeNbThreads(argv[1],nbThreads);
 
-        omp_set_num_threads(nbThreads);
+        // the replayed thread runs in the portfolio of the record
+        ReplayLog* replay = NULL;
+        if ((const char*)replayFile != NULL){
+            replay = new ReplayLog();
+            if (!replay->replay(replayFile)){
+                std::cerr << "c could not read the replay log " << (const char*)replayFile << std::endl;
+                exit(1);
+            }
+            nbThreads = replay->nbThreads();
+            determ = replay->mode();
+            printf("c replaying thread %d of %d threads\n", replay->thread(), nbThreads);
+        }
+
+        ThreadPoolExecutor executor(nbThreads);
 
 	int limitExport = limitEx;
 	Cooperation coop(nbThreads, limitExport);
@@ -246,19 +405,69 @@ int main(int argc, char** argv)
 
 	coop.ctrl = ctrl;
 	coop.deterministic_mode = determ;
+        const std::string& epochStr(parser.getValueForConf("global","epoch"));
+        if(epochStr.length()>0 && atol(epochStr.c_str()) > 0){
+            coop.epochLength = atol(epochStr.c_str());
+        }
+        coop.setTraceRate(trace_rate);
+        if (replay != NULL){
+            coop.setReplayLog(replay->thread(), replay);
+        } else if ((const char*)recordFile != NULL){
+            for (int t = 0; t < nbThreads; t++){
+                std::ostringstream logName;
+                logName << (const char*)recordFile << "." << t;
+                ReplayLog* log = new ReplayLog();
+                if (!log->record(logName.str().c_str(), t, nbThreads, determ)){
+                    printf("c WARNING! Could not create the replay log %s\n", logName.str().c_str());
+                    delete log;
+                    continue;
+                }
+                coop.setReplayLog(t, log);
+            }
+        }
+        if (mem_budget > 0){
+            coop.memoryBudget = (uint64_t)mem_budget * 1024*1024;
+        }
+#ifndef WIN32
+        else if (mem_lim != std::numeric_limits<int>::max()){
+            coop.memoryBudget = (uint64_t)mem_lim * 1024*1024 / 10 * 9;
+        }
+#endif
 
-#pragma omp parallel
-	{
-	  int t = omp_get_thread_num();
-          coop.solvers[t].initialize(&coop, t, parser);
-	  coop.solvers[t].threadId = t;
-	  coop.solvers[t].verbosity = verb;
-	  coop.solvers[t].deterministic_mode = determ;
-	}
+        // the threads without a configuration of their own get a generated
+        // one, instead of all running the default configuration. The first
+        // thread keeps the default configuration, and so do the parameters
+        // it sets.
+        const std::string& diversifyStr(parser.getValueForConf("global","diversify"));
+        if(diversifyStr != std::string("false")){
+            const std::string& seedStr(parser.getValueForConf("global","seed"));
+            uint64_t seed = seedStr.length() > 0 ? strtoull(seedStr.c_str(), NULL, 10) : 0;
+            ParameterSpace space(parser);
+            int generated = 0;
+            for(int t = 0; t < nbThreads; t++){
+                std::ostringstream name;
+                name << "solver" << t;
+                if(parser.configurationExist(name.str())){
+                    if(verb > 0) printf("c thread %d: configuration [%s]\n", t, name.str().c_str());
+                    continue;
+                }
+                if(t == 0){
+                    if(verb > 0) printf("c thread %d: configuration [default]\n", t);
+                    continue;
+                }
+                std::string params = space.generate(parser, name.str(), generated++, seed);
+                if(verb > 0) printf("c thread %d: generated configuration %s\n", t, params.c_str());
+            }
+        }
+
+        InitializeTask initialize(coop, parser, verb, determ);
+        executor.run(initialize);
+        coop.updateLocalSearch(determ == 0 && replay == NULL);
+        coop.updateDivide(determ == 0 && replay == NULL && (const char*)recordFile == NULL);
 
 
 	printf("c  -----------------------------------------------------------------------------------------------------------------------\n");
-	printf("c |                                 PeneLoPe      %i thread(s) on %i core(s)                                                |\n", coop.nbThreads, omp_get_num_procs());
+	printf("c |                                 PeneLoPe      %i thread(s) on %i core(s)                                                |\n", coop.nbThreads, nbProcessors());
 	printf("c  -----------------------------------------------------------------------------------------------------------------------\n");
 
         // Use signal handlers that forcibly quit until the solver will be able to respond to
@@ -269,6 +478,7 @@ int main(int argc, char** argv)
         signal(SIGINT, SIGINT_interrupt);
         signal(SIGXCPU,SIGINT_interrupt);
         signal(SIGALRM, SIGINT_interrupt);
+        signal(SIGUSR1, SIGUSR1_report);
 
         if(time_lim > 0){
             alarm(time_lim);
@@ -311,10 +521,52 @@ int main(int argc, char** argv)
         }
 
 
+        // the formula is simplified once, then given to every solver
+        Preprocessor* preprocessor = NULL;
+        const std::string& preprocessStr(parser.getValueForConf("global","preprocess"));
         FILE* in = fopen(argv[1], "rb");
-        DimacsParser::parse_DIMACS(in, &coop);
+        if (preprocessStr != std::string("false")){
+            preprocessor = new Preprocessor();
+            DimacsParser::parse_DIMACS(in, *preprocessor);
+        } else {
+            DimacsParser::parse_DIMACS(in, &coop);
+        }
         fclose(in);
 
+        if (preprocessor != NULL){
+            uint64_t preprocessStart = nanoTime();
+            int nbClauses = preprocessor->nClauses();
+            // the threads recovering the XOR constraints need their clauses
+            bool xors = false;
+            for (int t = 0; t < coop.nThreads(); t++) xors = xors || coop.solvers[t].useXor;
+            int nbFrozen = xors ? preprocessor->freezeXors() : 0;
+            preprocessor->preprocess(&executor);
+            LoadTask load(coop, *preprocessor);
+            executor.run(load);
+            preprocessor->release();
+            if (coop.solvers[0].verbosity > 0){
+                printf("c preprocessing: %d variable(s) eliminated, %d fixed, %d/%d clause(s) left, %d subsumed, %d literal(s) strengthened in %.2f s\n",
+                    preprocessor->nbEliminated(), preprocessor->nbFixed(), preprocessor->nClauses(), nbClauses,
+                    preprocessor->nbSubsumed(), preprocessor->nbStrengthened(), (nanoTime() - preprocessStart) / 1e9);
+                if (nbFrozen > 0)
+                    printf("c preprocessing: %d variable(s) of XOR constraints kept\n", nbFrozen);
+            }
+        }
+
+        // each thread probes a share of the variables, and the units and
+        // equivalences found simplify the formula of every solver
+        Prober* prober = NULL;
+        const std::string& probeStr(parser.getValueForConf("global","probe"));
+        if (probeStr == std::string("true")){
+            uint64_t probeStart = nanoTime();
+            prober = new Prober(coop);
+            prober->probe(executor);
+            if (coop.solvers[0].verbosity > 0){
+                printf("c probing: %d failed literal(s), %d literal(s) implied by both polarities, %d variable(s) replaced by an equivalent literal in %.2f s\n",
+                    prober->nbFailed(), prober->nbImplied(), prober->nbEquivalent(), (nanoTime() - probeStart) / 1e9);
+            }
+        }
+
 		
         FILE* res = (!force_print && argc >= 3) ? fopen(argv[2], "wb") : NULL;
 
@@ -363,27 +615,105 @@ int main(int argc, char** argv)
           }
         }
 
-        vec<Lit> dummy;
+        // the cubes replace the whole space as the first guiding paths of
+        // the threads dividing the search space
+        const std::string& cubesStr(parser.getValueForConf("global","cubes"));
+        if(cubesStr.length()>0 && atoi(cubesStr.c_str()) > 0){
+            if (coop.nbDivide == 0){
+                printf("c WARNING! No thread divides the search space (solverType = divide): no cube is generated\n");
+            } else {
+                double cubeStart = cpuTime();
+                Cuber cuber(coop.solvers[0]);
+                lbool cubed = cuber.generate(atoi(cubesStr.c_str()), coop.guidingPaths);
+                const vec<Lit>& units = cuber.getUnits();
+                for (int t = 0; t < coop.nThreads() && cubed != l_False; t++){
+                    for (int i = 0; i < units.size(); i++){
+                        if (!coop.solvers[t].addClause(units[i])) cubed = l_False;
+                    }
+                }
+                if (cubed == l_False) coop.answers[0] = l_False;
+                if (coop.solvers[0].verbosity > 0){
+                    printf("c cuber: %d cube(s), %d refuted branch(es), %d failed literal(s) in %.2f s\n",
+                        cuber.nbCubes(), cuber.nbRefuted(), cuber.nbFailed(), cpuTime() - cubeStart);
+                }
+            }
+        }
+
+        Telemetry* telemetry = NULL;
+        if ((const char*)telemetryFile != NULL){
+            Telemetry::Format format;
+            if (!Telemetry::parseFormat(telemetryFormat, format)){
+                std::cerr << "c unknown telemetry format: " << (const char*)telemetryFormat << std::endl;
+                format = Telemetry::FORMAT_JSON;
+            }
+            telemetry = new Telemetry(&coop, telemetryFile, telemetryInterval, format);
+            if (!telemetry->start()){
+                printf("c WARNING! Could not start the telemetry in %s\n", (const char*)telemetryFile);
+            }
+        }
+
 
 
+        LiveReport liveReport(&coop, controlFile);
+        if (!liveReport.start()){
+            printf("c WARNING! Could not start the live report thread\n");
+        }
+
+        Supervisor* supervisor = NULL;
+        const std::string& supervisorStr(parser.getValueForConf("global","supervisor"));
+        if(supervisorStr.length()>0 && atoi(supervisorStr.c_str()) > 0){
+            if (determ != 0 || replay != NULL){
+                printf("c WARNING! The supervisor is only available in the non deterministic mode\n");
+            } else {
+                supervisor = new Supervisor(&coop, parser, atoi(supervisorStr.c_str()) * 1000, SUPERVISOR_SEED);
+                if (!supervisor->start()){
+                    printf("c WARNING! Could not start the supervisor thread\n");
+                }
+            }
+        }
 
 	int winner = 0;
 	lbool ret;
 	lbool result = l_Undef;
 
 	// launch threads in Parallel
-#pragma omp parallel
-	{
-	  int t = omp_get_thread_num();
-          //coop.solvers[t].initialize(&coop, t, parser);
-	  coop.start = true;
-	  ret = coop.solvers[t].solveLimited(dummy, &coop);
-	}
+        SolveTask solve(coop, perf_counters, determ, ret, supervisor);
+        if (replay != NULL){
+            solve.execute(replay->thread());
+        } else {
+            executor.run(solve);
+        }
+
+        if (telemetry != NULL){
+            telemetry->stop();
+            delete telemetry;
+            telemetry = NULL;
+        }
+        liveReport.stop();
+        if (supervisor != NULL){
+            supervisor->stop();
+            if (coop.solvers[0].verbosity > 0)
+                printf("c supervisor: %d configuration(s) replaced\n", supervisor->nbReplacements());
+            delete supervisor;
+            supervisor = NULL;
+        }
+        if (coop.nbDivide > 0 && coop.solvers[0].verbosity > 0){
+            printf("c divide and conquer: %d split(s), %d guiding path(s) refuted, %d pruned\n",
+                coop.guidingPaths.nbSplits(), coop.guidingPaths.nbRefuted(), coop.guidingPaths.nbPruned());
+        }
 
         bool interrupted = false;
         for(int i = 0; i < coop.nbThreads && !interrupted; i++){
             interrupted = coop.solvers[i].asynch_interrupt;
         }
+        if(coop.nbRunningSolvers() == 0){
+            interrupted = true;
+        }
+        if (replay != NULL){
+            printf("c replay: %d divergence(s) from the record\n", replay->nbDivergences());
+            // the recorded thread may have been stopped by the answer of another one
+            interrupted = interrupted || coop.answer(replay->thread()) == l_Undef;
+        }
         if(interrupted){
             printf("c INDETERMINATE\n");
             int i = -1;
@@ -401,6 +731,14 @@ int main(int argc, char** argv)
             winnerFound = true;
 	  }
         }
+        // the eliminated variables get their value from the removed clauses,
+        // the replaced ones from their representative
+        if (result == l_True && prober != NULL){
+            prober->extendModel(coop.solvers[winner].model);
+        }
+        if (result == l_True && preprocessor != NULL){
+            preprocessor->extendModel(coop.solvers[winner].model);
+        }
 
         if(res==NULL || force_print){
             if (result == l_True) {
@@ -0,0 +1,131 @@
+#!/bin/sh
+#
+# Benchmark driver for penelope.
+#
+# Runs every combination of thread count x configuration preset x instance in
+# deterministic mode with a pinned seed, so that two runs of the same binary
+# perform the same search, and records the throughput of each run. When a
+# baseline exists, the results are compared to it.
+#
+# usage: bench.sh <penelope binary>
+#
+# The following environment variables change the matrix and the comparison:
+#   BENCH_THREADS    the thread counts             (default: "1 2 4")
+#   BENCH_PRESETS    the presets of test/bench/presets, "portfolio" being the
+#                    configuration.ini of the repository
+#                                                  (default: "portfolio uniform luby")
+#   BENCH_INSTANCES  the instances of test/instances, without the .cnf
+#                    (default: "dp04s04.shuffled dp04u03.shuffled dp10s10.shuffled")
+#   BENCH_SEED       the seed given to every solver (default: 91648253)
+#   BENCH_TIMEOUT    the time limit of each run, in seconds (default: 300)
+#   BENCH_TOLERANCE  the relative slow down allowed before reporting a
+#                    regression, in percent (default: 10)
+#   BENCH_BASELINE   the baseline file (default: test/bench/baseline.tsv)
+#   BENCH_OUTPUT     the directory of the results (default: build/bench)
+
+BINARY=$1
+if [ -z "${BINARY}" ] || [ ! -x "${BINARY}" ]; then
+    echo "usage: $0 <penelope binary>"
+    exit 1
+fi
+
+BENCH_DIR=`dirname $0`
+ROOT_DIR=${BENCH_DIR}/../..
+THREADS=${BENCH_THREADS:-"1 2 4"}
+PRESETS=${BENCH_PRESETS:-"portfolio uniform luby"}
+INSTANCES=${BENCH_INSTANCES:-"dp04s04.shuffled dp04u03.shuffled dp10s10.shuffled"}
+SEED=${BENCH_SEED:-91648253}
+TIMEOUT=${BENCH_TIMEOUT:-300}
+TOLERANCE=${BENCH_TOLERANCE:-10}
+BASELINE=${BENCH_BASELINE:-${BENCH_DIR}/baseline.tsv}
+OUTPUT=${BENCH_OUTPUT:-${ROOT_DIR}/build/bench}
+
+mkdir -p ${OUTPUT}
+RESULTS=${OUTPUT}/results-`date +"%y-%m-%d-%H%M%S"`.tsv
+TMP_CONF=${OUTPUT}/bench.ini
+TMP_STATS=${OUTPUT}/bench.stats
+
+printf "threads\tpreset\tinstance\tresult\twall\tconflicts\tconflicts/s\tpropagations/s\tpeak memory\texported\n" > ${RESULTS}
+
+for preset in ${PRESETS}; do
+    if [ "${preset}" = "portfolio" ]; then
+        PRESET_FILE=${ROOT_DIR}/configuration.ini
+    else
+        PRESET_FILE=${BENCH_DIR}/presets/${preset}.ini
+    fi
+    if [ ! -f ${PRESET_FILE} ]; then
+        echo "unknown preset ${preset}"
+        exit 1
+    fi
+    for threads in ${THREADS}; do
+        # force the number of threads and the deterministic mode
+        sed -e "s/^ncores *=.*/ncores = ${threads}/" \
+            -e "s/^deterministic *=.*/deterministic = true/" ${PRESET_FILE} > ${TMP_CONF}
+        for instance in ${INSTANCES}; do
+            rm -f ${TMP_STATS}
+            START=`date +%s.%N`
+            ${BINARY} -verb=0 -config=${TMP_CONF} -rnd-seed=${SEED} -time-lim=${TIMEOUT} \
+                -stats=${TMP_STATS} ${ROOT_DIR}/test/instances/${instance}.cnf > ${OUTPUT}/bench.out 2>&1
+            END=`date +%s.%N`
+            RESULT=UNKNOWN
+            grep -q "^s SATISFIABLE" ${OUTPUT}/bench.out && RESULT=SAT
+            grep -q "^s UNSATISFIABLE" ${OUTPUT}/bench.out && RESULT=UNSAT
+            if [ ! -f ${TMP_STATS} ]; then
+                awk -v threads=${threads} -v preset=${preset} -v instance=${instance} \
+                    -v result=${RESULT} -v start=${START} -v end=${END} 'BEGIN {
+                    printf "%s\t%s\t%s\t%s\t%.3f\t-\t-\t-\t-\t-\n", threads, preset, instance,
+                        result, end - start }' >> ${RESULTS}
+                continue
+            fi
+            # the fourth line of the stats file holds the values of the columns
+            # named on the third line
+            awk -F '\t' -v threads=${threads} -v preset=${preset} -v instance=${instance} \
+                -v result=${RESULT} -v start=${START} -v end=${END} '
+                NR == 3 { for (i = 1; i <= NF; i++) col[$i] = i }
+                NR == 4 {
+                    wall = end - start
+                    conflicts = $col["total conflicts"]
+                    props = $col["total propagations"]
+                    printf "%s\t%s\t%s\t%s\t%.3f\t%d\t%.0f\t%.0f\t%.2f\t%d\n", threads, preset,
+                        instance, result, wall, conflicts, conflicts / wall, props / wall,
+                        $col["peak memory"], $col["total exported"]
+                }' ${TMP_STATS} >> ${RESULTS}
+        done
+    done
+done
+
+rm -f ${TMP_CONF} ${TMP_STATS}
+cp ${RESULTS} ${OUTPUT}/latest.tsv
+column -t -s '	' ${RESULTS} 2>/dev/null || cat ${RESULTS}
+
+if [ ! -f ${BASELINE} ]; then
+    echo "no baseline to compare with, use 'make bench-baseline' to save these results as the baseline"
+    exit 0
+fi
+
+# Compare with the baseline: the throughputs must not drop and the wall time
+# must not grow by more than the tolerance. In deterministic mode, a different
+# number of conflicts means that the search itself changed.
+awk -F '\t' -v tol=${TOLERANCE} '
+    FNR == 1 { next }
+    NR == FNR { key = $1 "/" $2 "/" $3; wall[key] = $5; confl[key] = $6; cps[key] = $7; pps[key] = $8; next }
+    {
+        key = $1 "/" $2 "/" $3
+        if (!(key in wall)) { printf "new       %s\n", key; next }
+        if ($6 == "-" || confl[key] == "-") { printf "unsolved  %s\n", key; regressions++; next }
+        if ($6 != confl[key])
+            printf "changed   %s: %d conflicts instead of %d\n", key, $6, confl[key]
+        if ($5 > wall[key] * (1 + tol / 100.0)) {
+            printf "slower    %s: %.3fs instead of %.3fs\n", key, $5, wall[key]; regressions++
+        }
+        if ($7 < cps[key] * (1 - tol / 100.0)) {
+            printf "slower    %s: %.0f conflicts/s instead of %.0f\n", key, $7, cps[key]; regressions++
+        }
+        if ($8 < pps[key] * (1 - tol / 100.0)) {
+            printf "slower    %s: %.0f propagations/s instead of %.0f\n", key, $8, pps[key]; regressions++
+        }
+    }
+    END {
+        if (regressions > 0) { printf "%d regression(s) above %d%%\n", regressions, tol; exit 1 }
+        printf "no regression above %d%%\n", tol
+    }' ${BASELINE} ${RESULTS}
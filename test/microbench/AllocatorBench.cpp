@@ -0,0 +1,180 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#include "Microbench.h"
+
+#include "penelope/core/SolverTypes.h"
+#include "penelope/core/Solver.h"
+
+using namespace penelope;
+
+extern volatile uint64_t benchSink;
+
+/** The number of clauses used by the arena benchmarks */
+#define ARENA_CLAUSES 100000
+/** The number of variables of the clauses of the arena benchmarks */
+#define ARENA_VARS 20000
+
+/**
+ * Fill an allocator with learnt clauses of random size
+ * @param ca the allocator
+ * @param refs where the references of the clauses are stored
+ */
+static void fillArena(ClauseAllocator& ca, vec<CRef>& refs) {
+    uint64_t seed = 13;
+    vec<Lit> lits;
+    refs.clear();
+    for (int i = 0; i < ARENA_CLAUSES; i++) {
+        lits.clear();
+        int size = 3 + benchRandom(seed) % 28;
+        for (int j = 0; j < size; j++)
+            lits.push(mkLit(benchRandom(seed) % ARENA_VARS, benchRandom(seed) & 1));
+        refs.push(ca.alloc(lits, true));
+    }
+}
+
+/** Allocate learnt clauses in an empty arena */
+class ArenaAllocBench : public Microbench {
+public:
+    ArenaAllocBench() : Microbench("arena-alloc"), ca(NULL), refs() {
+    }
+
+    void setUp() {
+        ca = new ClauseAllocator();
+    }
+
+    void run() {
+        fillArena(*ca, refs);
+        benchSink = ca->size();
+    }
+
+    void tearDown() {
+        delete ca;
+        ca = NULL;
+    }
+
+    uint64_t operations() const {
+        return ARENA_CLAUSES;
+    }
+
+private:
+    ClauseAllocator* ca;
+    vec<CRef> refs;
+};
+
+/**
+ * Relocate the live half of the learnt clauses into a new arena, as done by
+ * garbageCollect after reduceDB
+ */
+class ArenaRelocBench : public Microbench {
+public:
+    ArenaRelocBench() : Microbench("arena-reloc"), ca(NULL), to(NULL), refs() {
+    }
+
+    void setUp() {
+        ca = new ClauseAllocator();
+        fillArena(*ca, refs);
+        int j = 0;
+        for (int i = 0; i < refs.size(); i++) {
+            if (i % 2 == 0) ca->free(refs[i]);
+            else refs[j++] = refs[i];
+        }
+        refs.shrink(refs.size() - j);
+        to = new ClauseAllocator(0, ca->learntSize() - ca->learntWasted());
+    }
+
+    void run() {
+        for (int i = 0; i < refs.size(); i++) ca->relocLearnt(refs[i], *to);
+        to->moveLearntsTo(*ca);
+        benchSink = ca->size();
+    }
+
+    void tearDown() {
+        delete to;
+        delete ca;
+        to = NULL;
+        ca = NULL;
+    }
+
+    uint64_t operations() const {
+        return ARENA_CLAUSES / 2;
+    }
+
+private:
+    ClauseAllocator* ca;
+    ClauseAllocator* to;
+    vec<CRef> refs;
+};
+
+/**
+ * Remove the watchers of deleted clauses from every dirty watch list, as
+ * done by propagate after reduceDB detached clauses lazily
+ */
+class OccListsCleanAllBench : public Microbench {
+public:
+    OccListsCleanAllBench() : Microbench("occlists-cleanall"), ca(), refs(),
+    watches(WatcherDeleted(ca)), nbWatchers(0) {
+        fillArena(ca, refs);
+        watches.initMem(ARENA_VARS);
+    }
+
+    void setUp() {
+        uint64_t seed = 17;
+        nbWatchers = 0;
+        for (int i = 0; i < 2 * ARENA_VARS; i++) watches[toLit(i)].clear();
+        for (int i = 0; i < refs.size(); i++) {
+            Clause& c = ca[refs[i]];
+            c.mark(0);
+            watches[~c[0]].push(Watcher(refs[i], c[1]));
+            watches[~c[1]].push(Watcher(refs[i], c[0]));
+            nbWatchers += 2;
+        }
+        // a third of the clauses are detached lazily
+        for (int i = 0; i < refs.size(); i++) {
+            if (benchRandom(seed) % 3 != 0) continue;
+            Clause& c = ca[refs[i]];
+            c.mark(1);
+            watches.smudge(~c[0]);
+            watches.smudge(~c[1]);
+        }
+    }
+
+    void run() {
+        watches.cleanAll();
+        benchSink = watches[toLit(0)].size();
+    }
+
+    uint64_t operations() const {
+        return nbWatchers;
+    }
+
+private:
+    ClauseAllocator ca;
+    vec<CRef> refs;
+    OccLists<Lit, Watcher, WatcherDeleted> watches;
+    uint64_t nbWatchers;
+};
+
+static ArenaAllocBench arenaAllocBench;
+static ArenaRelocBench arenaRelocBench;
+static OccListsCleanAllBench occListsCleanAllBench;
@@ -0,0 +1,255 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#include "Microbench.h"
+
+#include "penelope/utils/Vec.h"
+#include "penelope/utils/Heap.h"
+#include "penelope/utils/Sort.h"
+#include "penelope/core/SolverTypes.h"
+#include "penelope/core/BoundedQueue.h"
+
+using namespace penelope;
+
+/** The value read by the benchmarks, so that the compiler keeps their work */
+volatile uint64_t benchSink = 0;
+
+/**
+ * Push then pop a large number of elements, without the reallocations
+ * (the capacity is kept between repetitions)
+ */
+class VecPushPopBench : public Microbench {
+public:
+    VecPushPopBench() : Microbench("vec-push-pop"), v() {
+    }
+
+    void run() {
+        for (int i = 0; i < N; i++) v.push(i);
+        uint64_t sum = 0;
+        while (v.size() > 0) {
+            sum += v.last();
+            v.pop();
+        }
+        benchSink = sum;
+    }
+
+    uint64_t operations() const {
+        return 2 * N;
+    }
+
+private:
+    static const int N = 1 << 20;
+    vec<int> v;
+};
+
+/**
+ * The trail pattern: literals are pushed by small chunks (decisions and their
+ * propagations) and the trail is regularly shrunk by a random amount
+ * (backjumps)
+ */
+class VecTrailBench : public Microbench {
+public:
+    VecTrailBench() : Microbench("vec-trail"), trail(), pushes(0) {
+    }
+
+    void run() {
+        uint64_t seed = 1;
+        pushes = 0;
+        for (int i = 0; i < N; i++) {
+            int chunk = 1 + benchRandom(seed) % 32;
+            for (int j = 0; j < chunk; j++) trail.push(mkLit(j));
+            pushes += chunk;
+            if (trail.size() > 4096) trail.shrink(benchRandom(seed) % trail.size());
+        }
+        benchSink = trail.size();
+        trail.clear();
+    }
+
+    uint64_t operations() const {
+        return pushes == 0 ? N : pushes;
+    }
+
+private:
+    static const int N = 1 << 16;
+    vec<Lit> trail;
+    uint64_t pushes;
+};
+
+/**
+ * The decision heap under VSIDS: variables are removed from the heap as
+ * decisions, their activities are bumped as after conflicts and they are
+ * inserted back as after backjumps
+ */
+class HeapVsidsBench : public Microbench {
+public:
+    HeapVsidsBench() : Microbench("heap-vsids"), activity(), heap(VarOrderLt(activity)), removed() {
+    }
+
+    void setUp() {
+        uint64_t seed = 7;
+        activity.clear();
+        for (int i = 0; i < NB_VARS; i++) activity.push((benchRandom(seed) % 1000) * 1e-5);
+        heap.clear();
+        for (int i = 0; i < NB_VARS; i++) heap.insert(i);
+    }
+
+    void run() {
+        uint64_t seed = 11;
+        double inc = 1;
+        for (int round = 0; round < ROUNDS; round++) {
+            // decisions
+            for (int i = 0; i < DECISIONS && !heap.empty(); i++) removed.push(heap.removeMin());
+            // conflict analysis: bump some variables
+            for (int i = 0; i < BUMPS; i++) {
+                int v = benchRandom(seed) % NB_VARS;
+                activity[v] += inc;
+                if (heap.inHeap(v)) heap.decrease(v);
+            }
+            inc *= 1.05;
+            // backjump: the variables are available again
+            for (int i = 0; i < removed.size(); i++) heap.insert(removed[i]);
+            removed.clear();
+        }
+        benchSink = heap.size();
+    }
+
+    uint64_t operations() const {
+        return (uint64_t) ROUNDS * (2 * DECISIONS + BUMPS);
+    }
+
+private:
+    static const int NB_VARS = 100000;
+    static const int ROUNDS = 2000;
+    static const int DECISIONS = 20;
+    static const int BUMPS = 50;
+    vec<double> activity;
+    Heap<VarOrderLt> heap;
+    vec<int> removed;
+};
+
+/**
+ * The bounded queue used for the LBD and trail averages of the restarts
+ */
+class BQueueBench : public Microbench {
+public:
+    BQueueBench() : Microbench("bqueue-push-avg"), queue() {
+        queue.initSize(50);
+    }
+
+    void setUp() {
+        queue.fastclear();
+    }
+
+    void run() {
+        uint64_t sum = 0;
+        for (unsigned int i = 0; i < N; i++) {
+            queue.push(i & 127);
+            if (queue.isvalid()) sum += queue.getavg();
+        }
+        benchSink = sum;
+    }
+
+    uint64_t operations() const {
+        return N;
+    }
+
+private:
+    static const unsigned int N = 1 << 22;
+    bqueue<unsigned int> queue;
+};
+
+/** Sort random integers */
+class SortIntBench : public Microbench {
+public:
+    SortIntBench() : Microbench("sort-int"), values() {
+    }
+
+    void setUp() {
+        uint64_t seed = 3;
+        values.clear();
+        for (int i = 0; i < N; i++) values.push(benchRandom(seed));
+    }
+
+    void run() {
+        sort(values);
+        benchSink = values[0];
+    }
+
+    uint64_t operations() const {
+        return N;
+    }
+
+private:
+    static const int N = 1 << 20;
+    vec<uint32_t> values;
+};
+
+/**
+ * Sort with an indirect comparator, as when the learnt clauses are sorted by
+ * activity in reduceDB
+ */
+class SortIndirectBench : public Microbench {
+public:
+    SortIndirectBench() : Microbench("sort-indirect"), keys(), indices() {
+        uint64_t seed = 5;
+        for (int i = 0; i < N; i++) keys.push((benchRandom(seed) % 100000) / 7.0);
+    }
+
+    void setUp() {
+        indices.clear();
+        for (int i = 0; i < N; i++) indices.push(i);
+    }
+
+    void run() {
+        sort(indices, KeyLt(keys));
+        benchSink = indices[0];
+    }
+
+    uint64_t operations() const {
+        return N;
+    }
+
+private:
+
+    struct KeyLt {
+        const vec<double>& keys;
+
+        KeyLt(const vec<double>& k) : keys(k) {
+        }
+
+        bool operator()(int x, int y) const {
+            return keys[x] < keys[y];
+        }
+    };
+
+    static const int N = 1 << 18;
+    vec<double> keys;
+    vec<int> indices;
+};
+
+static VecPushPopBench vecPushPopBench;
+static VecTrailBench vecTrailBench;
+static HeapVsidsBench heapVsidsBench;
+static BQueueBench bqueueBench;
+static SortIntBench sortIntBench;
+static SortIndirectBench sortIndirectBench;
@@ -0,0 +1,107 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#include "Microbench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "penelope/utils/Sort.h"
+#include "penelope/utils/System.h"
+#include "penelope/utils/PerfCounters.h"
+
+using namespace penelope;
+
+const char* penelope::benchInstance = "../instances/dp10s10.shuffled.cnf";
+
+Microbench::Microbench(const char* aName) : name(aName) {
+    registry().push(this);
+}
+
+Microbench::~Microbench() {
+}
+
+vec<Microbench*>& Microbench::registry() {
+    static vec<Microbench*> benchs;
+    return benchs;
+}
+
+int penelope::runMicrobenchs(const char* filter, int warmup, int repetitions) {
+
+    PerfCounters counters;
+    counters.open();
+
+    printf("%-24s %12s %12s %12s %12s", "benchmark", "ops", "median ns/op", "min ns/op", "max ns/op");
+    if (counters.available(PerfCounters::PERF_INSTRUCTIONS) && counters.available(PerfCounters::PERF_CYCLES))
+        printf(" %8s", "IPC");
+    for (int c = PerfCounters::PERF_CACHE_MISSES; c <= PerfCounters::PERF_DTLB_MISSES; c++)
+        if (counters.available((PerfCounters::Counter) c))
+            printf(" %16s/op", PerfCounters::name((PerfCounters::Counter) c));
+    printf("\n");
+
+    int nbRun = 0;
+    vec<Microbench*>& benchs = Microbench::registry();
+    for (int b = 0; b < benchs.size(); b++) {
+        Microbench& bench = *benchs[b];
+        if (filter != NULL && strstr(bench.getName(), filter) == NULL) continue;
+        nbRun++;
+
+        for (int i = 0; i < warmup; i++) {
+            bench.setUp();
+            bench.run();
+            bench.tearDown();
+        }
+
+        vec<uint64_t> times;
+        uint64_t total[PerfCounters::PERF_NB_COUNTERS];
+        for (int c = 0; c < PerfCounters::PERF_NB_COUNTERS; c++) total[c] = 0;
+        for (int i = 0; i < repetitions; i++) {
+            uint64_t before[PerfCounters::PERF_NB_COUNTERS];
+            uint64_t after[PerfCounters::PERF_NB_COUNTERS];
+            bench.setUp();
+            counters.read(before);
+            uint64_t start = nanoTime();
+            bench.run();
+            uint64_t end = nanoTime();
+            counters.read(after);
+            bench.tearDown();
+            times.push(end - start);
+            for (int c = 0; c < PerfCounters::PERF_NB_COUNTERS; c++) total[c] += after[c] - before[c];
+        }
+        sort(times);
+
+        double ops = (double) bench.operations();
+        double allOps = ops * repetitions;
+        printf("%-24s %12.0f %12.2f %12.2f %12.2f", bench.getName(), ops,
+                times[times.size() / 2] / ops, times[0] / ops, times.last() / ops);
+        if (counters.available(PerfCounters::PERF_INSTRUCTIONS) && counters.available(PerfCounters::PERF_CYCLES))
+            printf(" %8.2f", total[PerfCounters::PERF_CYCLES] == 0 ? 0.0 :
+                (double) total[PerfCounters::PERF_INSTRUCTIONS] / total[PerfCounters::PERF_CYCLES]);
+        for (int c = PerfCounters::PERF_CACHE_MISSES; c <= PerfCounters::PERF_DTLB_MISSES; c++)
+            if (counters.available((PerfCounters::Counter) c))
+                printf(" %19.4f", total[c] / allOps);
+        printf("\n");
+        fflush(stdout);
+    }
+    return nbRun;
+}
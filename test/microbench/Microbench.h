@@ -0,0 +1,107 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef MICROBENCH_H
+#define	MICROBENCH_H
+
+#include "penelope/utils/IntTypes.h"
+#include "penelope/utils/Vec.h"
+
+namespace penelope {
+
+    /**
+     * A microbenchmark. Each benchmark registers itself at construction, so
+     * defining a static instance is enough to have it run.
+     *
+     * A repetition calls setUp, run and tearDown; only run is timed. The
+     * state modified by run must be rebuilt by setUp so that every
+     * repetition performs exactly the same work.
+     */
+    class Microbench {
+    public:
+
+        /**
+         * Create and register a benchmark
+         * @param name the name of the benchmark, used to filter them
+         */
+        Microbench(const char* name);
+
+        virtual ~Microbench();
+
+        /** Retrieve the name of the benchmark */
+        const char* getName() const {
+            return name;
+        }
+
+        /** Prepare a repetition, not timed */
+        virtual void setUp() {
+        }
+
+        /** The timed part of a repetition */
+        virtual void run() = 0;
+
+        /** Clean up after a repetition, not timed */
+        virtual void tearDown() {
+        }
+
+        /** The number of operations performed by run, used to report ns/op */
+        virtual uint64_t operations() const = 0;
+
+        /** Retrieve every registered benchmark */
+        static vec<Microbench*>& registry();
+
+    private:
+        const char* name;
+    };
+
+    /**
+     * Run the registered benchmarks and print one line per benchmark: the
+     * median, min and max time per operation and, when the performance
+     * counters are available, the counters per operation.
+     * @param filter only the benchmarks whose name contains filter are run,
+     *        NULL runs all of them
+     * @param warmup the number of repetitions that are not measured
+     * @param repetitions the number of measured repetitions
+     * @return the number of benchmarks that were run
+     */
+    int runMicrobenchs(const char* filter, int warmup, int repetitions);
+
+    /**
+     * A small deterministic random generator, so that every run of the
+     * benchmarks works on the same data
+     * @param seed the state of the generator
+     * @return a pseudo random number
+     */
+    static inline uint32_t benchRandom(uint64_t& seed) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (uint32_t) (seed >> 33);
+    }
+
+    /**
+     * The instance used by the benchmarks that need a real formula
+     */
+    extern const char* benchInstance;
+
+}
+
+#endif	/* MICROBENCH_H */
@@ -0,0 +1,168 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#include "Microbench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "penelope/core/Solver.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/utils/ParseUtils.h"
+#include "penelope/utils/INIParser.h"
+
+using namespace penelope;
+
+extern volatile uint64_t benchSink;
+
+/**
+ * A solver exposing what is needed to replay a sequence of decisions
+ */
+class BenchSolver : public Solver {
+public:
+
+    /**
+     * Load a DIMACS file in this solver
+     * @param fileName the name of the file
+     * @return false if the file couldn't be read or is trivially unsat
+     */
+    bool load(const char* fileName) {
+        FILE* f = fopen(fileName, "rb");
+        if (f == NULL) return false;
+        StreamBuffer in(f);
+        vec<Lit> lits;
+        bool ok = true;
+        for (;;) {
+            skipWhitespace(in);
+            if (*in == EOF) break;
+            if (*in == 'c' || *in == 'p') {
+                skipLine(in);
+                continue;
+            }
+            lits.clear();
+            for (;;) {
+                int parsed = parseInt(in);
+                if (parsed == 0) break;
+                int v = abs(parsed) - 1;
+                while (v >= nVars()) newVar();
+                lits.push(parsed > 0 ? mkLit(v) : ~mkLit(v));
+            }
+            ok = ok && addClause(lits);
+        }
+        fclose(f);
+        return ok;
+    }
+
+    /** Open a new decision level and assign a literal in it */
+    void decide(Lit p) {
+        newDecisionLevel();
+        uncheckedEnqueue(p);
+    }
+};
+
+/**
+ * Replay a fixed sequence of decisions on a real instance: each decision is
+ * propagated and every conflict leads back to level 0. The trace is recorded
+ * once with random decisions, so every repetition performs the very same
+ * propagations.
+ */
+class PropagateReplayBench : public Microbench {
+public:
+    PropagateReplayBench() : Microbench("propagate-replay"), coop(NULL), solver(NULL),
+    trace(), nbPropagations(0) {
+    }
+
+    ~PropagateReplayBench() {
+        delete solver;
+        delete coop;
+    }
+
+    void setUp() {
+        if (solver == NULL) record();
+        solver->cancelUntil(0);
+    }
+
+    void run() {
+        uint64_t before = solver->propagations;
+        for (int i = 0; i < trace.size(); i++) {
+            if (trace[i] == lit_Undef) {
+                solver->cancelUntil(0);
+                continue;
+            }
+            if (solver->value(trace[i]) != l_Undef) continue;
+            solver->decide(trace[i]);
+            solver->propagate();
+        }
+        nbPropagations = solver->propagations - before;
+        benchSink = nbPropagations;
+    }
+
+    uint64_t operations() const {
+        return nbPropagations == 0 ? 1 : nbPropagations;
+    }
+
+private:
+
+    /** The number of decisions of the trace */
+    static const int DECISIONS = 200000;
+
+    /** Load the instance and record the trace */
+    void record() {
+        coop = new Cooperation(1, 10);
+        INIParser parser(std::string(""));
+        solver = new BenchSolver();
+        solver->initialize(coop, 0, parser);
+        solver->threadId = 0;
+        solver->verbosity = 0;
+        if (!solver->load(benchInstance)) {
+            fprintf(stderr, "could not load %s\n", benchInstance);
+            exit(EXIT_FAILURE);
+        }
+        solver->propagate();
+
+        uint64_t seed = 23;
+        int decisions = 0;
+        while (decisions < DECISIONS) {
+            Var v = benchRandom(seed) % solver->nVars();
+            if (solver->value(v) != l_Undef) continue;
+            Lit p = mkLit(v, benchRandom(seed) & 1);
+            trace.push(p);
+            decisions++;
+            solver->decide(p);
+            if (solver->propagate() != CRef_Undef || solver->nAssigns() == solver->nVars()) {
+                // conflict (or complete assignment): back to level 0
+                trace.push(lit_Undef);
+                solver->cancelUntil(0);
+            }
+        }
+        trace.push(lit_Undef);
+    }
+
+    Cooperation* coop;
+    BenchSolver* solver;
+    /** The decisions, lit_Undef standing for a backjump to level 0 */
+    vec<Lit> trace;
+    uint64_t nbPropagations;
+};
+
+static PropagateReplayBench propagateReplayBench;
@@ -0,0 +1,49 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "penelope/utils/Options.h"
+#include "Microbench.h"
+
+using namespace penelope;
+
+int main(int argc, char** argv) {
+
+    StringOption filter("MAIN", "filter", "Only run the benchmarks whose name contains this string", NULL);
+    IntOption warmup("MAIN", "warmup", "The number of repetitions that are not measured", 2, IntRange(0, 1000));
+    IntOption repetitions("MAIN", "reps", "The number of measured repetitions", 11, IntRange(1, 10000));
+    StringOption instance("MAIN", "instance", "The instance used by the propagation benchmark", benchInstance);
+
+    setUsageHelp("USAGE: %s [options]\n\n  runs the microbenchmarks of penelope\n");
+    parseOptions(argc, argv, true);
+    benchInstance = instance;
+
+    int nbRun = runMicrobenchs(filter, warmup, repetitions);
+    if (nbRun == 0) {
+        printf("no benchmark matches the filter\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#include "ClauseAllocatorTest.h"
+
+#include "../../include/penelope/core/SolverTypes.h"
+
+using namespace penelope;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ClauseAllocatorTest);
+
+static void fillClause(vec<Lit>& lits, int first, int size){
+    lits.clear();
+    for(int i=0; i<size; i++){
+        lits.push(mkLit(first+i, i%2==0));
+    }
+}
+
+void ClauseAllocatorTest::testRegions(){
+    ClauseAllocator ca(16, 16);
+    vec<Lit> lits;
+    fillClause(lits, 0, 3);
+    CRef p = ca.alloc(lits, false);
+    fillClause(lits, 10, 4);
+    CRef l = ca.alloc(lits, true);
+
+    CPPUNIT_ASSERT(!ClauseAllocator::inLearntRegion(p));
+    CPPUNIT_ASSERT(ClauseAllocator::inLearntRegion(l));
+    CPPUNIT_ASSERT(l != CRef_Undef);
+    CPPUNIT_ASSERT_EQUAL(3, ca[p].size());
+    CPPUNIT_ASSERT_EQUAL(4, ca[l].size());
+    CPPUNIT_ASSERT(!ca[p].learnt());
+    CPPUNIT_ASSERT(ca[l].learnt());
+    CPPUNIT_ASSERT(mkLit(10, true) == ca[l][0]);
+    CPPUNIT_ASSERT_EQUAL(ca.problemSize() + ca.learntSize(), ca.size());
+    CPPUNIT_ASSERT_EQUAL(l, ca.ael(ca.lea(l)));
+    CPPUNIT_ASSERT_EQUAL(p, ca.ael(ca.lea(p)));
+
+    uint32_t problemSize = ca.problemSize();
+    ca.free(l);
+    CPPUNIT_ASSERT_EQUAL(0u, ca.problemWasted());
+    CPPUNIT_ASSERT(ca.learntWasted() > 0);
+    CPPUNIT_ASSERT_EQUAL(problemSize, ca.problemSize());
+}
+
+void ClauseAllocatorTest::testLearntRelocation(){
+    ClauseAllocator ca(16, 16);
+    vec<Lit> lits;
+    fillClause(lits, 0, 3);
+    CRef p = ca.alloc(lits, false);
+    fillClause(lits, 5, 5);
+    CRef dead = ca.alloc(lits, true);
+    fillClause(lits, 20, 2);
+    CRef l = ca.alloc(lits, true);
+    ca[l].lbd(2);
+    ca[l].setGenerator(3);
+    ca.free(dead);
+
+    ClauseAllocator to(0, ca.learntSize() - ca.learntWasted());
+    CRef oldP = p;
+    ca.relocLearnt(p, to);
+    ca.relocLearnt(l, to);
+    to.moveLearntsTo(ca);
+
+    CPPUNIT_ASSERT_EQUAL(oldP, p);
+    CPPUNIT_ASSERT_EQUAL(3, ca[p].size());
+    CPPUNIT_ASSERT(mkLit(0, true) == ca[p][0]);
+    CPPUNIT_ASSERT_EQUAL(2, ca[l].size());
+    CPPUNIT_ASSERT(mkLit(20, true) == ca[l][0]);
+    CPPUNIT_ASSERT_EQUAL(2u, ca[l].lbd());
+    CPPUNIT_ASSERT_EQUAL(3, ca[l].getGenerator());
+    CPPUNIT_ASSERT_EQUAL(0u, ca.learntWasted());
+}
+
+void ClauseAllocatorTest::testFullRelocation(){
+    ClauseAllocator ca(16, 16);
+    vec<Lit> lits;
+    fillClause(lits, 0, 3);
+    CRef dead = ca.alloc(lits, false);
+    fillClause(lits, 3, 3);
+    CRef p = ca.alloc(lits, false);
+    fillClause(lits, 20, 2);
+    CRef l = ca.alloc(lits, true);
+    ca.free(dead);
+
+    ClauseAllocator to(ca.problemSize() - ca.problemWasted(), ca.learntSize() - ca.learntWasted());
+    ca.reloc(p, to);
+    ca.reloc(l, to);
+    to.moveTo(ca);
+
+    CPPUNIT_ASSERT_EQUAL(0u, ca.wasted());
+    CPPUNIT_ASSERT(!ClauseAllocator::inLearntRegion(p));
+    CPPUNIT_ASSERT(ClauseAllocator::inLearntRegion(l));
+    CPPUNIT_ASSERT(mkLit(3, true) == ca[p][0]);
+    CPPUNIT_ASSERT(mkLit(21, false) == ca[l][1]);
+}
@@ -0,0 +1,56 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef CLAUSEALLOCATORTEST_H
+#define	CLAUSEALLOCATORTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ClauseAllocatorTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(ClauseAllocatorTest);
+    CPPUNIT_TEST(testRegions);
+    CPPUNIT_TEST(testLearntRelocation);
+    CPPUNIT_TEST(testFullRelocation);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check that problem and learnt clauses are stored in their own region
+     */
+    void testRegions();
+
+    /**
+     * Check that a learnt only relocation keeps the problem references
+     */
+    void testLearntRelocation();
+
+    /**
+     * Check that a full relocation compacts both regions
+     */
+    void testFullRelocation();
+
+};
+
+#endif	/* CLAUSEALLOCATORTEST_H */
+
@@ -3,6 +3,8 @@
 #include "penelope/core/Dimacs.h"
 #include "Thread.h"
 
+#include <stdio.h>
+
 CPPUNIT_TEST_SUITE_REGISTRATION(CooperationTest);
 
 using namespace penelope;
@@ -43,22 +45,7 @@ private:
 bool CooperationTest::solve(const char* fileName, int nbThreads ) {
     int limitExport = 10;
     Cooperation coop(nbThreads, limitExport);
-
-    coop.ctrl = 0;
-    coop.deterministic_mode = true;
-    INIParser parser(std::string("configuration.ini"));
-    parser.parse();
-    for (int t = 0; t < nbThreads; t++) {
-        coop.solvers[t].initialize(&coop, t, parser);
-        coop.solvers[t].threadId = t;
-        coop.solvers[t].verbosity = 0;
-        coop.solvers[t].deterministic_mode = true;
-    }
-
-    FILE* in = fopen(fileName, "rb");
-    CPPUNIT_ASSERT(in != NULL);
-    DimacsParser::parse_DIMACS(in, &coop);
-    fclose(in);
+    load(coop, fileName, true);
 
     SolverLauncher * threads[nbThreads];
     for (int t = 0; t < nbThreads; t++) {
@@ -84,3 +71,121 @@ bool CooperationTest::solve(const char* fileName, int nbThreads ) {
 }
 
 
+
+void CooperationTest::load(Cooperation& coop, const char* fileName, int determ) {
+    coop.ctrl = 0;
+    coop.deterministic_mode = determ;
+    INIParser parser(std::string("configuration.ini"));
+    parser.parse();
+    for (int t = 0; t < coop.nThreads(); t++) {
+        coop.solvers[t].initialize(&coop, t, parser);
+        coop.solvers[t].threadId = t;
+        coop.solvers[t].verbosity = 0;
+        coop.solvers[t].deterministic_mode = determ;
+    }
+
+    FILE* in = fopen(fileName, "rb");
+    CPPUNIT_ASSERT(in != NULL);
+    DimacsParser::parse_DIMACS(in, &coop);
+    fclose(in);
+}
+
+void CooperationTest::testReplay() {
+    const char* fileName = "instances/dp10s10.shuffled.cnf";
+    const char* logNames[] = {"replay-test.0", "replay-test.1"};
+    const int nbThreads = 2;
+    uint64_t conflicts[nbThreads];
+    uint64_t decisions[nbThreads];
+    uint64_t propagations[nbThreads];
+
+    {
+        Cooperation coop(nbThreads, 10);
+        load(coop, fileName, 0);
+        for (int t = 0; t < nbThreads; t++) {
+            ReplayLog* log = new ReplayLog();
+            CPPUNIT_ASSERT(log->record(logNames[t], t, nbThreads, 0));
+            coop.setReplayLog(t, log);
+        }
+        SolverLauncher * threads[nbThreads];
+        for (int t = 0; t < nbThreads; t++) {
+            threads[t] = new SolverLauncher(&(coop.solvers[t]), &coop);
+            threads[t]->start();
+        }
+        for (int t = 0; t < nbThreads; t++) {
+            threads[t]->join();
+            delete(threads[t]);
+            conflicts[t] = coop.solvers[t].conflicts;
+            decisions[t] = coop.solvers[t].decisions;
+            propagations[t] = coop.solvers[t].propagations;
+        }
+    }
+
+    for (int t = 0; t < nbThreads; t++) {
+        ReplayLog* log = new ReplayLog();
+        CPPUNIT_ASSERT(log->replay(logNames[t]));
+        CPPUNIT_ASSERT_EQUAL(t, log->thread());
+        CPPUNIT_ASSERT_EQUAL(nbThreads, log->nbThreads());
+
+        Cooperation coop(nbThreads, 10);
+        load(coop, fileName, log->mode());
+        coop.setReplayLog(t, log);
+        vec<Lit> assumpt;
+        coop.solvers[t].solveLimited(assumpt, &coop);
+
+        CPPUNIT_ASSERT_EQUAL(0, log->nbDivergences());
+        CPPUNIT_ASSERT_EQUAL(conflicts[t], coop.solvers[t].conflicts);
+        CPPUNIT_ASSERT_EQUAL(decisions[t], coop.solvers[t].decisions);
+        CPPUNIT_ASSERT_EQUAL(propagations[t], coop.solvers[t].propagations);
+        remove(logNames[t]);
+    }
+}
+
+class DivideLauncher : public Thread {
+public:
+
+    DivideLauncher(Solver* aSolver, Cooperation* aCoop) : Thread(), s(aSolver), c(aCoop) {
+    }
+
+    void run() {
+        s->solveGuidingPaths(c);
+    }
+
+private:
+    Solver* s;
+    Cooperation* c;
+
+};
+
+bool CooperationTest::divide(const char* fileName, int nbThreads) {
+    Cooperation coop(nbThreads, 10);
+    load(coop, fileName, 0);
+    for (int t = 0; t < nbThreads; t++) coop.solvers[t].divideWorker = true;
+    CPPUNIT_ASSERT_EQUAL(nbThreads, coop.updateDivide(true));
+
+    DivideLauncher * threads[nbThreads];
+    for (int t = 0; t < nbThreads; t++) {
+        threads[t] = new DivideLauncher(&(coop.solvers[t]), &coop);
+        threads[t]->start();
+    }
+
+    lbool sol = l_Undef;
+    for (int t = 0; t < nbThreads; t++) {
+        threads[t]->join();
+        if (coop.answer(t) != l_Undef) sol = coop.answer(t);
+        delete(threads[t]);
+    }
+    CPPUNIT_ASSERT(sol != l_Undef);
+    return sol == l_True;
+}
+
+void CooperationTest::testDivide() {
+    CPPUNIT_ASSERT_EQUAL(false, divide("instances/dp04u03.shuffled.cnf", 3));
+    CPPUNIT_ASSERT_EQUAL(true, divide("instances/dp10s10.shuffled.cnf", 3));
+
+    // the divide and conquer mode isn't available in deterministic mode
+    Cooperation coop(2, 10);
+    load(coop, "instances/dp04u03.shuffled.cnf", 2);
+    coop.solvers[1].divideWorker = true;
+    CPPUNIT_ASSERT_EQUAL(0, coop.updateDivide(false));
+    CPPUNIT_ASSERT(!coop.isDivide(1));
+}
@@ -29,6 +29,10 @@ freely, subject to the following restrictions:
 #include "../../include/penelope/utils/Vec.h"
 #include "../../include/penelope/core/SolverTypes.h"
 
+namespace penelope {
+    class Cooperation;
+}
+
 class CooperationTest : public CppUnit::TestFixture {
 public:
 
@@ -37,6 +41,8 @@ public:
     CPPUNIT_TEST(testdp04s);
     CPPUNIT_TEST(testdp04u);
     CPPUNIT_TEST(testaaai10);
+    CPPUNIT_TEST(testReplay);
+    CPPUNIT_TEST(testDivide);
     CPPUNIT_TEST_SUITE_END();
 
     void testdp10();
@@ -44,11 +50,33 @@ public:
     void testdp04u();
     void testaaai10();
 
+    /**
+     * Record a non deterministic run and check that the replay of a thread
+     * does exactly what the thread did
+     */
+    void testReplay();
+
+    /**
+     * Check the answers of threads dividing the search space on
+     * satisfiable and unsatisfiable instances
+     */
+    void testDivide();
+
 
 private:
 
     bool solve(const char* fileName, int nbThreads = 1);
 
+    /**
+     * Solve an instance with threads dividing the search space
+     */
+    bool divide(const char* fileName, int nbThreads);
+
+    /**
+     * Initialize the solvers of a cooperation and load an instance in them
+     */
+    void load(penelope::Cooperation& coop, const char* fileName, int determ);
+
 };
 
 #endif	/* COOPERATIONTEST_H */
@@ -0,0 +1,114 @@
+#include "CuberTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/core/Cuber.h"
+#include "penelope/core/Dimacs.h"
+#include "penelope/core/ParameterSpace.h"
+
+#include <stdio.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CuberTest);
+
+using namespace penelope;
+
+/** The number of variables of the small random formula */
+#define COVER_VARS 16
+/** The number of clauses of the small random formula */
+#define COVER_CLAUSES 60
+
+/**
+ * Take every guiding path of the cooperation
+ * @param lits where the literals of the paths are stored
+ * @param starts where the position of the first literal of each path is stored
+ */
+static void takeAll(Cooperation& coop, vec<Lit>& lits, vec<int>& starts) {
+    coop.guidingPaths.setWorkers(1);
+    vec<Lit> path;
+    while (coop.guidingPaths.nbQueued() > 0) {
+        CPPUNIT_ASSERT_EQUAL(GuidingPaths::PATH_TAKEN, coop.guidingPaths.take(path));
+        starts.push(lits.size());
+        for (int i = 0; i < path.size(); i++) lits.push(path[i]);
+    }
+    starts.push(lits.size());
+}
+
+void CuberTest::testCover() {
+    Cooperation coop(1, 10);
+    SolverFixture::initialize(coop);
+    Solver& s = coop.solvers[0];
+    while (s.nVars() < COVER_VARS) s.newVar();
+
+    uint64_t seed = 5;
+    vec<Lit> clauses;
+    vec<Lit> lits;
+    for (int c = 0; c < COVER_CLAUSES; c++) {
+        lits.clear();
+        while (lits.size() < 3) {
+            Lit l = mkLit(ParameterSpace::random(seed) % COVER_VARS, ParameterSpace::random(seed) & 1);
+            bool known = false;
+            for (int i = 0; i < lits.size(); i++) known = known || var(lits[i]) == var(l);
+            if (!known) lits.push(l);
+        }
+        for (int i = 0; i < 3; i++) clauses.push(lits[i]);
+        s.addClause(lits);
+    }
+
+    Cuber cuber(s);
+    lbool cubed = cuber.generate(8, coop.guidingPaths);
+    vec<Lit> cubeLits;
+    vec<int> starts;
+    if (cubed == l_Undef) {
+        CPPUNIT_ASSERT(cuber.nbCubes() <= 8);
+        takeAll(coop, cubeLits, starts);
+        CPPUNIT_ASSERT_EQUAL(cuber.nbCubes() + 1, starts.size());
+    }
+
+    for (unsigned int m = 0; m < (1u << COVER_VARS); m++) {
+        bool model = true;
+        for (int c = 0; c < clauses.size() && model; c += 3) {
+            bool satisfied = false;
+            for (int i = c; i < c + 3; i++)
+                satisfied = satisfied || (((m >> var(clauses[i])) & 1) != 0) != sign(clauses[i]);
+            model = satisfied;
+        }
+        if (!model) continue;
+        // the formula is satisfiable, so one of the cubes holds in this model
+        CPPUNIT_ASSERT(cubed == l_Undef);
+        bool covered = false;
+        for (int k = 0; k + 1 < starts.size() && !covered; k++) {
+            covered = true;
+            for (int i = starts[k]; i < starts[k + 1] && covered; i++)
+                covered = (((m >> var(cubeLits[i])) & 1) != 0) != sign(cubeLits[i]);
+        }
+        CPPUNIT_ASSERT(covered);
+    }
+}
+
+void CuberTest::testInstances() {
+    const char* files[] = {"instances/dp04u03.shuffled.cnf", "instances/dp10s10.shuffled.cnf"};
+    for (int f = 0; f < 2; f++) {
+        Cooperation coop(1, 10);
+        SolverFixture::initialize(coop);
+        FILE* in = fopen(files[f], "rb");
+        CPPUNIT_ASSERT(in != NULL);
+        DimacsParser::parse_DIMACS(in, &coop);
+        fclose(in);
+        Solver& s = coop.solvers[0];
+        CPPUNIT_ASSERT(s.simplify(&coop));
+
+        Cuber cuber(s);
+        lbool cubed = cuber.generate(16, coop.guidingPaths);
+        bool sat = false;
+        if (cubed == l_Undef) {
+            vec<Lit> cubeLits, cube;
+            vec<int> starts;
+            takeAll(coop, cubeLits, starts);
+            for (int k = 0; k + 1 < starts.size() && !sat; k++) {
+                cube.clear();
+                for (int i = starts[k]; i < starts[k + 1]; i++) cube.push(cubeLits[i]);
+                sat = s.solveLimited(cube, &coop) == l_True;
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(f == 1, sat);
+    }
+}
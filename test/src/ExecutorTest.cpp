@@ -0,0 +1,134 @@
+#include "ExecutorTest.h"
+
+#include "../../include/penelope/utils/Executor.h"
+#include "../../include/penelope/utils/Barrier.h"
+#include "../../include/penelope/utils/EpochClock.h"
+
+using namespace penelope;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ExecutorTest);
+
+#define NB_WORKERS 4
+#define NB_ROUNDS 100
+
+/** Count the executions of each worker */
+class CountTask : public Task {
+public:
+    CountTask() {
+        for (int i = 0; i < NB_WORKERS; i++) executions[i] = 0;
+    }
+
+    void execute(int worker) {
+        executions[worker]++;
+    }
+
+    int executions[NB_WORKERS];
+};
+
+/**
+ * Each worker goes through a barrier at every round and checks that every
+ * other worker reached the round too
+ */
+class BarrierTask : public Task {
+public:
+    BarrierTask(Barrier& b) : barrier(b), errors(0) {
+        for (int i = 0; i < NB_ROUNDS; i++) arrived[i] = 0;
+    }
+
+    void execute(int) {
+        for (int r = 0; r < NB_ROUNDS; r++) {
+            __sync_fetch_and_add(&arrived[r], 1);
+            barrier.wait();
+            if (__sync_fetch_and_add(&arrived[r], 0) != NB_WORKERS)
+                __sync_fetch_and_add(&errors, 1);
+        }
+    }
+
+    Barrier& barrier;
+    int arrived[NB_ROUNDS];
+    int errors;
+};
+
+/** Half of the workers leave the barrier, the others keep using it */
+class LeaveTask : public Task {
+public:
+    LeaveTask(Barrier& b) : barrier(b), rounds(0) {
+    }
+
+    void execute(int worker) {
+        if (worker % 2 == 1) {
+            barrier.leave();
+            return;
+        }
+        for (int r = 0; r < NB_ROUNDS; r++) barrier.wait();
+        __sync_fetch_and_add(&rounds, NB_ROUNDS);
+        barrier.leave();
+    }
+
+    Barrier& barrier;
+    int rounds;
+};
+
+/**
+ * Each worker completes epochs and waits for the others to complete the
+ * previous one; the last worker finishes early
+ */
+class EpochTask : public Task {
+public:
+    EpochTask(EpochClock& c) : clock(c), errors(0) {
+    }
+
+    void execute(int worker) {
+        int rounds = worker == NB_WORKERS - 1 ? NB_ROUNDS / 2 : NB_ROUNDS;
+        for (int e = 1; e <= rounds; e++) {
+            clock.publish(worker, e);
+            clock.waitOthers(worker, e - 1);
+            for (int k = 0; k < NB_WORKERS; k++)
+                if (clock.epoch(k) < e - 1) __sync_fetch_and_add(&errors, 1);
+        }
+        clock.finish(worker);
+    }
+
+    EpochClock& clock;
+    int errors;
+};
+
+void ExecutorTest::testRunEachWorker() {
+    ThreadPoolExecutor executor(NB_WORKERS);
+    CPPUNIT_ASSERT_EQUAL(NB_WORKERS, executor.nbWorkers());
+    CountTask task;
+    for (int i = 0; i < 3; i++) executor.run(task);
+    for (int i = 0; i < NB_WORKERS; i++)
+        CPPUNIT_ASSERT_EQUAL(3, task.executions[i]);
+}
+
+void ExecutorTest::testBarrier() {
+    ThreadPoolExecutor executor(NB_WORKERS);
+    Barrier barrier(NB_WORKERS);
+    BarrierTask task(barrier);
+    executor.run(task);
+    CPPUNIT_ASSERT_EQUAL(0, task.errors);
+}
+
+void ExecutorTest::testLeaveBarrier() {
+    ThreadPoolExecutor executor(NB_WORKERS);
+    Barrier barrier(NB_WORKERS);
+    LeaveTask task(barrier);
+    executor.run(task);
+    CPPUNIT_ASSERT_EQUAL(NB_WORKERS / 2 * NB_ROUNDS, task.rounds);
+    CPPUNIT_ASSERT_EQUAL(0, barrier.nbParticipants());
+    barrier.reset(NB_WORKERS);
+    CPPUNIT_ASSERT_EQUAL(NB_WORKERS, barrier.nbParticipants());
+}
+
+void ExecutorTest::testEpochClock() {
+    ThreadPoolExecutor executor(NB_WORKERS);
+    EpochClock clock(NB_WORKERS);
+    EpochTask task(clock);
+    executor.run(task);
+    CPPUNIT_ASSERT_EQUAL(0, task.errors);
+    for (int i = 0; i < NB_WORKERS; i++)
+        CPPUNIT_ASSERT_EQUAL(EpochClock::FINISHED, clock.epoch(i));
+    clock.reset();
+    CPPUNIT_ASSERT_EQUAL(0, clock.epoch(0));
+}
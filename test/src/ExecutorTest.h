@@ -0,0 +1,64 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef EXECUTORTEST_H
+#define	EXECUTORTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ExecutorTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(ExecutorTest);
+    CPPUNIT_TEST(testRunEachWorker);
+    CPPUNIT_TEST(testBarrier);
+    CPPUNIT_TEST(testLeaveBarrier);
+    CPPUNIT_TEST(testEpochClock);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check that a task is executed once by each worker, several times in a
+     * row with the same pool
+     */
+    void testRunEachWorker();
+
+    /**
+     * Check that no worker goes past a barrier before the others reached it
+     */
+    void testBarrier();
+
+    /**
+     * Check that the workers still waiting are released when the others
+     * leave the barrier
+     */
+    void testLeaveBarrier();
+
+    /**
+     * Check that a thread waiting for an epoch never goes on before the
+     * others completed it, and that finished threads are not waited for
+     */
+    void testEpochClock();
+
+};
+
+#endif	/* EXECUTORTEST_H */
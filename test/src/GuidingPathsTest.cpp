@@ -0,0 +1,71 @@
+#include "GuidingPathsTest.h"
+#include "penelope/core/GuidingPaths.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(GuidingPathsTest);
+
+using namespace penelope;
+
+void GuidingPathsTest::testRefute() {
+    GuidingPaths paths;
+    paths.setWorkers(2);
+    CPPUNIT_ASSERT(paths.wanted());
+
+    // the first path is the whole space
+    vec<Lit> path;
+    CPPUNIT_ASSERT_EQUAL(GuidingPaths::PATH_TAKEN, paths.take(path));
+    CPPUNIT_ASSERT_EQUAL(0, path.size());
+    CPPUNIT_ASSERT(paths.wanted());
+
+    // the busy thread goes on with a, then with ~b
+    Lit a = mkLit(0), b = mkLit(1);
+    path.clear();
+    path.push(~a);
+    paths.split(path);
+    CPPUNIT_ASSERT(!paths.wanted());
+    path.clear();
+    path.push(a);
+    path.push(b);
+    paths.split(path);
+    CPPUNIT_ASSERT_EQUAL(2, paths.nbQueued());
+    CPPUNIT_ASSERT_EQUAL(2, paths.nbSplits());
+
+    // refuting a also refutes the queued path a b
+    vec<Lit> conflict;
+    conflict.push(~a);
+    CPPUNIT_ASSERT_EQUAL(1, paths.refute(conflict));
+    CPPUNIT_ASSERT_EQUAL(1, paths.nbQueued());
+    CPPUNIT_ASSERT(!paths.exhausted());
+
+    CPPUNIT_ASSERT_EQUAL(GuidingPaths::PATH_TAKEN, paths.take(path));
+    CPPUNIT_ASSERT_EQUAL(1, path.size());
+    CPPUNIT_ASSERT(path[0] == ~a);
+    conflict.clear();
+    conflict.push(a);
+    CPPUNIT_ASSERT_EQUAL(0, paths.refute(conflict));
+    CPPUNIT_ASSERT(paths.exhausted());
+    CPPUNIT_ASSERT_EQUAL(GuidingPaths::PATH_EXHAUSTED, paths.take(path));
+    CPPUNIT_ASSERT_EQUAL(2, paths.nbRefuted());
+    CPPUNIT_ASSERT_EQUAL(1, paths.nbPruned());
+}
+
+void GuidingPathsTest::testRelease() {
+    GuidingPaths paths;
+    paths.setWorkers(1);
+    vec<Lit> path;
+    CPPUNIT_ASSERT_EQUAL(GuidingPaths::PATH_TAKEN, paths.take(path));
+    CPPUNIT_ASSERT(!paths.wanted());
+
+    path.push(mkLit(3, true));
+    paths.release(path);
+    CPPUNIT_ASSERT_EQUAL(1, paths.nbQueued());
+    path.clear();
+    CPPUNIT_ASSERT_EQUAL(GuidingPaths::PATH_TAKEN, paths.take(path));
+    CPPUNIT_ASSERT_EQUAL(1, path.size());
+    CPPUNIT_ASSERT(path[0] == mkLit(3, true));
+
+    GuidingPaths none;
+    none.setWorkers(1);
+    none.clear();
+    CPPUNIT_ASSERT_EQUAL(GuidingPaths::PATH_NONE, none.take(path));
+    CPPUNIT_ASSERT(!none.exhausted());
+}
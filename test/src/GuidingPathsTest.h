@@ -0,0 +1,52 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef GUIDINGPATHSTEST_H
+#define	GUIDINGPATHSTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class GuidingPathsTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(GuidingPathsTest);
+    CPPUNIT_TEST(testRefute);
+    CPPUNIT_TEST(testRelease);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check that the splits feed the idle threads, that a refutation
+     * prunes the queued paths it covers, and that the space is exhausted
+     * once every path is refuted
+     */
+    void testRefute();
+
+    /**
+     * Check that a path given back is taken again, and that an empty queue
+     * isn't taken for an exhausted space
+     */
+    void testRelease();
+
+};
+
+#endif	/* GUIDINGPATHSTEST_H */
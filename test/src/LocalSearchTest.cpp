@@ -0,0 +1,147 @@
+#include "LocalSearchTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/core/LocalSearch.h"
+#include "penelope/core/ParameterSpace.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LocalSearchTest);
+
+using namespace penelope;
+
+/** The number of variables of the planted formula */
+#define PLANTED_VARS 300
+/** The number of clauses of the planted formula */
+#define PLANTED_CLAUSES 1200
+
+/**
+ * Load in every solver a random 3-SAT formula satisfied by a hidden
+ * assignment
+ * @param coop the cooperation holding the solvers
+ * @param clauses where the literals of the clauses are stored, 3 by 3
+ */
+static void plant(Cooperation& coop, vec<Lit>& clauses) {
+    uint64_t seed = 17;
+    vec<char> hidden;
+    for (int v = 0; v < PLANTED_VARS; v++) hidden.push(ParameterSpace::random(seed) & 1);
+
+    for (int t = 0; t < coop.nThreads(); t++) {
+        coop.solvers[t].initialiseMem(PLANTED_VARS, PLANTED_CLAUSES);
+        while (coop.solvers[t].nVars() < PLANTED_VARS) coop.solvers[t].newVar();
+    }
+
+    vec<Lit> lits;
+    while (clauses.size() < 3 * PLANTED_CLAUSES) {
+        lits.clear();
+        bool satisfied = false;
+        while (lits.size() < 3) {
+            Var v = ParameterSpace::random(seed) % PLANTED_VARS;
+            bool known = false;
+            for (int i = 0; i < lits.size(); i++) known = known || var(lits[i]) == v;
+            if (known) continue;
+            lits.push(mkLit(v, ParameterSpace::random(seed) & 1));
+            satisfied = satisfied || hidden[v] != sign(lits.last());
+        }
+        if (!satisfied) continue;
+        for (int i = 0; i < lits.size(); i++) clauses.push(lits[i]);
+        for (int t = 0; t < coop.nThreads(); t++) coop.solvers[t].addClause(lits);
+    }
+}
+
+void LocalSearchTest::testSolve() {
+    INIParser parser(std::string(""));
+    parser.setValueForConf("solver0", "solverType", "localsearch");
+    Cooperation coop(2, 10);
+    SolverFixture::initialize(coop, parser);
+    CPPUNIT_ASSERT_EQUAL(1, coop.updateLocalSearch(true));
+    CPPUNIT_ASSERT(coop.isLocalSearch(0));
+
+    vec<Lit> clauses;
+    plant(coop, clauses);
+    LocalSearch localSearch(coop.solvers[0], &coop);
+    CPPUNIT_ASSERT(localSearch.solve() == l_True);
+    CPPUNIT_ASSERT(coop.answer(0) == l_True);
+    CPPUNIT_ASSERT_EQUAL(0, localSearch.bestUnsat());
+
+    const vec<lbool>& model = coop.solvers[0].model;
+    CPPUNIT_ASSERT_EQUAL(PLANTED_VARS, model.size());
+    for (int c = 0; c < clauses.size(); c += 3) {
+        bool satisfied = false;
+        for (int i = c; i < c + 3; i++)
+            satisfied = satisfied || (model[var(clauses[i])] == l_True) != sign(clauses[i]);
+        CPPUNIT_ASSERT(satisfied);
+    }
+}
+
+void LocalSearchTest::testPhaseExchange() {
+    INIParser parser(std::string(""));
+    parser.setValueForConf("solver1", "solverType", "localsearch");
+    parser.setValueForConf("solver2", "localSearchPhases", "false");
+    Cooperation coop(3, 10);
+    SolverFixture::initialize(coop, parser);
+    CPPUNIT_ASSERT_EQUAL(1, coop.updateLocalSearch(true));
+    CPPUNIT_ASSERT(!coop.isLocalSearch(0));
+    vec<Lit> clauses;
+    plant(coop, clauses);
+
+    // nothing was published by the CDCL solvers yet
+    vec<char> phases;
+    uint64_t version = 0;
+    CPPUNIT_ASSERT(!coop.fetchSolverPhases(phases, version));
+
+    // the next CDCL solver that restarts answers the request
+    vec<char> expected, unchanged;
+    coop.solvers[0].getPolarities(expected);
+    coop.solvers[2].getPolarities(unchanged);
+    coop.exchangePhases(&coop.solvers[0]);
+    CPPUNIT_ASSERT(coop.fetchSolverPhases(phases, version));
+    CPPUNIT_ASSERT_EQUAL(expected.size(), phases.size());
+    for (int v = 0; v < phases.size(); v++) CPPUNIT_ASSERT_EQUAL(expected[v], phases[v]);
+    CPPUNIT_ASSERT(!coop.fetchSolverPhases(phases, version));
+
+    // the assignment of the local search becomes the polarities
+    vec<char> published;
+    for (int v = 0; v < PLANTED_VARS; v++) published.push(!expected[v]);
+    coop.publishLocalSearchPhases(published, 5);
+    coop.exchangePhases(&coop.solvers[0]);
+    coop.exchangePhases(&coop.solvers[2]);
+    vec<char> current;
+    coop.solvers[0].getPolarities(current);
+    for (int v = 0; v < PLANTED_VARS; v++) CPPUNIT_ASSERT_EQUAL(published[v], current[v]);
+    // unless the solver does not want them
+    coop.solvers[2].getPolarities(current);
+    for (int v = 0; v < PLANTED_VARS; v++) CPPUNIT_ASSERT_EQUAL(unchanged[v], current[v]);
+
+    // a worse assignment does not replace it
+    coop.publishLocalSearchPhases(expected, 6);
+    coop.exchangePhases(&coop.solvers[0]);
+    coop.solvers[0].getPolarities(current);
+    for (int v = 0; v < PLANTED_VARS; v++) CPPUNIT_ASSERT_EQUAL(published[v], current[v]);
+}
+
+void LocalSearchTest::testDeterministic() {
+    INIParser parser(std::string(""));
+    parser.setValueForConf("solver1", "solverType", "localsearch");
+    Cooperation coop(2, 10);
+    coop.deterministic_mode = 2;
+    SolverFixture::initialize(coop, parser);
+    CPPUNIT_ASSERT_EQUAL(0, coop.updateLocalSearch(false));
+    CPPUNIT_ASSERT(!coop.isLocalSearch(1));
+    CPPUNIT_ASSERT(!coop.replaceSolver(1));
+}
+
+void LocalSearchTest::testCDCLKept() {
+    INIParser parser(std::string(""));
+    parser.setValueForConf("default", "solverType", "localsearch");
+    Cooperation coop(3, 10);
+    SolverFixture::initialize(coop, parser);
+    CPPUNIT_ASSERT_EQUAL(2, coop.updateLocalSearch(true));
+    CPPUNIT_ASSERT(!coop.isLocalSearch(0));
+    CPPUNIT_ASSERT(coop.isLocalSearch(1));
+    CPPUNIT_ASSERT(coop.isLocalSearch(2));
+
+    // the last CDCL solver is not stopped to save memory
+    CPPUNIT_ASSERT(!coop.stopSolver(0));
+    CPPUNIT_ASSERT(coop.stopSolver(1));
+    CPPUNIT_ASSERT(!coop.isStopped(0));
+    CPPUNIT_ASSERT_EQUAL(2, coop.nbRunningSolvers());
+}
@@ -0,0 +1,65 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef LOCALSEARCHTEST_H
+#define	LOCALSEARCHTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LocalSearchTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(LocalSearchTest);
+    CPPUNIT_TEST(testSolve);
+    CPPUNIT_TEST(testPhaseExchange);
+    CPPUNIT_TEST(testDeterministic);
+    CPPUNIT_TEST(testCDCLKept);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check that the local search finds a model of a satisfiable random
+     * formula, and that this model is correct
+     */
+    void testSolve();
+
+    /**
+     * Check that the phases go from the local search to the CDCL solvers,
+     * and back on request
+     */
+    void testPhaseExchange();
+
+    /**
+     * Check that the local search is turned off in deterministic mode
+     */
+    void testDeterministic();
+
+    /**
+     * Check that a CDCL search always runs: thread 0 when every thread is
+     * configured to run a local search, and the last CDCL solver when the
+     * solvers are stopped to save memory
+     */
+    void testCDCLKept();
+
+};
+
+#endif	/* LOCALSEARCHTEST_H */
@@ -0,0 +1,71 @@
+#include "ParameterSpaceTest.h"
+#include "penelope/core/ParameterSpace.h"
+
+#include <set>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParameterSpaceTest);
+
+using namespace penelope;
+
+/**
+ * Fill a parser as if it read a small configuration file
+ */
+static void fill(INIParser& parser) {
+    parser.setValueForConf("default", "restartPolicy", "avgLBD");
+    parser.setValueForConf("default", "maxFreeze", "5");
+    parser.setValueForConf("default", "usePsm", "true");
+    parser.setValueForConf("solver0", "restartPolicy", "luby");
+    parser.setValueForConf("solver0", "usePsm", "false");
+    parser.setValueForConf("solver1", "maxFreeze", "4");
+}
+
+void ParameterSpaceTest::testMutate() {
+    INIParser parser(std::string(""));
+    fill(parser);
+    ParameterSpace space(parser);
+
+    uint64_t seed = 42;
+    std::string changes = space.mutate(parser, "solver0", "solver0-r1", 2, seed);
+    CPPUNIT_ASSERT(parser.configurationExist("solver0-r1"));
+    // the parameters that can't be changed are copied
+    CPPUNIT_ASSERT_EQUAL(std::string("false"), parser.getValueForConf("solver0-r1", "usePsm"));
+
+    // two parameters are described, and set in the new configuration
+    size_t separator = changes.find(' ');
+    CPPUNIT_ASSERT(separator != std::string::npos);
+    CPPUNIT_ASSERT(changes.find(' ', separator + 1) == std::string::npos);
+    std::string first(changes.substr(0, separator));
+    size_t equal = first.find('=');
+    CPPUNIT_ASSERT(equal != std::string::npos);
+    CPPUNIT_ASSERT_EQUAL(first.substr(equal + 1),
+            parser.getValueForConf("solver0-r1", first.substr(0, equal)));
+
+    // the same seed gives the same configuration
+    INIParser other(std::string(""));
+    fill(other);
+    uint64_t otherSeed = 42;
+    CPPUNIT_ASSERT_EQUAL(changes, ParameterSpace(other).mutate(other, "solver0", "solver0-r1", 2, otherSeed));
+    CPPUNIT_ASSERT_EQUAL(seed, otherSeed);
+}
+
+void ParameterSpaceTest::testGenerate() {
+    INIParser parser(std::string(""));
+    fill(parser);
+    ParameterSpace space(parser);
+
+    std::set<std::string> generated;
+    for (int i = 0; i < 64; i++) {
+        std::ostringstream name;
+        name << "solver" << i + 2;
+        std::string params = space.generate(parser, name.str(), i, 7);
+        CPPUNIT_ASSERT(parser.configurationExist(name.str()));
+        // the parameters set in [default] are not generated
+        CPPUNIT_ASSERT(params.find("restartPolicy") == std::string::npos);
+        CPPUNIT_ASSERT(parser.getValueForConf(name.str(), "maxFreeze").length() == 0);
+        CPPUNIT_ASSERT(parser.getValueForConf(name.str(), "maxLBD").length() > 0);
+        CPPUNIT_ASSERT(generated.insert(params).second);
+        CPPUNIT_ASSERT_EQUAL(params, space.generate(parser, "again", i, 7));
+    }
+    CPPUNIT_ASSERT(space.generate(parser, "other", 0, 7) != space.generate(parser, "other", 0, 8));
+}
@@ -0,0 +1,190 @@
+#include "PreprocessorTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/core/Dimacs.h"
+#include "penelope/core/ParameterSpace.h"
+#include "penelope/core/Preprocessor.h"
+#include "penelope/utils/Executor.h"
+
+#include <stdio.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PreprocessorTest);
+
+using namespace penelope;
+
+/** The number of variables of the small random formulas */
+#define MODEL_VARS 14
+/** The number of small random formulas */
+#define MODEL_FORMULAS 20
+/** The number of variables of the larger random formula */
+#define PARALLEL_VARS 300
+/** The number of clauses of the larger random formula */
+#define PARALLEL_CLAUSES 1000
+
+/**
+ * The clauses of a formula, filled like a solver
+ */
+struct Formula {
+    int vars;
+    /** The literals of the clauses, one clause after the other */
+    vec<Lit> lits;
+    /** The position of the first literal of each clause, plus the end */
+    vec<int> starts;
+
+    Formula() : vars(0), lits(), starts(1, 0) {
+    }
+
+    void initialiseMem(int, int) {
+    }
+
+    int nVars() const {
+        return vars;
+    }
+
+    Var newVar() {
+        return vars++;
+    }
+
+    bool addClause(const vec<Lit>& ps) {
+        for (int i = 0; i < ps.size(); i++) lits.push(ps[i]);
+        starts.push(lits.size());
+        return true;
+    }
+
+    /** @return true if every clause is satisfied by the model */
+    bool satisfiedBy(const vec<lbool>& model) const {
+        for (int c = 0; c + 1 < starts.size(); c++) {
+            bool satisfied = false;
+            for (int i = starts[c]; i < starts[c + 1] && !satisfied; i++)
+                satisfied = (model[var(lits[i])] ^ sign(lits[i])) == l_True;
+            if (!satisfied) return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * Give a random clause to a formula and to a preprocessor
+ * @param size the number of literals of the clause
+ */
+static void addRandomClause(Formula& formula, Preprocessor& pre, int size, uint64_t& seed) {
+    vec<Lit> lits;
+    while (lits.size() < size) {
+        Lit l = mkLit(ParameterSpace::random(seed) % formula.nVars(), ParameterSpace::random(seed) & 1);
+        bool known = false;
+        for (int i = 0; i < lits.size(); i++) known = known || var(lits[i]) == var(l);
+        if (!known) lits.push(l);
+    }
+    formula.addClause(lits);
+    pre.addClause(lits);
+}
+
+/**
+ * Solve a preprocessed formula with the solver of a cooperation of one
+ * thread
+ * @return true if it is satisfiable, the model of the solver being extended
+ *         to the eliminated variables
+ */
+static bool solve(Cooperation& coop, const Preprocessor& pre) {
+    Solver& s = SolverFixture::initialize(coop);
+    pre.load(s);
+    if (!s.solve(&coop)) return false;
+    pre.extendModel(s.model);
+    return true;
+}
+
+void PreprocessorTest::testModels() {
+    uint64_t seed = 11;
+    for (int f = 0; f < MODEL_FORMULAS; f++) {
+        Formula formula;
+        Preprocessor pre;
+        while (formula.nVars() < MODEL_VARS) {
+            formula.newVar();
+            pre.newVar();
+        }
+        int nbClauses = 30 + f * 2;
+        for (int c = 0; c < nbClauses; c++)
+            addRandomClause(formula, pre, 2 + ParameterSpace::random(seed) % 3, seed);
+
+        bool expected = false;
+        vec<lbool> model(MODEL_VARS);
+        for (unsigned int m = 0; m < (1u << MODEL_VARS) && !expected; m++) {
+            for (Var v = 0; v < MODEL_VARS; v++) model[v] = lbool((bool)((m >> v) & 1));
+            expected = formula.satisfiedBy(model);
+        }
+
+        pre.preprocess();
+        Cooperation coop(1, 10);
+        bool sat = solve(coop, pre);
+        CPPUNIT_ASSERT_EQUAL(expected, sat);
+        if (sat) CPPUNIT_ASSERT(formula.satisfiedBy(coop.solvers[0].model));
+    }
+}
+
+void PreprocessorTest::testParallel() {
+    int clauses[2], subsumed[2], strengthened[2], eliminated[2];
+    for (int run = 0; run < 2; run++) {
+        uint64_t seed = 3;
+        Formula formula;
+        Preprocessor pre;
+        pre.parallelClauses = 0;
+        while (formula.nVars() < PARALLEL_VARS) {
+            formula.newVar();
+            pre.newVar();
+        }
+        for (int c = 0; c < PARALLEL_CLAUSES; c++) {
+            addRandomClause(formula, pre, 3, seed);
+            // a clause subsumed by the previous one, or strengthened by it
+            if (c % 4 != 0) continue;
+            vec<Lit> lits;
+            for (int i = formula.starts[c]; i < formula.starts[c + 1]; i++) lits.push(formula.lits[i]);
+            if (c % 8 == 0) lits[0] = ~lits[0];
+            Var v = ParameterSpace::random(seed) % PARALLEL_VARS;
+            bool known = false;
+            for (int i = 0; i < lits.size(); i++) known = known || var(lits[i]) == v;
+            if (!known) lits.push(mkLit(v));
+            formula.addClause(lits);
+            pre.addClause(lits);
+            c++;
+        }
+
+        ThreadPoolExecutor executor(2 + run);
+        pre.preprocess(&executor);
+        clauses[run] = pre.nClauses();
+        subsumed[run] = pre.nbSubsumed();
+        strengthened[run] = pre.nbStrengthened();
+        eliminated[run] = pre.nbEliminated();
+        CPPUNIT_ASSERT(pre.nbSubsumed() > 0);
+        CPPUNIT_ASSERT(pre.nbStrengthened() > 0);
+
+        Cooperation coop(1, 10);
+        CPPUNIT_ASSERT(solve(coop, pre));
+        CPPUNIT_ASSERT(formula.satisfiedBy(coop.solvers[0].model));
+    }
+    CPPUNIT_ASSERT_EQUAL(clauses[0], clauses[1]);
+    CPPUNIT_ASSERT_EQUAL(subsumed[0], subsumed[1]);
+    CPPUNIT_ASSERT_EQUAL(strengthened[0], strengthened[1]);
+    CPPUNIT_ASSERT_EQUAL(eliminated[0], eliminated[1]);
+}
+
+void PreprocessorTest::testInstances() {
+    const char* files[] = {"instances/dp04u03.shuffled.cnf", "instances/dp10s10.shuffled.cnf"};
+    for (int f = 0; f < 2; f++) {
+        Formula formula;
+        Preprocessor pre;
+        FILE* in = fopen(files[f], "rb");
+        CPPUNIT_ASSERT(in != NULL);
+        DimacsParser::parse_DIMACS(in, formula);
+        rewind(in);
+        DimacsParser::parse_DIMACS(in, pre);
+        fclose(in);
+        CPPUNIT_ASSERT_EQUAL(formula.nVars(), pre.nVars());
+
+        pre.preprocess();
+        CPPUNIT_ASSERT(pre.nbEliminated() > 0);
+        Cooperation coop(1, 10);
+        bool sat = solve(coop, pre);
+        CPPUNIT_ASSERT_EQUAL(f == 1, sat);
+        if (sat) CPPUNIT_ASSERT(formula.satisfiedBy(coop.solvers[0].model));
+    }
+}
@@ -0,0 +1,59 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef PREPROCESSORTEST_H
+#define	PREPROCESSORTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class PreprocessorTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(PreprocessorTest);
+    CPPUNIT_TEST(testModels);
+    CPPUNIT_TEST(testParallel);
+    CPPUNIT_TEST(testInstances);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check on small random formulas that the simplified formula is
+     * satisfiable if and only if the original one is, and that its models
+     * extended to the eliminated variables satisfy the original formula
+     */
+    void testModels();
+
+    /**
+     * Check that the first subsumption pass gives the same formula
+     * whatever the number of workers sharing it
+     */
+    void testParallel();
+
+    /**
+     * Check the answers on the simplified unsatisfiable and satisfiable
+     * instances
+     */
+    void testInstances();
+
+};
+
+#endif	/* PREPROCESSORTEST_H */
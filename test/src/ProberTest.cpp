@@ -0,0 +1,102 @@
+#include "ProberTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/core/Prober.h"
+#include "penelope/utils/Executor.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ProberTest);
+
+using namespace penelope;
+
+/** The number of threads probing the formulas */
+#define PROBE_THREADS 2
+/** The number of variables of the formulas */
+#define PROBE_VARS 6
+
+/**
+ * Initialize the solvers of a cooperation and give them a formula
+ * @param clauses the literals of the clauses, each clause ending with
+ *        lit_Undef
+ */
+static void load(Cooperation& coop, const vec<Lit>& clauses) {
+    SolverFixture::initialize(coop);
+    for (int t = 0; t < coop.nThreads(); t++) {
+        Solver& s = coop.solvers[t];
+        while (s.nVars() < PROBE_VARS) s.newVar();
+        vec<Lit> lits;
+        for (int i = 0; i < clauses.size(); i++) {
+            if (clauses[i] != lit_Undef) {
+                lits.push(clauses[i]);
+                continue;
+            }
+            s.addClause(lits);
+            lits.clear();
+        }
+    }
+}
+
+/**
+ * Add a clause to a formula
+ */
+static void add(vec<Lit>& clauses, Lit a, Lit b, Lit c = lit_Undef) {
+    clauses.push(a);
+    clauses.push(b);
+    if (c != lit_Undef) clauses.push(c);
+    clauses.push(lit_Undef);
+}
+
+void ProberTest::testSimplify() {
+    vec<Lit> clauses;
+    Lit x[PROBE_VARS];
+    for (int v = 0; v < PROBE_VARS; v++) x[v] = mkLit(v);
+    // x0 = ~x1 = ~x2
+    add(clauses, x[0], x[1]);
+    add(clauses, ~x[0], ~x[1]);
+    add(clauses, ~x[1], x[2]);
+    add(clauses, x[1], ~x[2]);
+    // x3 fails
+    add(clauses, ~x[3], x[4]);
+    add(clauses, ~x[3], ~x[4]);
+    add(clauses, x[0], x[5], x[4]);
+    add(clauses, ~x[2], ~x[5], x[3]);
+
+    Cooperation coop(PROBE_THREADS, 10);
+    load(coop, clauses);
+    ThreadPoolExecutor executor(PROBE_THREADS);
+    Prober prober(coop);
+    CPPUNIT_ASSERT(prober.probe(executor));
+    CPPUNIT_ASSERT(prober.nbFailed() >= 1);
+    CPPUNIT_ASSERT_EQUAL(2, prober.nbEquivalent());
+
+    for (int t = 0; t < PROBE_THREADS; t++) {
+        Solver& s = coop.solvers[t];
+        CPPUNIT_ASSERT(s.value(x[3]) == l_False);
+        CPPUNIT_ASSERT(s.solve(&coop));
+        prober.extendModel(s.model);
+        bool satisfied = false;
+        for (int i = 0; i < clauses.size(); i++) {
+            if (clauses[i] == lit_Undef) {
+                CPPUNIT_ASSERT(satisfied);
+                satisfied = false;
+                continue;
+            }
+            satisfied = satisfied || (s.model[var(clauses[i])] ^ sign(clauses[i])) == l_True;
+        }
+    }
+}
+
+void ProberTest::testUnsatisfiable() {
+    vec<Lit> clauses;
+    Lit x0 = mkLit(0), x1 = mkLit(1);
+    add(clauses, x0, x1);
+    add(clauses, ~x0, ~x1);
+    add(clauses, ~x0, x1);
+    add(clauses, x0, ~x1);
+
+    Cooperation coop(PROBE_THREADS, 10);
+    load(coop, clauses);
+    ThreadPoolExecutor executor(PROBE_THREADS);
+    Prober prober(coop);
+    CPPUNIT_ASSERT(!prober.probe(executor));
+    for (int t = 0; t < PROBE_THREADS; t++) CPPUNIT_ASSERT(!coop.solvers[t].okay());
+}
@@ -0,0 +1,36 @@
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace penelope;
+
+Solver& SolverFixture::initialize(Cooperation& coop) {
+    INIParser parser(std::string(""));
+    return initialize(coop, parser);
+}
+
+Solver& SolverFixture::initialize(Cooperation& coop, INIParser& parser) {
+    coop.ctrl = 0;
+    for (int t = 0; t < coop.nThreads(); t++) {
+        coop.solvers[t].initialize(&coop, t, parser);
+        coop.solvers[t].threadId = t;
+        coop.solvers[t].verbosity = 0;
+    }
+    return coop.solvers[0];
+}
+
+void SolverFixture::pigeonHole(Solver& s, int pigeons) {
+    int holes = pigeons - 1;
+    while (s.nVars() < pigeons * holes) s.newVar();
+    vec<Lit> lits;
+    for (int p = 0; p < pigeons; p++) {
+        lits.clear();
+        for (int h = 0; h < holes; h++) lits.push(mkLit(p * holes + h));
+        CPPUNIT_ASSERT(s.addClause(lits));
+    }
+    for (int h = 0; h < holes; h++)
+        for (int p = 0; p < pigeons; p++)
+            for (int q = p + 1; q < pigeons; q++)
+                CPPUNIT_ASSERT(s.addClause(~mkLit(p * holes + h), ~mkLit(q * holes + h)));
+}
@@ -0,0 +1,65 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef SOLVERFIXTURE_H
+#define	SOLVERFIXTURE_H
+
+namespace penelope {
+    class Cooperation;
+    class INIParser;
+    class Solver;
+}
+
+/**
+ * The initialization of the solvers shared by the test suites that build
+ * their formulas by hand
+ */
+class SolverFixture {
+public:
+
+    /**
+     * Initialize the solvers of a cooperation with the default values of
+     * their parameters. They are silent and the exchanges are not
+     * controlled.
+     * @param coop the cooperation holding the solvers
+     * @return the solver of the first thread
+     */
+    static penelope::Solver& initialize(penelope::Cooperation& coop);
+
+    /**
+     * Same as above, the solvers being configured by a parser
+     */
+    static penelope::Solver& initialize(penelope::Cooperation& coop, penelope::INIParser& parser);
+
+    /**
+     * Give a solver the pigeon hole formula: unsatisfiable, but only after
+     * many conflicts. The variable of the pigeon p in the hole h is
+     * p * (pigeons - 1) + h.
+     * @param s the solver, without any variable
+     * @param pigeons the number of pigeons, one more than the holes
+     */
+    static void pigeonHole(penelope::Solver& s, int pigeons);
+
+};
+
+#endif	/* SOLVERFIXTURE_H */
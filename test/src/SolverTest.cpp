@@ -0,0 +1,179 @@
+#include "SolverTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SolverTest);
+
+using namespace penelope;
+
+/** The number of variables of the rephased solver */
+#define REPHASE_VARS 16
+
+/**
+ * Check that the polarities of a solver are the expected ones on its
+ * unassigned variables, and that the deviation is measured from them
+ */
+static void checkPolarities(Solver& s, const vec<char>& expected) {
+    vec<char> current, saved;
+    s.getPolarities(current);
+    s.getSavedPolarities(saved);
+    for (Var v = 0; v < s.nVars(); v++) {
+        if (s.value(v) == l_Undef) CPPUNIT_ASSERT_EQUAL(expected[v], current[v]);
+        CPPUNIT_ASSERT_EQUAL(current[v], saved[v]);
+    }
+    CPPUNIT_ASSERT_EQUAL(0, s.getHammingDistance());
+}
+
+void SolverTest::testRephase() {
+    INIParser parser(std::string(""));
+    parser.setValueForConf("default", "rephaseCycle", "bior");
+    parser.setValueForConf("default", "initPhasePolicy", "random");
+    Cooperation coop(2, 10);
+    Solver& s = SolverFixture::initialize(coop, parser);
+    while (s.nVars() < REPHASE_VARS) s.newVar();
+    // the polarity of an assigned variable is left alone
+    CPPUNIT_ASSERT(s.addClause(mkLit(0)));
+    vec<char> original, current;
+    s.getPolarities(original);
+    CPPUNIT_ASSERT(s.getHammingDistance() != 0);
+
+    // nothing was published yet
+    vec<char> phases;
+    CPPUNIT_ASSERT(!coop.fetchBestTrail(phases));
+    coop.publishBestTrail(&coop.solvers[1]);
+    CPPUNIT_ASSERT(!coop.fetchBestTrail(phases));
+
+    // b: the longest trail of the portfolio
+    vec<char> best, inverse;
+    for (Var v = 0; v < REPHASE_VARS; v++) {
+        best.push(v % 3 == 0);
+        inverse.push(v % 3 != 0);
+    }
+    best.copyTo(coop.bestTrailPhases);
+    coop.bestTrailSize = REPHASE_VARS;
+    s.rephase(&coop);
+    checkPolarities(s, best);
+    s.getPolarities(current);
+    CPPUNIT_ASSERT_EQUAL(original[0], current[0]);
+
+    // i: its inverse
+    s.rephase(&coop);
+    checkPolarities(s, inverse);
+
+    // o: the polarities given at the creation of the variables
+    s.rephase(&coop);
+    checkPolarities(s, original);
+
+    // r: random ones
+    s.rephase(&coop);
+    s.getPolarities(current);
+    checkPolarities(s, current);
+    bool changed = false;
+    for (Var v = 1; v < REPHASE_VARS; v++) changed = changed || current[v] != original[v];
+    CPPUNIT_ASSERT(changed);
+    CPPUNIT_ASSERT_EQUAL(4, s.nbRephases);
+
+    // and the cycle starts again
+    s.rephase(&coop);
+    checkPolarities(s, best);
+}
+
+void SolverTest::testBestTrail() {
+    INIParser parser(std::string(""));
+    parser.setValueForConf("default", "rephaseInterval", "1");
+    Cooperation coop(2, 10);
+    Solver& s = SolverFixture::initialize(coop, parser);
+    SolverFixture::pigeonHole(s, 7);
+
+    CPPUNIT_ASSERT(!s.solve(&coop));
+    CPPUNIT_ASSERT(s.nbRephases > 0);
+    vec<char> phases;
+    CPPUNIT_ASSERT(coop.fetchBestTrail(phases));
+    CPPUNIT_ASSERT_EQUAL(s.nVars(), phases.size());
+}
+
+void SolverTest::testStrengthenImport() {
+    Cooperation coop(2, 10);
+    Solver& s = SolverFixture::initialize(coop);
+    Lit x[9];
+    for (int v = 0; v < 9; v++) x[v] = mkLit(s.newVar());
+    // x0 -> x1 -> x2, x4 -> x6 -> ~x4, x5
+    CPPUNIT_ASSERT(s.addClause(~x[0], x[1]));
+    CPPUNIT_ASSERT(s.addClause(~x[1], x[2]));
+    CPPUNIT_ASSERT(s.addClause(~x[4], x[6]));
+    CPPUNIT_ASSERT(s.addClause(~x[6], ~x[4]));
+    CPPUNIT_ASSERT(s.addClause(x[5]));
+
+    vec<Lit> lits;
+    lits.push(x[0]), lits.push(x[2]), lits.push(x[4]), lits.push(x[7]), lits.push(x[8]);
+    CPPUNIT_ASSERT(s.strengthenImport(lits));
+    CPPUNIT_ASSERT_EQUAL(3, lits.size());
+    CPPUNIT_ASSERT(lits[0] == x[2]);
+    CPPUNIT_ASSERT(lits[1] == x[7]);
+    CPPUNIT_ASSERT(lits[2] == x[8]);
+    CPPUNIT_ASSERT_EQUAL(1, s.nbImportsStrengthened);
+    CPPUNIT_ASSERT_EQUAL(2, s.nbImportLitsRemoved);
+
+    // through the cooperation: a clause strengthened, a satisfied one
+    s.strengthenImports = true;
+    Lit strengthened[] = {mkLit(3), x[0], x[7], x[1]};
+    coop.addExtraClause(&s, 1, strengthened, 3, NULL);
+    CPPUNIT_ASSERT_EQUAL(1, s.nLearnts());
+    CPPUNIT_ASSERT_EQUAL(2, s.nbImportsStrengthened);
+    Lit satisfied[] = {mkLit(2), x[7], x[5]};
+    coop.addExtraClause(&s, 1, satisfied, 2, NULL);
+    CPPUNIT_ASSERT_EQUAL(1, s.nLearnts());
+    CPPUNIT_ASSERT(s.solve(&coop));
+}
+
+/**
+ * Learn a clause from the single conflict of x3 under the assumptions x1
+ * and x2: x3 implies y and z, which conflict with x1 and x2. The learnt
+ * clause (~x3 ~x1 ~x2) is the reason of ~x3 in the final conflict.
+ * @param binary true to add the binary clause (~x3 x1), which makes ~x1
+ *        removable from the learnt clause
+ * @param snap where the counters of the solver are stored
+ * @param conflict where the final conflict, on the negations of the
+ *        assumptions, is stored
+ */
+static void learn(bool binary, SolverSnapshot& snap, vec<Lit>& conflict) {
+    Cooperation coop(1, 10);
+    Solver& s = SolverFixture::initialize(coop);
+    Lit x1 = mkLit(s.newVar()), x2 = mkLit(s.newVar()), x3 = mkLit(s.newVar());
+    Lit y = mkLit(s.newVar()), z = mkLit(s.newVar());
+    CPPUNIT_ASSERT(s.addClause(~x3, y));
+    CPPUNIT_ASSERT(s.addClause(~x3, z));
+    vec<Lit> lits;
+    lits.push(~y), lits.push(~z), lits.push(~x1), lits.push(~x2);
+    CPPUNIT_ASSERT(s.addClause(lits));
+    if (binary) CPPUNIT_ASSERT(s.addClause(~x3, x1));
+
+    vec<Lit> assumptions;
+    assumptions.push(x1), assumptions.push(x2), assumptions.push(x3);
+    CPPUNIT_ASSERT(s.solveLimited(assumptions, &coop) == l_False);
+    s.snapshot(snap);
+    s.conflict.copyTo(conflict);
+    CPPUNIT_ASSERT_EQUAL((uint64_t) 1, snap.conflicts);
+    CPPUNIT_ASSERT_EQUAL(1, s.nLearnts());
+}
+
+void SolverTest::testBinaryMinimize() {
+    SolverSnapshot snap;
+    vec<Lit> conflict;
+    Lit x1 = mkLit(0), x2 = mkLit(1), x3 = mkLit(2);
+
+    // without the binary clause, the three levels stay in the clause
+    learn(false, snap, conflict);
+    CPPUNIT_ASSERT_EQUAL(3, conflict.size());
+    CPPUNIT_ASSERT_EQUAL(3.0, snap.lbdAverage);
+
+    // with it, ~x1 is removed and the lbd is computed again
+    conflict.clear();
+    learn(true, snap, conflict);
+    CPPUNIT_ASSERT_EQUAL(2, conflict.size());
+    for (int i = 0; i < conflict.size(); i++) {
+        CPPUNIT_ASSERT(conflict[i] != ~x1);
+        CPPUNIT_ASSERT(conflict[i] == ~x2 || conflict[i] == ~x3);
+    }
+    CPPUNIT_ASSERT_EQUAL(2.0, snap.lbdAverage);
+}
@@ -0,0 +1,68 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef SOLVERTEST_H
+#define	SOLVERTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SolverTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(SolverTest);
+    CPPUNIT_TEST(testRephase);
+    CPPUNIT_TEST(testBestTrail);
+    CPPUNIT_TEST(testStrengthenImport);
+    CPPUNIT_TEST(testBinaryMinimize);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check the polarities given by each kind of rephasing to the
+     * unassigned variables, and that they become the reference of the
+     * deviation measured by the progress saving based reduction
+     */
+    void testRephase();
+
+    /**
+     * Check that the rephasing solvers share the polarities of their
+     * longest trail
+     */
+    void testBestTrail();
+
+    /**
+     * Check that the imported clauses lose the literals implying another
+     * one through the binary clauses, and that the ones satisfied at level 0
+     * are dropped
+     */
+    void testStrengthenImport();
+
+    /**
+     * Check that a learnt clause loses the literals whose negation is
+     * implied by its asserting literal through a binary clause, and that
+     * its lbd is computed without them
+     */
+    void testBinaryMinimize();
+
+};
+
+#endif	/* SOLVERTEST_H */
@@ -0,0 +1,76 @@
+#include "SupervisorTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/core/Supervisor.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SupervisorTest);
+
+using namespace penelope;
+
+/** The number of pigeons of the formula, one more than its holes */
+#define REPLACE_PIGEONS 6
+
+/**
+ * @return the variable of a pigeon in a hole
+ */
+static Var pigeon(int p, int h) {
+    return p * (REPLACE_PIGEONS - 1) + h;
+}
+
+/**
+ * @return the number of learnt clauses of a solver whose lbd is at most
+ *         SUPERVISOR_KEPT_LBD
+ */
+static int nbSmallLBD(Solver& s) {
+    int nb = 0;
+    for (int i = 0; i < s.nLearnts(); i++)
+        if ((int) s.getClause(s.getLearntClause(i)).lbd() <= SUPERVISOR_KEPT_LBD) nb++;
+    return nb;
+}
+
+void SupervisorTest::testReplace() {
+    Cooperation coop(1, 10);
+    INIParser parser(std::string(""));
+    parser.setValueForConf("default", "restartPolicy", "avgLBD");
+    Solver& s = SolverFixture::initialize(coop, parser);
+
+    // unsatisfiable, but not before many conflicts
+    SolverFixture::pigeonHole(s, REPLACE_PIGEONS);
+    vec<Lit> lits;
+    Lit unit = mkLit(s.newVar());
+    CPPUNIT_ASSERT(s.addClause(unit));
+
+    // learnt clauses of every lbd: the first three pigeons share no hole
+    int lbds[] = {2, 3, 5, 9};
+    for (int h = 0; h < 4; h++) {
+        lits.clear();
+        for (int p = 0; p < 3; p++) lits.push(~mkLit(pigeon(p, h)));
+        CPPUNIT_ASSERT(s.addExtraClause(lits, lbds[h]) != CRef_Undef);
+    }
+
+    // the search stops at its first conflict once the solver is replaced
+    Supervisor supervisor(&coop, parser, 1000, SUPERVISOR_SEED);
+    CPPUNIT_ASSERT(!supervisor.replace(0));
+    CPPUNIT_ASSERT(coop.replaceSolver(0));
+    vec<Lit> dummy;
+    CPPUNIT_ASSERT(s.solveLimited(dummy, &coop) == l_Undef);
+    CPPUNIT_ASSERT(coop.isReplaced(0));
+    uint64_t conflicts = s.conflicts;
+    CPPUNIT_ASSERT(conflicts > 0);
+    int kept = nbSmallLBD(s);
+    CPPUNIT_ASSERT(kept >= 2);
+    CPPUNIT_ASSERT(s.nLearnts() >= kept + 2);
+
+    CPPUNIT_ASSERT(supervisor.replace(0));
+    CPPUNIT_ASSERT(!coop.isReplaced(0));
+    CPPUNIT_ASSERT_EQUAL(1, supervisor.nbReplacements());
+    CPPUNIT_ASSERT_EQUAL(std::string("solver0-r1"), s.getConfiguration());
+    CPPUNIT_ASSERT_EQUAL(kept, s.nLearnts());
+    CPPUNIT_ASSERT_EQUAL(kept, nbSmallLBD(s));
+    CPPUNIT_ASSERT(s.value(unit) == l_True);
+    CPPUNIT_ASSERT_EQUAL(0, s.level(var(unit)));
+
+    // the new configuration searches up to the answer
+    CPPUNIT_ASSERT(s.solveLimited(dummy, &coop) == l_False);
+    CPPUNIT_ASSERT(s.conflicts > conflicts);
+}
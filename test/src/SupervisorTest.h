@@ -0,0 +1,45 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef SUPERVISORTEST_H
+#define	SUPERVISORTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SupervisorTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(SupervisorTest);
+    CPPUNIT_TEST(testReplace);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check that a solver asked to stop its search restarts with a new
+     * configuration, keeping its units and its learnt clauses of small lbd
+     * only, then resumes its search up to the answer
+     */
+    void testReplace();
+
+};
+
+#endif	/* SUPERVISORTEST_H */
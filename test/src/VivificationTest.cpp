@@ -0,0 +1,70 @@
+#include "VivificationTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VivificationTest);
+
+using namespace penelope;
+
+/** The number of threads of the cooperation */
+#define VIVIFY_THREADS 2
+/** The number of variables of the formula */
+#define VIVIFY_VARS 22
+/** The size of the learnt clause exported once vivified */
+#define VIVIFY_LONG 12
+
+void VivificationTest::testShorten() {
+    Cooperation coop(VIVIFY_THREADS, 10);
+    SolverFixture::initialize(coop);
+    Solver& s = coop.solvers[0];
+    while (s.nVars() < VIVIFY_VARS) s.newVar();
+    Lit y[VIVIFY_LONG], z[5], u[3];
+    for (int i = 0; i < VIVIFY_LONG; i++) y[i] = mkLit(i);
+    for (int i = 0; i < 5; i++) z[i] = mkLit(VIVIFY_LONG + i);
+    for (int i = 0; i < 3; i++) u[i] = mkLit(VIVIFY_LONG + 5 + i);
+    Lit w = mkLit(VIVIFY_VARS - 2), v = mkLit(VIVIFY_VARS - 1);
+
+    CPPUNIT_ASSERT(s.addClause(~y[0], ~y[1], ~y[2]));
+    CPPUNIT_ASSERT(s.addClause(z[0], z[1], w));
+    CPPUNIT_ASSERT(s.addClause(z[0], z[1], ~w));
+    CPPUNIT_ASSERT(s.addClause(~z[4]));
+    CPPUNIT_ASSERT(s.addClause(u[0], v));
+    CPPUNIT_ASSERT(s.addClause(u[0], ~v));
+
+    // the learnt clauses are attached whatever their lbd: none of their
+    // literals agrees with the polarities
+    vec<char> phases(VIVIFY_VARS, 0);
+    s.setPolarities(phases);
+    vec<Lit> lits;
+    // implied by the first clause, the third literal being implied true
+    for (int i = 0; i < VIVIFY_LONG; i++) lits.push(~y[i]);
+    CPPUNIT_ASSERT(s.addExtraClause(lits, 10) != CRef_Undef);
+    // implied by (z0 z1), z4 being false
+    lits.clear();
+    lits.push(z[0]), lits.push(z[4]), lits.push(z[1]), lits.push(z[2]), lits.push(z[3]);
+    CPPUNIT_ASSERT(s.addExtraClause(lits, 2) != CRef_Undef);
+    // implied by the unit u0
+    lits.clear();
+    lits.push(u[0]), lits.push(u[1]), lits.push(u[2]);
+    CPPUNIT_ASSERT(s.addExtraClause(lits, 3) != CRef_Undef);
+    CPPUNIT_ASSERT_EQUAL(3, s.nLearnts());
+
+    s.vivifyBudget = 1000;
+    MemoryBreakdown before, after;
+    s.memoryBreakdown(before);
+    CPPUNIT_ASSERT(s.vivify(&coop));
+    CPPUNIT_ASSERT_EQUAL(3, s.nbVivified);
+    CPPUNIT_ASSERT_EQUAL(VIVIFY_LONG - 3 + 3 + 2, s.nbVivifiedLits);
+    // the memory of the removed literals is wasted
+    s.memoryBreakdown(after);
+    CPPUNIT_ASSERT(after.arenaWasted - before.arenaWasted >= s.nbVivifiedLits * sizeof(Lit));
+    CPPUNIT_ASSERT_EQUAL(1, s.nbVivifiedExported);
+    CPPUNIT_ASSERT_EQUAL(2, s.nLearnts());
+    CPPUNIT_ASSERT(s.value(u[0]) == l_True);
+
+    // a second vivification leaves the clauses alone
+    CPPUNIT_ASSERT(s.vivify(&coop));
+    CPPUNIT_ASSERT_EQUAL(3, s.nbVivified);
+
+    CPPUNIT_ASSERT(s.solve(&coop));
+}
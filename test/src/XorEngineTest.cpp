@@ -0,0 +1,150 @@
+#include "XorEngineTest.h"
+#include "SolverFixture.h"
+#include "penelope/core/Cooperation.h"
+#include "penelope/core/ParameterSpace.h"
+#include "penelope/core/XorEngine.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(XorEngineTest);
+
+using namespace penelope;
+
+/** The number of variables of the random systems */
+#define MODEL_VARS 80
+/** The number of constraints of the random systems */
+#define MODEL_XORS 60
+/** The number of clauses mixed with the constraints */
+#define MODEL_CLAUSES 120
+/** The number of random systems */
+#define MODEL_SYSTEMS 10
+
+/**
+ * Add the clauses encoding a XOR constraint: one clause for each
+ * assignment of the wrong parity
+ * @param clauses if not NULL, where the clauses are copied, one after the
+ *        other, each one followed by lit_Undef
+ */
+static void addXor(Solver& s, const vec<Var>& vars, bool parity, vec<Lit>* clauses = NULL) {
+    vec<Lit> lits;
+    for (int m = 0; m < (1 << vars.size()); m++) {
+        bool odd = false;
+        lits.clear();
+        for (int i = 0; i < vars.size(); i++) {
+            odd ^= (m >> i) & 1;
+            lits.push(mkLit(vars[i], (m >> i) & 1));
+        }
+        if (odd == parity) continue;
+        CPPUNIT_ASSERT(s.addClause(lits));
+        if (clauses == NULL) continue;
+        for (int i = 0; i < lits.size(); i++) clauses->push(lits[i]);
+        clauses->push(lit_Undef);
+    }
+}
+
+/** @return the parity of the variables under a model */
+static bool parityOf(const vec<lbool>& model, const vec<Var>& vars) {
+    bool parity = false;
+    for (int i = 0; i < vars.size(); i++) parity ^= model[vars[i]] == l_True;
+    return parity;
+}
+
+void XorEngineTest::testRecover() {
+    Cooperation coop(1, 10);
+    Solver& s = SolverFixture::initialize(coop);
+    s.useXor = true;
+    while (s.nVars() < 9) s.newVar();
+    vec<Var> first, second;
+    first.push(0), first.push(1), first.push(2);
+    second.push(5), second.push(3), second.push(4), second.push(2);
+    addXor(s, first, true);
+    addXor(s, second, false);
+    // three of the four clauses of x6 ^ x7 ^ x8 = 1
+    CPPUNIT_ASSERT(s.addClause(mkLit(6), mkLit(7), mkLit(8)));
+    CPPUNIT_ASSERT(s.addClause(mkLit(6), ~mkLit(7), ~mkLit(8)));
+    CPPUNIT_ASSERT(s.addClause(~mkLit(6), mkLit(7), ~mkLit(8)));
+
+    CPPUNIT_ASSERT(s.solve(&coop));
+    CPPUNIT_ASSERT(s.getXorEngine() != NULL);
+    CPPUNIT_ASSERT_EQUAL(2, s.getXorEngine()->nbXors());
+    CPPUNIT_ASSERT(s.getXorEngine()->hasGauss());
+    CPPUNIT_ASSERT(parityOf(s.model, first));
+    CPPUNIT_ASSERT(!parityOf(s.model, second));
+}
+
+void XorEngineTest::testElimination() {
+    Cooperation coop(1, 10);
+    Solver& s = SolverFixture::initialize(coop);
+    s.useXor = true;
+    while (s.nVars() < 5) s.newVar();
+    // the sum of the first two constraints contradicts the third one
+    vec<Var> vars;
+    vars.push(0), vars.push(1), vars.push(2);
+    addXor(s, vars, true);
+    vars.clear();
+    vars.push(2), vars.push(3), vars.push(4);
+    addXor(s, vars, false);
+    vars.clear();
+    vars.push(0), vars.push(1), vars.push(3), vars.push(4);
+    addXor(s, vars, false);
+
+    CPPUNIT_ASSERT(!s.solve(&coop));
+    CPPUNIT_ASSERT_EQUAL(1, (int) s.getXorEngine()->nbConflicts());
+    CPPUNIT_ASSERT_EQUAL(0, (int) s.conflicts);
+}
+
+void XorEngineTest::testModels() {
+    uint64_t seed = 7;
+    uint64_t implied = 0;
+    for (int f = 0; f < MODEL_SYSTEMS; f++) {
+        Cooperation coop(1, 10);
+        Solver& s = SolverFixture::initialize(coop);
+    s.useXor = true;
+        while (s.nVars() < MODEL_VARS) s.newVar();
+        vec<lbool> planted(MODEL_VARS);
+        for (Var v = 0; v < MODEL_VARS; v++) planted[v] = lbool((bool)(ParameterSpace::random(seed) & 1));
+
+        // a system satisfied by the planted model, and clauses as well
+        vec<Lit> clauses;
+        vec<Var> vars;
+        for (int x = 0; x < MODEL_XORS; x++) {
+            vars.clear();
+            int size = 3 + ParameterSpace::random(seed) % 3;
+            while (vars.size() < size) {
+                Var v = ParameterSpace::random(seed) % MODEL_VARS;
+                bool known = false;
+                for (int i = 0; i < vars.size(); i++) known = known || vars[i] == v;
+                if (!known) vars.push(v);
+            }
+            addXor(s, vars, parityOf(planted, vars), &clauses);
+        }
+        vec<Lit> lits;
+        for (int c = 0; c < MODEL_CLAUSES; c++) {
+            lits.clear();
+            bool satisfied = false;
+            while (lits.size() < 3 || !satisfied) {
+                Lit l = mkLit(ParameterSpace::random(seed) % MODEL_VARS, ParameterSpace::random(seed) & 1);
+                if (lits.size() == 3) lits.pop();
+                lits.push(l);
+                satisfied = false;
+                for (int i = 0; i < lits.size(); i++)
+                    satisfied = satisfied || (planted[var(lits[i])] ^ sign(lits[i])) == l_True;
+            }
+            CPPUNIT_ASSERT(s.addClause(lits));
+            for (int i = 0; i < lits.size(); i++) clauses.push(lits[i]);
+            clauses.push(lit_Undef);
+        }
+
+        CPPUNIT_ASSERT(s.solve(&coop));
+        CPPUNIT_ASSERT_EQUAL(MODEL_XORS, s.getXorEngine()->nbXors());
+        implied += s.getXorEngine()->nbEliminated();
+        bool satisfied = false;
+        for (int i = 0; i < clauses.size(); i++) {
+            if (clauses[i] == lit_Undef) {
+                CPPUNIT_ASSERT(satisfied);
+                satisfied = false;
+            } else {
+                satisfied = satisfied || (s.model[var(clauses[i])] ^ sign(clauses[i])) == l_True;
+            }
+        }
+    }
+    CPPUNIT_ASSERT(implied > 0);
+}
@@ -0,0 +1,59 @@
+/*
+Copyright (c) <2013> <B.Hoessen>
+
+This software is provided 'as-is', without any express or implied
+warranty. In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+   1. The origin of this software must not be misrepresented; you must not
+   claim that you wrote the original software. If you use this software
+   in a product, an acknowledgment in the product documentation would be
+   appreciated but is not required.
+
+   2. Altered source versions must be plainly marked as such, and must not be
+   misrepresented as being the original software.
+
+   3. This notice may not be removed or altered from any source
+   distribution.
+ */
+
+#ifndef XORENGINETEST_H
+#define	XORENGINETEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class XorEngineTest : public CppUnit::TestFixture {
+public:
+
+    CPPUNIT_TEST_SUITE(XorEngineTest);
+    CPPUNIT_TEST(testRecover);
+    CPPUNIT_TEST(testElimination);
+    CPPUNIT_TEST(testModels);
+    CPPUNIT_TEST_SUITE_END();
+
+    /**
+     * Check that only the complete encodings of a XOR constraint are
+     * recovered, and that the models respect them
+     */
+    void testRecover();
+
+    /**
+     * Check that the elimination finds the inconsistency of a system whose
+     * constraints are each satisfiable, without any search
+     */
+    void testElimination();
+
+    /**
+     * Check the models found on random systems mixed with clauses, where
+     * the reasons of the literals implied by the constraints are needed by
+     * the conflict analysis
+     */
+    void testModels();
+
+};
+
+#endif	/* XORENGINETEST_H */